@@ -26,9 +26,12 @@ public class ApplicationContext
         private readonly IServiceProvider _hostServices;
         private readonly ICache _cache;
         private readonly ICacheContextAccessor _cacheContextAccessor;
+        private readonly ICacheDependencyWatcher _cacheDependencyWatcher;
+        private readonly LibraryGraphCache _libraryGraphCache;
 
-        private readonly Queue<Message> _inbox = new Queue<Message>();
+        private readonly MessageInbox _inbox = new MessageInbox();
         private readonly object _processingLock = new object();
+        private readonly ScheduledWork _processing;
 
         private readonly Trigger<string> _appPath = new Trigger<string>();
         private readonly Trigger<FrameworkName> _targetFramework = new Trigger<FrameworkName>();
@@ -40,15 +43,28 @@ public class ApplicationContext
         private World _remote = new World();
         private World _local = new World();
 
+        // Versions of References and Sources the client may hold, used to send deltas
+        private readonly SnapshotHistory<ReferencesMessage> _referencesHistory = new SnapshotHistory<ReferencesMessage>();
+        private readonly SnapshotHistory<SourcesMessage> _sourcesHistory = new SnapshotHistory<SourcesMessage>();
+
         private ConnectionContext _initializedContext;
         private readonly List<CompiledAssemblyState> _waitingForCompiledAssemblies = new List<CompiledAssemblyState>();
         private readonly List<ConnectionContext> _waitingForDiagnostics = new List<ConnectionContext>();
 
-        public ApplicationContext(IServiceProvider services, ICache cache, ICacheContextAccessor cacheContextAccessor, int id)
+        public ApplicationContext(IServiceProvider services,
+                                  ICache cache,
+                                  ICacheContextAccessor cacheContextAccessor,
+                                  ICacheDependencyWatcher cacheDependencyWatcher,
+                                  LibraryGraphCache libraryGraphCache,
+                                  ProcessingScheduler scheduler,
+                                  int id)
         {
             _hostServices = services;
             _cache = cache;
             _cacheContextAccessor = cacheContextAccessor;
+            _cacheDependencyWatcher = cacheDependencyWatcher;
+            _libraryGraphCache = libraryGraphCache;
+            _processing = scheduler.CreateWork(() => ProcessLoop(state: null));
             Id = id;
         }
 
@@ -58,12 +74,10 @@ public ApplicationContext(IServiceProvider services, ICache cache, ICacheContext
 
         public void OnReceive(Message message)
         {
-            lock (_inbox)
-            {
-                _inbox.Enqueue(message);
-            }
+            _inbox.Add(message);
 
-            ThreadPool.QueueUserWorkItem(ProcessLoop);
+            // Queued in order, but run without waiting for the quiet period
+            _processing.Signal(immediate: MessageInbox.IsLifetimeMessage(message));
         }
 
         public void ProcessLoop(object state)
@@ -75,12 +89,9 @@ public void ProcessLoop(object state)
 
             try
             {
-                lock (_inbox)
+                if (_inbox.Count == 0)
                 {
-                    if (_inbox.IsEmpty())
-                    {
-                        return;
-                    }
+                    return;
                 }
 
                 DoProcessLoop();
@@ -110,21 +121,11 @@ public void ProcessLoop(object state)
 
         public void DoProcessLoop()
         {
-            while (true)
-            {
-                DrainInbox();
-                Calculate();
-                Reconcile();
-
-                lock (_inbox)
-                {
-                    // If there's no more messages queued then bail out.
-                    if (_inbox.Count == 0)
-                    {
-                        return;
-                    }
-                }
-            }
+            // Messages that arrive while this runs signal the scheduler again, which
+            // coalesces them into the next pass.
+            DrainInbox();
+            Calculate();
+            Reconcile();
         }
 
         private void DrainInbox()
@@ -136,21 +137,15 @@ private void DrainInbox()
         private bool ProcessMessage()
         {
             Message message;
-
-            lock (_inbox)
+            if (!_inbox.TryTake(out message))
             {
-                if (_inbox.IsEmpty())
-                {
-                    return false;
-                }
-
-                message = _inbox.Dequeue();
+                return false;
+            }
 
-                // REVIEW: Can this ever happen?
-                if (message == null)
-                {
-                    return false;
-                }
+            // REVIEW: Can this ever happen?
+            if (message == null)
+            {
+                return false;
             }
 
             Trace.TraceInformation("[ApplicationContext]: Received {0}", message.MessageType);
@@ -159,26 +154,32 @@ private bool ProcessMessage()
             {
                 case "Initialize":
                     {
-                        // This should only be sent once
-                        if (_initializedContext == null)
+                        if (_initializedContext != null)
                         {
-                            _initializedContext = message.Sender;
+                            // A client that lost its state (or reconnected) initializes again and gets
+                            // everything in full, the same as after Resync
+                            Trace.TraceInformation("[ApplicationContext]: Reinitializing {0}", _appPath.Value);
+                            ResetRemote();
+                        }
 
-                            var data = message.Payload.ToObject<InitializeMessage>();
-                            _appPath.Value = data.ProjectFolder;
-                            _configuration.Value = data.Configuration ?? "Debug";
+                        _initializedContext = message.Sender;
 
-                            SetTargetFramework(data.TargetFramework);
-                        }
-                        else
-                        {
-                            Trace.TraceInformation("[ApplicationContext]: Received Initialize message more than once for {0}", _appPath.Value);
-                        }
+                        var data = message.Payload.ToObject<InitializeMessage>();
+                        _appPath.Value = data.ProjectFolder;
+                        _configuration.Value = data.Configuration ?? "Debug";
+
+                        SetTargetFramework(data.TargetFramework);
                     }
                     break;
                 case "Teardown":
                     {
-                        // TODO: Implement
+                        // The client is done with the project, the shared graph goes once no other context uses it
+                        var state = _state.Value;
+                        if (state != null && state.DependencyGraph != null)
+                        {
+                            _libraryGraphCache.Release(state.DependencyGraph);
+                            state.DependencyGraph = null;
+                        }
                     }
                     break;
                 case "ChangeTargetFramework":
@@ -195,14 +196,37 @@ private bool ProcessMessage()
                     break;
                 case "FilesChanged":
                     {
+                        // The client saw the change first, the watcher events may not have arrived yet
+                        _cacheDependencyWatcher.Flush();
                         _filesChanged.Value = default(Nada);
                     }
                     break;
+                case "Acknowledge":
+                    {
+                        var data = message.Payload.ToObject<AcknowledgeMessage>();
+                        if (data.MessageType == "References")
+                        {
+                            _referencesHistory.Acknowledge(data.Version);
+                        }
+                        else if (data.MessageType == "Sources")
+                        {
+                            _sourcesHistory.Acknowledge(data.Version);
+                        }
+                    }
+                    break;
+                case "Resync":
+                    {
+                        ResetRemote();
+                    }
+                    break;
                 case "GetCompiledAssembly":
                     {
+                        var data = message.Payload == null ? null : message.Payload.ToObject<GetCompiledAssemblyMessage>();
+
                         _waitingForCompiledAssemblies.Add(new CompiledAssemblyState
                         {
                             Connection = message.Sender,
+                            UseSharedFile = data != null && string.Equals(data.Transport, "File", StringComparison.OrdinalIgnoreCase)
                         });
                     }
                     break;
@@ -245,7 +269,15 @@ private void Calculate()
                 _configuration.ClearAssigned();
                 _filesChanged.ClearAssigned();
 
+                var previousState = _state.Value;
+
                 _state.Value = Initialize(_appPath.Value, _targetFramework.Value, _configuration.Value);
+
+                // Release after acquiring the new graph so an unchanged graph stays cached
+                if (previousState != null && previousState.DependencyGraph != null)
+                {
+                    _libraryGraphCache.Release(previousState.DependencyGraph);
+                }
             }
 
             var state = _state.Value;
@@ -333,6 +365,7 @@ private void Calculate()
                     AssemblyBytes = engine.AssemblyBytes ?? new byte[0],
                     PdbBytes = engine.PdbBytes ?? new byte[0],
                     AssemblyPath = engine.AssemblyPath,
+                    AssemblyName = state.Project.Name,
                     EmbeddedReferences = embeddedReferences
                 };
 
@@ -369,14 +402,31 @@ private void Reconcile()
 
             if (IsDifferent(_local.References, _remote.References))
             {
-                Trace.TraceInformation("[ApplicationContext]: OnTransmit(References)");
+                _local.References.Version = _referencesHistory.Add(_local.References);
 
-                _initializedContext.Transmit(new Message
+                var baseline = _referencesHistory.GetAcknowledged();
+                if (baseline != null)
                 {
-                    ContextId = Id,
-                    MessageType = "References",
-                    Payload = JToken.FromObject(_local.References)
-                });
+                    Trace.TraceInformation("[ApplicationContext]: OnTransmit(References.Delta)");
+
+                    _initializedContext.Transmit(new Message
+                    {
+                        ContextId = Id,
+                        MessageType = "References.Delta",
+                        Payload = JToken.FromObject(ReferencesDeltaMessage.Create(baseline, _local.References))
+                    });
+                }
+                else
+                {
+                    Trace.TraceInformation("[ApplicationContext]: OnTransmit(References)");
+
+                    _initializedContext.Transmit(new Message
+                    {
+                        ContextId = Id,
+                        MessageType = "References",
+                        Payload = JToken.FromObject(_local.References)
+                    });
+                }
 
                 _remote.References = _local.References;
             }
@@ -397,14 +447,31 @@ private void Reconcile()
 
             if (IsDifferent(_local.Sources, _remote.Sources))
             {
-                Trace.TraceInformation("[ApplicationContext]: OnTransmit(Sources)");
+                _local.Sources.Version = _sourcesHistory.Add(_local.Sources);
 
-                _initializedContext.Transmit(new Message
+                var baseline = _sourcesHistory.GetAcknowledged();
+                if (baseline != null)
                 {
-                    ContextId = Id,
-                    MessageType = "Sources",
-                    Payload = JToken.FromObject(_local.Sources)
-                });
+                    Trace.TraceInformation("[ApplicationContext]: OnTransmit(Sources.Delta)");
+
+                    _initializedContext.Transmit(new Message
+                    {
+                        ContextId = Id,
+                        MessageType = "Sources.Delta",
+                        Payload = JToken.FromObject(SourcesDeltaMessage.Create(baseline, _local.Sources))
+                    });
+                }
+                else
+                {
+                    Trace.TraceInformation("[ApplicationContext]: OnTransmit(Sources)");
+
+                    _initializedContext.Transmit(new Message
+                    {
+                        ContextId = Id,
+                        MessageType = "Sources",
+                        Payload = JToken.FromObject(_local.Sources)
+                    });
+                }
 
                 _remote.Sources = _local.Sources;
             }
@@ -415,9 +482,20 @@ private void Reconcile()
 
                 if (!waitingForCompiledAssembly.AssemblySent)
                 {
-                    Trace.TraceInformation("[ApplicationContext]: OnTransmit(Assembly)");
+                    var assemblyPath = waitingForCompiledAssembly.UseSharedFile ? GetSharedAssemblyPath() : null;
 
-                    waitingForCompiledAssembly.Connection.Transmit(WriteAssembly);
+                    if (assemblyPath != null)
+                    {
+                        Trace.TraceInformation("[ApplicationContext]: OnTransmit(AssemblyFile)");
+
+                        waitingForCompiledAssembly.Connection.Transmit(WriteAssemblyFile(assemblyPath));
+                    }
+                    else
+                    {
+                        Trace.TraceInformation("[ApplicationContext]: OnTransmit(Assembly)");
+
+                        waitingForCompiledAssembly.Connection.Transmit(WriteAssembly);
+                    }
 
                     waitingForCompiledAssembly.AssemblySent = true;
                 }
@@ -451,9 +529,65 @@ private void Reconcile()
             _waitingForDiagnostics.Clear();
         }
 
+        private string GetSharedAssemblyPath()
+        {
+            var compiled = _local.Compiled;
+
+            if (compiled.SharedAssemblyPath == null && (compiled.AssemblyPath != null || compiled.AssemblyBytes.Length > 0))
+            {
+                try
+                {
+                    string hash;
+                    if (compiled.AssemblyPath != null)
+                    {
+                        // The project's own output can be rebuilt while the application loads it, share a copy
+                        compiled.SharedAssemblyPath = SharedAssemblyStore.WriteFile(compiled.AssemblyName,
+                                                                                    compiled.AssemblyPath,
+                                                                                    out hash);
+                    }
+                    else
+                    {
+                        compiled.SharedAssemblyPath = SharedAssemblyStore.Write(compiled.AssemblyName,
+                                                                                compiled.AssemblyBytes,
+                                                                                compiled.PdbBytes,
+                                                                                out hash);
+                    }
+                    compiled.SharedAssemblyHash = hash;
+                }
+                catch (Exception ex)
+                {
+                    // Send the bytes instead
+                    Trace.TraceError("[ApplicationContext]: Unable to share the compiled assembly: {0}", ex);
+                }
+            }
+
+            return compiled.SharedAssemblyPath;
+        }
+
         private void WriteAssembly(BinaryWriter writer)
         {
             writer.Write("Assembly");
+            WriteCompileResult(writer);
+            writer.Write(_local.Compiled.AssemblyBytes.Length);
+            writer.Write(_local.Compiled.AssemblyBytes);
+            writer.Write(_local.Compiled.PdbBytes.Length);
+            writer.Write(_local.Compiled.PdbBytes);
+        }
+
+        private Action<BinaryWriter> WriteAssemblyFile(string assemblyPath)
+        {
+            // Only the path goes over the wire, the application checks the image against the hash before loading it
+            return writer =>
+            {
+                writer.Write("AssemblyFile");
+                WriteCompileResult(writer);
+                writer.Write(assemblyPath);
+                writer.Write(_local.Compiled.SharedAssemblyHash);
+            };
+        }
+
+        private void WriteCompileResult(BinaryWriter writer)
+        {
             writer.Write(Id);
             writer.Write(_local.Diagnostics.Warnings.Count);
             foreach (var warning in _local.Diagnostics.Warnings)
@@ -472,10 +606,6 @@ private void WriteAssembly(BinaryWriter writer)
                 writer.Write(pair.Value.Length);
                 writer.Write(pair.Value);
             }
-            writer.Write(_local.Compiled.AssemblyBytes.Length);
-            writer.Write(_local.Compiled.AssemblyBytes);
-            writer.Write(_local.Compiled.PdbBytes.Length);
-            writer.Write(_local.Compiled.PdbBytes);
         }
 
         private bool IsDifferent<T>(T local, T remote) where T : class
@@ -483,6 +613,14 @@ private void WriteAssembly(BinaryWriter writer)
             return !object.Equals(local, remote);
         }
 
+        private void ResetRemote()
+        {
+            // Forget what the client has, the next reconcile sends everything in full
+            _remote = new World();
+            _referencesHistory.Reset();
+            _sourcesHistory.Reset();
+        }
+
         private State Initialize(string appPath, FrameworkName targetFramework, string configuration)
         {
             var state = new State
@@ -498,7 +636,8 @@ private State Initialize(string appPath, FrameworkName targetFramework, string c
                                                                     configuration: configuration,
                                                                     targetFramework: targetFramework,
                                                                     cache: _cache,
-                                                                    cacheContextAccessor: _cacheContextAccessor);
+                                                                    cacheContextAccessor: _cacheContextAccessor,
+                                                                    libraryGraphCache: _libraryGraphCache);
 
             Project project = applicationHostContext.Project;
 
@@ -513,7 +652,7 @@ private State Initialize(string appPath, FrameworkName targetFramework, string c
             state.Project = project;
             state.FrameworkResolver = applicationHostContext.FrameworkReferenceResolver;
 
-            applicationHostContext.DependencyWalker.Walk(state.Project.Name, state.Project.Version, targetFramework);
+            state.DependencyGraph = applicationHostContext.AcquireDependencyGraph();
 
             Func<LibraryDescription, ReferenceDescription> referenceFactory = library =>
             {
@@ -728,12 +867,16 @@ private class State
             public IDictionary<string, ReferenceDescription> Dependencies { get; set; }
 
             public FrameworkReferenceResolver FrameworkResolver { get; set; }
+
+            public LibraryGraph DependencyGraph { get; set; }
         }
 
         private class CompiledAssemblyState
         {
             public ConnectionContext Connection { get; set; }
 
+            public bool UseSharedFile { get; set; }
+
             public bool AssemblySent { get; set; }
 
             public bool ProjectChanged { get; set; }
@@ -16,6 +16,9 @@ public class ConnectionContext
         private readonly IServiceProvider _services;
         private readonly ICache _cache;
         private readonly ICacheContextAccessor _cacheContextAccessor;
+        private readonly ICacheDependencyWatcher _cacheDependencyWatcher;
+        private readonly LibraryGraphCache _libraryGraphCache;
+        private readonly ProcessingScheduler _scheduler;
         private ProcessingQueue _queue;
         private string _hostId;
 
@@ -23,6 +26,9 @@ public class ConnectionContext
                                  IServiceProvider services,
                                  ICache cache,
                                  ICacheContextAccessor cacheContextAccessor,
+                                 ICacheDependencyWatcher cacheDependencyWatcher,
+                                 LibraryGraphCache libraryGraphCache,
+                                 ProcessingScheduler scheduler,
                                  ProcessingQueue queue,
                                  string hostId)
         {
@@ -30,6 +36,9 @@ public class ConnectionContext
             _services = services;
             _cache = cache;
             _cacheContextAccessor = cacheContextAccessor;
+            _cacheDependencyWatcher = cacheDependencyWatcher;
+            _libraryGraphCache = libraryGraphCache;
+            _scheduler = scheduler;
             _queue = queue;
             _hostId = hostId;
         }
@@ -59,6 +68,9 @@ public void OnReceive(Message message)
                 applicationContext = new ApplicationContext(_services,
                                                             _cache,
                                                             _cacheContextAccessor,
+                                                            _cacheDependencyWatcher,
+                                                            _libraryGraphCache,
+                                                            _scheduler,
                                                             message.ContextId);
 
                 _contexts.Add(message.ContextId, applicationContext);
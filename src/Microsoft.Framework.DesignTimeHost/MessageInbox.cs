@@ -0,0 +1,104 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+using System.Collections.Generic;
+using Microsoft.Framework.DesignTimeHost.Models;
+
+namespace Microsoft.Framework.DesignTimeHost
+{
+    /// <summary>
+    /// The messages an application context hasn't processed yet, in arrival order. A message that one
+    /// already queued covers is dropped, and a change that a new one supersedes is replaced, but never
+    /// across an Initialize or Teardown: those see exactly the changes that arrived before them.
+    /// </summary>
+    public class MessageInbox
+    {
+        private readonly LinkedList<Message> _messages = new LinkedList<Message>();
+
+        public int Count
+        {
+            get
+            {
+                lock (_messages)
+                {
+                    return _messages.Count;
+                }
+            }
+        }
+
+        /// <summary>
+        /// Initialize and Teardown start or end the context's work on a project.
+        /// </summary>
+        public static bool IsLifetimeMessage(Message message)
+        {
+            return message.MessageType == "Initialize" ||
+                   message.MessageType == "Teardown";
+        }
+
+        public void Add(Message message)
+        {
+            lock (_messages)
+            {
+                if (!IsRedundant(message))
+                {
+                    _messages.AddLast(message);
+                }
+            }
+        }
+
+        public bool TryTake(out Message message)
+        {
+            lock (_messages)
+            {
+                if (_messages.Count == 0)
+                {
+                    message = null;
+                    return false;
+                }
+
+                message = _messages.First.Value;
+                _messages.RemoveFirst();
+                return true;
+            }
+        }
+
+        // Must be called with the messages locked
+        private bool IsRedundant(Message message)
+        {
+            for (var node = _messages.Last; node != null; node = node.Previous)
+            {
+                var queued = node.Value;
+                if (IsLifetimeMessage(queued))
+                {
+                    // Whatever is queued before it has to be processed before it
+                    return false;
+                }
+
+                if (queued.MessageType != message.MessageType)
+                {
+                    continue;
+                }
+
+                switch (message.MessageType)
+                {
+                    case "FilesChanged":
+                        return true;
+                    case "GetDiagnostics":
+                    case "GetCompiledAssembly":
+                        if (queued.Sender == message.Sender)
+                        {
+                            return true;
+                        }
+                        break;
+                    case "ChangeConfiguration":
+                    case "ChangeTargetFramework":
+                        // Only the last value matters
+                        _messages.Remove(node);
+                        return false;
+                }
+            }
+
+            return false;
+        }
+    }
+}
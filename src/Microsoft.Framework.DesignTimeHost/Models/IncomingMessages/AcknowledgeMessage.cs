@@ -0,0 +1,13 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+namespace Microsoft.Framework.DesignTimeHost.Models.IncomingMessages
+{
+    public class AcknowledgeMessage
+    {
+        // The message type being acknowledged e.g. References or Sources
+        public string MessageType { get; set; }
+
+        public int Version { get; set; }
+    }
+}
@@ -0,0 +1,11 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+namespace Microsoft.Framework.DesignTimeHost.Models.IncomingMessages
+{
+    public class GetCompiledAssemblyMessage
+    {
+        // "File" when the application can load the assembly from a path on this machine
+        public string Transport { get; set; }
+    }
+}
@@ -11,5 +11,13 @@ public class CompileMessage
         public byte[] PdbBytes { get; set; }
 
         public string AssemblyPath { get; set; }
+
+        public string AssemblyName { get; set; }
+
+        // Where SharedAssemblyStore put the bytes, written on first request
+        public string SharedAssemblyPath { get; set; }
+
+        // SHA-256 of the shared image and pdb, the application checks the file against it
+        public string SharedAssemblyHash { get; set; }
     }
 }
\ No newline at end of file
@@ -0,0 +1,47 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+using System;
+using System.Collections.Generic;
+using System.Linq;
+
+namespace Microsoft.Framework.DesignTimeHost.Models.OutgoingMessages
+{
+    /// <summary>
+    /// Turns the list the client has into the current one: remove <see cref="RemovedCount"/> entries at
+    /// <see cref="Index"/>, then insert <see cref="Inserted"/> there. Whatever both lists start and end with is
+    /// kept, so order and duplicates come out exactly. Changes in several places replace everything between them.
+    /// </summary>
+    public class ListDelta
+    {
+        public int Index { get; set; }
+        public int RemovedCount { get; set; }
+        public IList<string> Inserted { get; set; }
+
+        public static ListDelta Create(IList<string> baseline, IList<string> current)
+        {
+            var prefix = 0;
+            while (prefix < baseline.Count &&
+                   prefix < current.Count &&
+                   string.Equals(baseline[prefix], current[prefix], StringComparison.Ordinal))
+            {
+                prefix++;
+            }
+
+            var suffix = 0;
+            while (suffix < baseline.Count - prefix &&
+                   suffix < current.Count - prefix &&
+                   string.Equals(baseline[baseline.Count - suffix - 1], current[current.Count - suffix - 1], StringComparison.Ordinal))
+            {
+                suffix++;
+            }
+
+            return new ListDelta
+            {
+                Index = prefix,
+                RemovedCount = baseline.Count - prefix - suffix,
+                Inserted = current.Skip(prefix).Take(current.Count - prefix - suffix).ToList()
+            };
+        }
+    }
+}
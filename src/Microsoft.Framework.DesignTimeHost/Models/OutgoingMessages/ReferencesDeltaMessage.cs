@@ -0,0 +1,65 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+using System;
+using System.Collections.Generic;
+using System.Linq;
+
+namespace Microsoft.Framework.DesignTimeHost.Models.OutgoingMessages
+{
+    public class ReferencesDeltaMessage
+    {
+        public int BaseVersion { get; set; }
+        public int Version { get; set; }
+        public string RootDependency { get; set; }
+        public string LongFrameworkName { get; set; }
+        public string FriendlyFrameworkName { get; set; }
+        public ListDelta ProjectReferences { get; set; }
+        public ListDelta FileReferences { get; set; }
+
+        // Added or changed entries, keyed the same way as the full message
+        public IDictionary<string, byte[]> AddedRawReferences { get; set; }
+        public IList<string> RemovedRawReferences { get; set; }
+        public IDictionary<string, ReferenceDescription> AddedDependencies { get; set; }
+        public IList<string> RemovedDependencies { get; set; }
+
+        public static ReferencesDeltaMessage Create(ReferencesMessage baseline, ReferencesMessage current)
+        {
+            return new ReferencesDeltaMessage
+            {
+                BaseVersion = baseline.Version,
+                Version = current.Version,
+                RootDependency = current.RootDependency,
+                LongFrameworkName = current.LongFrameworkName,
+                FriendlyFrameworkName = current.FriendlyFrameworkName,
+                ProjectReferences = ListDelta.Create(baseline.ProjectReferences, current.ProjectReferences),
+                FileReferences = ListDelta.Create(baseline.FileReferences, current.FileReferences),
+                AddedRawReferences = GetChanged(baseline.RawReferences, current.RawReferences, (a, b) => Enumerable.SequenceEqual(a, b)),
+                RemovedRawReferences = GetRemoved(baseline.RawReferences, current.RawReferences),
+                AddedDependencies = GetChanged(baseline.Dependencies, current.Dependencies, (a, b) => object.Equals(a, b)),
+                RemovedDependencies = GetRemoved(baseline.Dependencies, current.Dependencies)
+            };
+        }
+
+        private static IDictionary<string, T> GetChanged<T>(IDictionary<string, T> baseline,
+                                                            IDictionary<string, T> current,
+                                                            Func<T, T, bool> equals)
+        {
+            var changed = new Dictionary<string, T>();
+            foreach (var pair in current)
+            {
+                T previous;
+                if (!baseline.TryGetValue(pair.Key, out previous) || !equals(previous, pair.Value))
+                {
+                    changed[pair.Key] = pair.Value;
+                }
+            }
+            return changed;
+        }
+
+        private static IList<string> GetRemoved<T>(IDictionary<string, T> baseline, IDictionary<string, T> current)
+        {
+            return baseline.Keys.Where(key => !current.ContainsKey(key)).ToList();
+        }
+    }
+}
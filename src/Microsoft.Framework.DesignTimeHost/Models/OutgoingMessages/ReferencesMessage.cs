@@ -8,6 +8,8 @@ namespace Microsoft.Framework.DesignTimeHost.Models.OutgoingMessages
 {
     public class ReferencesMessage
     {
+        // Assigned when the message is sent, not part of equality
+        public int Version { get; set; }
         public string RootDependency { get; set; }
         public string LongFrameworkName { get; set; }
         public string FriendlyFrameworkName { get; set; }
@@ -0,0 +1,26 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+using System.Collections.Generic;
+
+namespace Microsoft.Framework.DesignTimeHost.Models.OutgoingMessages
+{
+    public class SourcesDeltaMessage
+    {
+        public int BaseVersion { get; set; }
+        public int Version { get; set; }
+        public ListDelta Files { get; set; }
+        public IDictionary<string, string> GeneratedFiles { get; set; }
+
+        public static SourcesDeltaMessage Create(SourcesMessage baseline, SourcesMessage current)
+        {
+            return new SourcesDeltaMessage
+            {
+                BaseVersion = baseline.Version,
+                Version = current.Version,
+                Files = ListDelta.Create(baseline.Files, current.Files),
+                GeneratedFiles = current.GeneratedFiles
+            };
+        }
+    }
+}
@@ -8,6 +8,8 @@ namespace Microsoft.Framework.DesignTimeHost.Models.OutgoingMessages
 {
     public class SourcesMessage
     {
+        // Assigned when the message is sent, not part of equality
+        public int Version { get; set; }
         public IList<string> Files { get; set; }
         public IDictionary<string, string> GeneratedFiles { get; set; }
 
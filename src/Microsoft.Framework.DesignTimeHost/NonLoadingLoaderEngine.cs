@@ -15,20 +15,42 @@ public Assembly LoadFile(string path)
 
         public Assembly LoadStream(Stream assemblyStream, Stream pdbStream)
         {
-            var ms = new MemoryStream((int)assemblyStream.Length);
-            assemblyStream.CopyTo(ms);
-            AssemblyBytes = ms.ToArray();
+            AssemblyBytes = ReadAllBytes(assemblyStream);
 
             if (pdbStream != null)
             {
-                ms = new MemoryStream((int)assemblyStream.Length);
-                pdbStream.CopyTo(ms);
-                PdbBytes = ms.ToArray();
+                PdbBytes = ReadAllBytes(pdbStream);
             }
 
             return null;
         }
 
+        private static byte[] ReadAllBytes(Stream stream)
+        {
+            var ms = stream as MemoryStream;
+            if (ms == null)
+            {
+                ms = new MemoryStream((int)stream.Length);
+                stream.CopyTo(ms);
+            }
+
+            // The bytes are sent as is, don't copy them again when the buffer is exactly sized
+            try
+            {
+                var buffer = ms.GetBuffer();
+                if (buffer.Length == ms.Length)
+                {
+                    return buffer;
+                }
+            }
+            catch (UnauthorizedAccessException)
+            {
+                // The buffer isn't publicly visible
+            }
+
+            return ms.ToArray();
+        }
+
         public byte[] AssemblyBytes { get; set; }
         public byte[] PdbBytes { get; set; }
 
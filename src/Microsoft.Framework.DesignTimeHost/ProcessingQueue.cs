@@ -6,7 +6,9 @@
 using System.IO;
 using System.Threading;
 using Microsoft.Framework.DesignTimeHost.Models;
-using Newtonsoft.Json;
+using Microsoft.Framework.DesignTimeHost.Models.IncomingMessages;
+using Microsoft.Framework.DesignTimeHost.Protocol;
+using Newtonsoft.Json.Linq;
 
 namespace Microsoft.Framework.DesignTimeHost
 {
@@ -15,12 +17,26 @@ public class ProcessingQueue
         private readonly BinaryReader _reader;
         private readonly BinaryWriter _writer;
 
+        // Every connection starts out speaking JSON. The client can switch to another format, each
+        // direction switches after a message both sides have seen so no frame is read in the wrong one:
+        //
+        //   client NegotiateProtocol   the host answers with the protocol it picked, in the old format.
+        //                              Everything the host writes after the answer uses the new one.
+        //   client ProtocolChanged     sent by the client in the old format once it has the answer.
+        //                              Everything the client writes after it uses the new one.
+        private IMessageSerializer _writeSerializer = new JsonMessageSerializer();
+
+        // Only used by the receive thread
+        private IMessageSerializer _readSerializer;
+        private IMessageSerializer _pendingReadSerializer;
+
         public event Action<Message> OnReceive;
 
         public ProcessingQueue(Stream stream)
         {
             _reader = new BinaryReader(stream);
             _writer = new BinaryWriter(stream);
+            _readSerializer = _writeSerializer;
         }
 
         public void Start()
@@ -35,7 +51,7 @@ public bool Send(Action<BinaryWriter> write)
             {
                 lock (_writer)
                 {
-                    write(_writer);
+                    _writeSerializer.WriteRaw(_writer, write);
                     return true;
                 }
             }
@@ -54,7 +70,7 @@ public bool Send(Message message)
                 try
                 {
                     Trace.TraceInformation("[ProcessingQueue]: Send({0})", message);
-                    _writer.Write(JsonConvert.SerializeObject(message));
+                    _writeSerializer.WriteMessage(_writer, message);
 
                     return true;
                 }
@@ -73,8 +89,21 @@ private void ReceiveMessages()
             {
                 while (true)
                 {
-                    var message = JsonConvert.DeserializeObject<Message>(_reader.ReadString());
+                    var message = _readSerializer.ReadMessage(_reader);
                     Trace.TraceInformation("[ProcessingQueue]: OnReceive({0})", message);
+
+                    if (message.MessageType == "NegotiateProtocol")
+                    {
+                        NegotiateProtocol(message);
+                        continue;
+                    }
+
+                    if (message.MessageType == "ProtocolChanged")
+                    {
+                        ProtocolChanged();
+                        continue;
+                    }
+
                     OnReceive(message);
                 }
             }
@@ -83,5 +112,59 @@ private void ReceiveMessages()
                 Trace.TraceInformation("[ProcessingQueue]: Error occurred: {0}", ex);
             }
         }
+
+        private void NegotiateProtocol(Message message)
+        {
+            var data = message.Payload == null ? null : message.Payload.ToObject<NegotiateProtocolMessage>();
+            var requested = data == null ? null : data.Protocol;
+
+            IMessageSerializer serializer;
+            if (string.Equals(requested, BinaryMessageSerializer.ProtocolName, StringComparison.OrdinalIgnoreCase))
+            {
+                serializer = new BinaryMessageSerializer();
+            }
+            else
+            {
+                // Unknown protocols fall back to JSON, the response tells the client what was picked
+                serializer = new JsonMessageSerializer();
+            }
+
+            lock (_writer)
+            {
+                // The response is written in the current format, everything the host writes after it uses
+                // the negotiated one. The client may still be writing in the current format, it switches
+                // after ProtocolChanged.
+                _writeSerializer.WriteMessage(_writer, new Message
+                {
+                    HostId = message.HostId,
+                    MessageType = "NegotiateProtocol",
+                    ContextId = message.ContextId,
+                    Payload = JToken.FromObject(new NegotiateProtocolMessage
+                    {
+                        Protocol = serializer.Name
+                    })
+                });
+
+                _writeSerializer = serializer;
+            }
+
+            _pendingReadSerializer = serializer;
+
+            Trace.TraceInformation("[ProcessingQueue]: Negotiated protocol {0}", serializer.Name);
+        }
+
+        private void ProtocolChanged()
+        {
+            if (_pendingReadSerializer == null)
+            {
+                Trace.TraceInformation("[ProcessingQueue]: ProtocolChanged without a negotiated protocol");
+                return;
+            }
+
+            _readSerializer = _pendingReadSerializer;
+            _pendingReadSerializer = null;
+
+            Trace.TraceInformation("[ProcessingQueue]: Reading {0}", _readSerializer.Name);
+        }
     }
 }
@@ -0,0 +1,104 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+using System;
+using System.Collections.Generic;
+using System.Threading;
+
+namespace Microsoft.Framework.DesignTimeHost
+{
+    /// <summary>
+    /// Runs the processing loops of all application contexts on a bounded set of workers. Bursts of
+    /// signals for a context are coalesced into a single run once the context has been quiet for
+    /// <see cref="QuietPeriod"/>, but never later than <see cref="MaxLatency"/> after the first signal.
+    /// </summary>
+    public class ProcessingScheduler
+    {
+        private readonly Queue<ScheduledWork> _priority = new Queue<ScheduledWork>();
+        private readonly Queue<ScheduledWork> _ready = new Queue<ScheduledWork>();
+        private int _active;
+
+        public ProcessingScheduler(TimeSpan quietPeriod, TimeSpan maxLatency, int maxConcurrency)
+        {
+            QuietPeriod = quietPeriod;
+            MaxLatency = maxLatency < quietPeriod ? quietPeriod : maxLatency;
+            MaxConcurrency = Math.Max(1, maxConcurrency);
+        }
+
+        public TimeSpan QuietPeriod { get; private set; }
+
+        public TimeSpan MaxLatency { get; private set; }
+
+        public int MaxConcurrency { get; private set; }
+
+        public static ProcessingScheduler CreateDefault()
+        {
+            return new ProcessingScheduler(
+                TimeSpan.FromMilliseconds(GetSetting("KRE_DESIGNTIME_QUIET_PERIOD", 50)),
+                TimeSpan.FromMilliseconds(GetSetting("KRE_DESIGNTIME_MAX_LATENCY", 500)),
+                GetSetting("KRE_DESIGNTIME_WORKERS", Environment.ProcessorCount));
+        }
+
+        public ScheduledWork CreateWork(Action work)
+        {
+            return new ScheduledWork(this, work);
+        }
+
+        internal void Enqueue(ScheduledWork work, bool priority)
+        {
+            lock (_ready)
+            {
+                if (priority)
+                {
+                    _priority.Enqueue(work);
+                }
+                else
+                {
+                    _ready.Enqueue(work);
+                }
+            }
+
+            Pump();
+        }
+
+        private void Pump()
+        {
+            lock (_ready)
+            {
+                while (_active < MaxConcurrency && (_priority.Count > 0 || _ready.Count > 0))
+                {
+                    var work = _priority.Count > 0 ? _priority.Dequeue() : _ready.Dequeue();
+                    _active++;
+                    ThreadPool.QueueUserWorkItem(RunWork, work);
+                }
+            }
+        }
+
+        private void RunWork(object state)
+        {
+            try
+            {
+                ((ScheduledWork)state).Run();
+            }
+            finally
+            {
+                lock (_ready)
+                {
+                    _active--;
+                }
+
+                Pump();
+            }
+        }
+
+        private static int GetSetting(string name, int defaultValue)
+        {
+            int value;
+            if (Int32.TryParse(Environment.GetEnvironmentVariable(name), out value) && value >= 0)
+            {
+                return value;
+            }
+            return defaultValue;
+        }
+    }
+}
@@ -48,8 +48,11 @@ public void Main(string[] args)
         private async Task OpenChannel(int port, string hostId)
         {
             var cacheContextAccessor = new CacheContextAccessor();
-            var cache = new Cache(cacheContextAccessor);
+            var cacheDependencyWatcher = new FileCacheDependencyWatcher();
+            var cache = new Cache(cacheContextAccessor, cacheDependencyWatcher);
             var contexts = new Dictionary<int, ApplicationContext>();
+            var libraryGraphCache = new LibraryGraphCache();
+            var scheduler = ProcessingScheduler.CreateDefault();
 
             // This fixes the mono incompatibility but ties it to ipv4 connections
             var listenSocket = new Socket(AddressFamily.InterNetwork, SocketType.Stream, ProtocolType.Tcp);
@@ -66,7 +69,7 @@ private async Task OpenChannel(int port, string hostId)
 
                 var stream = new NetworkStream(acceptSocket);
                 var queue = new ProcessingQueue(stream);
-                var connection = new ConnectionContext(contexts, _services, cache, cacheContextAccessor, queue, hostId);
+                var connection = new ConnectionContext(contexts, _services, cache, cacheContextAccessor, cacheDependencyWatcher, libraryGraphCache, scheduler, queue, hostId);
 
                 queue.OnReceive += message =>
                 {
@@ -0,0 +1,631 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+using System;
+using System.Collections.Generic;
+using System.IO;
+using Microsoft.Framework.DesignTimeHost.Models;
+using Newtonsoft.Json;
+using Newtonsoft.Json.Linq;
+
+namespace Microsoft.Framework.DesignTimeHost.Protocol
+{
+    /// <summary>
+    /// Compact tagged encoding of <see cref="Message"/>. Strings (paths, assembly names, property names)
+    /// are interned per connection and sent once, after which they are referred to by index. Each top level
+    /// payload property is delta encoded against the last value sent for the same message type and context,
+    /// so a reference or source list that gained one entry costs one entry on the wire. When the interned
+    /// strings or the delta bases reach their limit the writer sends a reset frame and both sides start over.
+    /// </summary>
+    /// <remarks>
+    /// An instance holds the state of a single connection and must not be shared. Reads and writes keep
+    /// separate state, so a reader thread and a (locked) writer can use the same instance.
+    /// </remarks>
+    public class BinaryMessageSerializer : IMessageSerializer
+    {
+        public const string ProtocolName = "binary";
+
+        // Frame kinds
+        private const byte MessageFrame = 0;
+        private const byte RawFrame = 1;
+        private const byte ResetFrame = 2;
+
+        // Token tags
+        private const byte NullTag = 0;
+        private const byte ObjectTag = 1;
+        private const byte ArrayTag = 2;
+        private const byte StringTag = 3;
+        private const byte IntegerTag = 4;
+        private const byte FloatTag = 5;
+        private const byte TrueTag = 6;
+        private const byte FalseTag = 7;
+        private const byte BytesTag = 8;
+        private const byte JsonTag = 9;
+        private const byte ObjectDeltaTag = 10;
+        private const byte ArrayDeltaTag = 11;
+
+        // Array delta operations
+        private const byte CopyOperation = 0;
+        private const byte InsertOperation = 1;
+
+        // String codes, anything above DefineString is a reference to an interned string
+        private const int NullString = 0;
+        private const int LiteralString = 1;
+        private const int DefineString = 2;
+        private const int FirstStringReference = 3;
+
+        private const int MaxInternedStringLength = 1024;
+
+        public const int DefaultMaxInternedStrings = 1 << 16;
+        public const int DefaultMaxSnapshots = 4096;
+
+        private readonly int _maxInternedStrings;
+        private readonly int _maxSnapshots;
+
+        private readonly Dictionary<string, int> _outgoingStrings = new Dictionary<string, int>(StringComparer.Ordinal);
+        private readonly List<string> _incomingStrings = new List<string>();
+
+        private readonly Dictionary<string, JToken> _outgoingSnapshots = new Dictionary<string, JToken>(StringComparer.Ordinal);
+        private readonly Dictionary<string, JToken> _incomingSnapshots = new Dictionary<string, JToken>(StringComparer.Ordinal);
+
+        public BinaryMessageSerializer()
+            : this(DefaultMaxInternedStrings, DefaultMaxSnapshots)
+        {
+        }
+
+        public BinaryMessageSerializer(int maxInternedStrings, int maxSnapshots)
+        {
+            _maxInternedStrings = maxInternedStrings;
+            _maxSnapshots = maxSnapshots;
+        }
+
+        public string Name
+        {
+            get { return ProtocolName; }
+        }
+
+        public Message ReadMessage(BinaryReader reader)
+        {
+            var frame = reader.ReadByte();
+            if (frame == ResetFrame)
+            {
+                // The writer forgot everything it sent before
+                _incomingStrings.Clear();
+                _incomingSnapshots.Clear();
+                frame = reader.ReadByte();
+            }
+
+            if (frame != MessageFrame)
+            {
+                throw new InvalidDataException(string.Format("Unexpected frame kind {0}.", frame));
+            }
+
+            var message = new Message();
+            message.HostId = ReadString(reader);
+            message.MessageType = ReadString(reader);
+            message.ContextId = reader.ReadInt32();
+            message.Payload = ReadPayload(reader, GetSnapshotPrefix(message));
+
+            return message;
+        }
+
+        public void WriteMessage(BinaryWriter writer, Message message)
+        {
+            // Contexts come and go, without a limit the state would grow for as long as the connection lives
+            if (_outgoingStrings.Count >= _maxInternedStrings || _outgoingSnapshots.Count >= _maxSnapshots)
+            {
+                writer.Write(ResetFrame);
+                _outgoingStrings.Clear();
+                _outgoingSnapshots.Clear();
+            }
+
+            writer.Write(MessageFrame);
+            WriteString(writer, message.HostId);
+            WriteString(writer, message.MessageType);
+            writer.Write(message.ContextId);
+            WritePayload(writer, message.Payload, GetSnapshotPrefix(message));
+        }
+
+        public void WriteRaw(BinaryWriter writer, Action<BinaryWriter> write)
+        {
+            writer.Write(RawFrame);
+            write(writer);
+        }
+
+        private static string GetSnapshotPrefix(Message message)
+        {
+            return message.MessageType + ":" + message.ContextId + ":";
+        }
+
+        private void WritePayload(BinaryWriter writer, JToken payload, string snapshotPrefix)
+        {
+            var payloadObject = payload as JObject;
+            if (payloadObject == null)
+            {
+                WriteToken(writer, payload);
+                return;
+            }
+
+            writer.Write(ObjectTag);
+            WriteCount(writer, payloadObject.Count);
+            foreach (var property in payloadObject.Properties())
+            {
+                WriteString(writer, property.Name);
+                WriteSnapshotValue(writer, property.Value, snapshotPrefix + property.Name);
+            }
+        }
+
+        private JToken ReadPayload(BinaryReader reader, string snapshotPrefix)
+        {
+            var tag = reader.ReadByte();
+            if (tag != ObjectTag)
+            {
+                return ReadToken(reader, tag);
+            }
+
+            var payload = new JObject();
+            var count = ReadCount(reader);
+            for (int i = 0; i < count; i++)
+            {
+                var name = ReadString(reader);
+                payload[name] = ReadSnapshotValue(reader, snapshotPrefix + name);
+            }
+
+            return payload;
+        }
+
+        private void WriteSnapshotValue(BinaryWriter writer, JToken value, string snapshotKey)
+        {
+            JToken previous;
+            _outgoingSnapshots.TryGetValue(snapshotKey, out previous);
+            _outgoingSnapshots[snapshotKey] = value;
+
+            var array = value as JArray;
+            var previousArray = previous as JArray;
+            if (array != null && previousArray != null)
+            {
+                WriteArrayDelta(writer, previousArray, array);
+                return;
+            }
+
+            var obj = value as JObject;
+            var previousObject = previous as JObject;
+            if (obj != null && previousObject != null)
+            {
+                WriteObjectDelta(writer, previousObject, obj);
+                return;
+            }
+
+            WriteToken(writer, value);
+        }
+
+        private JToken ReadSnapshotValue(BinaryReader reader, string snapshotKey)
+        {
+            JToken previous;
+            _incomingSnapshots.TryGetValue(snapshotKey, out previous);
+
+            JToken value;
+            var tag = reader.ReadByte();
+            if (tag == ArrayDeltaTag)
+            {
+                value = ReadArrayDelta(reader, GetSnapshot<JArray>(previous, snapshotKey));
+            }
+            else if (tag == ObjectDeltaTag)
+            {
+                value = ReadObjectDelta(reader, GetSnapshot<JObject>(previous, snapshotKey));
+            }
+            else
+            {
+                value = ReadToken(reader, tag);
+            }
+
+            _incomingSnapshots[snapshotKey] = value;
+            return value;
+        }
+
+        private static T GetSnapshot<T>(JToken previous, string snapshotKey) where T : JToken
+        {
+            var snapshot = previous as T;
+            if (snapshot == null)
+            {
+                throw new InvalidDataException(string.Format("Received a delta for '{0}' without a base value.", snapshotKey));
+            }
+            return snapshot;
+        }
+
+        private void WriteArrayDelta(BinaryWriter writer, JArray previous, JArray current)
+        {
+            // Index the previous strings so runs that survived can be sent as (start, length) copies
+            var previousIndex = new Dictionary<string, int>(StringComparer.Ordinal);
+            for (int i = previous.Count - 1; i >= 0; i--)
+            {
+                var value = previous[i] as JValue;
+                if (value != null && value.Type == JTokenType.String)
+                {
+                    previousIndex[(string)value.Value] = i;
+                }
+            }
+
+            var operations = new List<KeyValuePair<byte, int[]>>();
+            var position = 0;
+            while (position < current.Count)
+            {
+                int start;
+                var value = current[position] as JValue;
+                if (value != null && value.Type == JTokenType.String &&
+                    previousIndex.TryGetValue((string)value.Value, out start))
+                {
+                    var length = 1;
+                    while (position + length < current.Count &&
+                           start + length < previous.Count &&
+                           JToken.DeepEquals(current[position + length], previous[start + length]))
+                    {
+                        length++;
+                    }
+
+                    operations.Add(new KeyValuePair<byte, int[]>(CopyOperation, new[] { start, length }));
+                    position += length;
+                }
+                else if (operations.Count > 0 && operations[operations.Count - 1].Key == InsertOperation)
+                {
+                    operations[operations.Count - 1].Value[1]++;
+                    position++;
+                }
+                else
+                {
+                    operations.Add(new KeyValuePair<byte, int[]>(InsertOperation, new[] { position, 1 }));
+                    position++;
+                }
+            }
+
+            writer.Write(ArrayDeltaTag);
+            WriteCount(writer, operations.Count);
+            foreach (var operation in operations)
+            {
+                writer.Write(operation.Key);
+                if (operation.Key == CopyOperation)
+                {
+                    WriteCount(writer, operation.Value[0]);
+                    WriteCount(writer, operation.Value[1]);
+                }
+                else
+                {
+                    WriteCount(writer, operation.Value[1]);
+                    for (int i = 0; i < operation.Value[1]; i++)
+                    {
+                        WriteToken(writer, current[operation.Value[0] + i]);
+                    }
+                }
+            }
+        }
+
+        private JArray ReadArrayDelta(BinaryReader reader, JArray previous)
+        {
+            var array = new JArray();
+            var count = ReadCount(reader);
+            for (int i = 0; i < count; i++)
+            {
+                var operation = reader.ReadByte();
+                if (operation == CopyOperation)
+                {
+                    var start = ReadCount(reader);
+                    var length = ReadCount(reader);
+                    if (start + length > previous.Count)
+                    {
+                        throw new InvalidDataException("Array delta copies past the end of the base value.");
+                    }
+
+                    for (int j = 0; j < length; j++)
+                    {
+                        array.Add(previous[start + j].DeepClone());
+                    }
+                }
+                else if (operation == InsertOperation)
+                {
+                    var length = ReadCount(reader);
+                    for (int j = 0; j < length; j++)
+                    {
+                        array.Add(ReadToken(reader, reader.ReadByte()));
+                    }
+                }
+                else
+                {
+                    throw new InvalidDataException(string.Format("Unknown array delta operation {0}.", operation));
+                }
+            }
+
+            return array;
+        }
+
+        private void WriteObjectDelta(BinaryWriter writer, JObject previous, JObject current)
+        {
+            var removed = new List<string>();
+            foreach (var property in previous.Properties())
+            {
+                if (current.Property(property.Name) == null)
+                {
+                    removed.Add(property.Name);
+                }
+            }
+
+            var changed = new List<JProperty>();
+            foreach (var property in current.Properties())
+            {
+                var previousValue = previous[property.Name];
+                if (previousValue == null || !JToken.DeepEquals(previousValue, property.Value))
+                {
+                    changed.Add(property);
+                }
+            }
+
+            writer.Write(ObjectDeltaTag);
+            WriteCount(writer, removed.Count);
+            foreach (var name in removed)
+            {
+                WriteString(writer, name);
+            }
+
+            WriteCount(writer, changed.Count);
+            foreach (var property in changed)
+            {
+                WriteString(writer, property.Name);
+                WriteToken(writer, property.Value);
+            }
+        }
+
+        private JObject ReadObjectDelta(BinaryReader reader, JObject previous)
+        {
+            var obj = (JObject)previous.DeepClone();
+
+            var removedCount = ReadCount(reader);
+            for (int i = 0; i < removedCount; i++)
+            {
+                obj.Remove(ReadString(reader));
+            }
+
+            var changedCount = ReadCount(reader);
+            for (int i = 0; i < changedCount; i++)
+            {
+                var name = ReadString(reader);
+                obj[name] = ReadToken(reader, reader.ReadByte());
+            }
+
+            return obj;
+        }
+
+        private void WriteToken(BinaryWriter writer, JToken token)
+        {
+            if (token == null)
+            {
+                writer.Write(NullTag);
+                return;
+            }
+
+            switch (token.Type)
+            {
+                case JTokenType.Null:
+                case JTokenType.Undefined:
+                    writer.Write(NullTag);
+                    return;
+                case JTokenType.Object:
+                    {
+                        var obj = (JObject)token;
+                        writer.Write(ObjectTag);
+                        WriteCount(writer, obj.Count);
+                        foreach (var property in obj.Properties())
+                        {
+                            WriteString(writer, property.Name);
+                            WriteToken(writer, property.Value);
+                        }
+                    }
+                    return;
+                case JTokenType.Array:
+                    {
+                        var array = (JArray)token;
+                        writer.Write(ArrayTag);
+                        WriteCount(writer, array.Count);
+                        foreach (var item in array)
+                        {
+                            WriteToken(writer, item);
+                        }
+                    }
+                    return;
+                case JTokenType.String:
+                    writer.Write(StringTag);
+                    WriteString(writer, (string)((JValue)token).Value);
+                    return;
+                case JTokenType.Boolean:
+                    writer.Write((bool)((JValue)token).Value ? TrueTag : FalseTag);
+                    return;
+                case JTokenType.Bytes:
+                    {
+                        var bytes = (byte[])((JValue)token).Value;
+                        writer.Write(BytesTag);
+                        WriteCount(writer, bytes.Length);
+                        writer.Write(bytes);
+                    }
+                    return;
+                case JTokenType.Integer:
+                    {
+                        var value = ((JValue)token).Value;
+                        if (value is long || value is int || value is short || value is sbyte ||
+                            value is uint || value is ushort || value is byte)
+                        {
+                            writer.Write(IntegerTag);
+                            WriteInt64(writer, Convert.ToInt64(value));
+                            return;
+                        }
+                    }
+                    break;
+                case JTokenType.Float:
+                    {
+                        var value = ((JValue)token).Value;
+                        if (value is double || value is float)
+                        {
+                            writer.Write(FloatTag);
+                            writer.Write(Convert.ToDouble(value));
+                            return;
+                        }
+                    }
+                    break;
+            }
+
+            // Anything without a dedicated tag (dates, guids, big integers, decimals)
+            // round trips through its JSON text
+            writer.Write(JsonTag);
+            writer.Write(token.ToString(Formatting.None));
+        }
+
+        private JToken ReadToken(BinaryReader reader, byte tag)
+        {
+            switch (tag)
+            {
+                case NullTag:
+                    return new JValue((object)null);
+                case ObjectTag:
+                    {
+                        var obj = new JObject();
+                        var count = ReadCount(reader);
+                        for (int i = 0; i < count; i++)
+                        {
+                            var name = ReadString(reader);
+                            obj[name] = ReadToken(reader, reader.ReadByte());
+                        }
+                        return obj;
+                    }
+                case ArrayTag:
+                    {
+                        var count = ReadCount(reader);
+                        var array = new JArray();
+                        for (int i = 0; i < count; i++)
+                        {
+                            array.Add(ReadToken(reader, reader.ReadByte()));
+                        }
+                        return array;
+                    }
+                case StringTag:
+                    return new JValue(ReadString(reader));
+                case IntegerTag:
+                    return new JValue(ReadInt64(reader));
+                case FloatTag:
+                    return new JValue(reader.ReadDouble());
+                case TrueTag:
+                    return new JValue(true);
+                case FalseTag:
+                    return new JValue(false);
+                case BytesTag:
+                    return new JValue(reader.ReadBytes(ReadCount(reader)));
+                case JsonTag:
+                    return JToken.Parse(reader.ReadString());
+                default:
+                    throw new InvalidDataException(string.Format("Unknown token tag {0}.", tag));
+            }
+        }
+
+        private void WriteString(BinaryWriter writer, string value)
+        {
+            if (value == null)
+            {
+                WriteCount(writer, NullString);
+                return;
+            }
+
+            int index;
+            if (_outgoingStrings.TryGetValue(value, out index))
+            {
+                WriteCount(writer, FirstStringReference + index);
+                return;
+            }
+
+            if (value.Length <= MaxInternedStringLength && _outgoingStrings.Count < _maxInternedStrings)
+            {
+                _outgoingStrings[value] = _outgoingStrings.Count;
+                WriteCount(writer, DefineString);
+            }
+            else
+            {
+                WriteCount(writer, LiteralString);
+            }
+
+            writer.Write(value);
+        }
+
+        private string ReadString(BinaryReader reader)
+        {
+            var code = ReadCount(reader);
+            switch (code)
+            {
+                case NullString:
+                    return null;
+                case LiteralString:
+                    return reader.ReadString();
+                case DefineString:
+                    {
+                        var value = reader.ReadString();
+                        _incomingStrings.Add(value);
+                        return value;
+                    }
+            }
+
+            var index = code - FirstStringReference;
+            if (index >= _incomingStrings.Count)
+            {
+                throw new InvalidDataException(string.Format("Unknown string reference {0}.", index));
+            }
+            return _incomingStrings[index];
+        }
+
+        private static void WriteCount(BinaryWriter writer, int value)
+        {
+            WriteVarint(writer, (ulong)(uint)value);
+        }
+
+        private static int ReadCount(BinaryReader reader)
+        {
+            var value = ReadVarint(reader);
+            if (value > int.MaxValue)
+            {
+                throw new InvalidDataException("Count is out of range.");
+            }
+            return (int)value;
+        }
+
+        private static void WriteInt64(BinaryWriter writer, long value)
+        {
+            // Zig-zag so small negative numbers stay small
+            WriteVarint(writer, (ulong)((value << 1) ^ (value >> 63)));
+        }
+
+        private static long ReadInt64(BinaryReader reader)
+        {
+            var value = ReadVarint(reader);
+            return (long)(value >> 1) ^ -(long)(value & 1);
+        }
+
+        private static void WriteVarint(BinaryWriter writer, ulong value)
+        {
+            while (value >= 0x80)
+            {
+                writer.Write((byte)(value | 0x80));
+                value >>= 7;
+            }
+            writer.Write((byte)value);
+        }
+
+        private static ulong ReadVarint(BinaryReader reader)
+        {
+            ulong value = 0;
+            for (int shift = 0; shift < 64; shift += 7)
+            {
+                var b = reader.ReadByte();
+                value |= (ulong)(b & 0x7F) << shift;
+                if ((b & 0x80) == 0)
+                {
+                    return value;
+                }
+            }
+
+            throw new InvalidDataException("Malformed variable length integer.");
+        }
+    }
+}
@@ -0,0 +1,20 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+using System;
+using System.IO;
+using Microsoft.Framework.DesignTimeHost.Models;
+
+namespace Microsoft.Framework.DesignTimeHost.Protocol
+{
+    public interface IMessageSerializer
+    {
+        string Name { get; }
+
+        Message ReadMessage(BinaryReader reader);
+
+        void WriteMessage(BinaryWriter writer, Message message);
+
+        void WriteRaw(BinaryWriter writer, Action<BinaryWriter> write);
+    }
+}
@@ -0,0 +1,39 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+using System;
+using System.IO;
+using Microsoft.Framework.DesignTimeHost.Models;
+using Newtonsoft.Json;
+
+namespace Microsoft.Framework.DesignTimeHost.Protocol
+{
+    /// <summary>
+    /// The original wire format. Each message is a length prefixed JSON string, raw
+    /// frames are written as is.
+    /// </summary>
+    public class JsonMessageSerializer : IMessageSerializer
+    {
+        public const string ProtocolName = "json";
+
+        public string Name
+        {
+            get { return ProtocolName; }
+        }
+
+        public Message ReadMessage(BinaryReader reader)
+        {
+            return JsonConvert.DeserializeObject<Message>(reader.ReadString());
+        }
+
+        public void WriteMessage(BinaryWriter writer, Message message)
+        {
+            writer.Write(JsonConvert.SerializeObject(message));
+        }
+
+        public void WriteRaw(BinaryWriter writer, Action<BinaryWriter> write)
+        {
+            write(writer);
+        }
+    }
+}
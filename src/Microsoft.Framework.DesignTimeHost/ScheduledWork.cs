@@ -0,0 +1,127 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+using System;
+using System.Threading;
+
+namespace Microsoft.Framework.DesignTimeHost
+{
+    /// <summary>
+    /// A unit of work that is debounced by a <see cref="ProcessingScheduler"/>. The work never runs
+    /// concurrently with itself, signals that arrive while it runs schedule another run afterwards.
+    /// </summary>
+    public class ScheduledWork
+    {
+        private readonly ProcessingScheduler _scheduler;
+        private readonly Action _work;
+        private readonly Timer _timer;
+        private readonly object _sync = new object();
+
+        private DateTime? _firstSignal;
+        private DateTime _lastSignal;
+        private bool _immediate;
+        private bool _queued;
+        private bool _running;
+
+        internal ScheduledWork(ProcessingScheduler scheduler, Action work)
+        {
+            _scheduler = scheduler;
+            _work = work;
+            _timer = new Timer(OnTimer, null, Timeout.Infinite, Timeout.Infinite);
+        }
+
+        /// <summary>
+        /// Requests a run. Immediate signals skip the quiet period and go ahead of debounced work.
+        /// </summary>
+        public void Signal(bool immediate)
+        {
+            lock (_sync)
+            {
+                _lastSignal = DateTime.UtcNow;
+                if (_firstSignal == null)
+                {
+                    _firstSignal = _lastSignal;
+                }
+                _immediate |= immediate;
+
+                if (_running || _queued)
+                {
+                    // Picked up when the current run completes
+                    return;
+                }
+
+                Arm();
+            }
+        }
+
+        internal void Run()
+        {
+            lock (_sync)
+            {
+                _queued = false;
+                _running = true;
+                _firstSignal = null;
+                _immediate = false;
+            }
+
+            try
+            {
+                _work();
+            }
+            finally
+            {
+                lock (_sync)
+                {
+                    _running = false;
+
+                    if (_firstSignal != null)
+                    {
+                        Arm();
+                    }
+                }
+            }
+        }
+
+        private void Arm()
+        {
+            var delay = _immediate ? TimeSpan.Zero : GetDueTime() - DateTime.UtcNow;
+            _timer.Change(delay < TimeSpan.Zero ? TimeSpan.Zero : delay, Timeout.InfiniteTimeSpan);
+        }
+
+        private DateTime GetDueTime()
+        {
+            var quiet = _lastSignal + _scheduler.QuietPeriod;
+            var latest = _firstSignal.Value + _scheduler.MaxLatency;
+            return quiet < latest ? quiet : latest;
+        }
+
+        private void OnTimer(object state)
+        {
+            bool priority;
+
+            lock (_sync)
+            {
+                if (_running || _queued || _firstSignal == null)
+                {
+                    return;
+                }
+
+                if (!_immediate)
+                {
+                    // More signals may have arrived since the timer was armed
+                    var remaining = GetDueTime() - DateTime.UtcNow;
+                    if (remaining > TimeSpan.Zero)
+                    {
+                        _timer.Change(remaining, Timeout.InfiniteTimeSpan);
+                        return;
+                    }
+                }
+
+                priority = _immediate;
+                _queued = true;
+            }
+
+            _scheduler.Enqueue(this, priority);
+        }
+    }
+}
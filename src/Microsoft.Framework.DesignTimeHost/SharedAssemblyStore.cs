@@ -0,0 +1,159 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+using System;
+using System.Diagnostics;
+using System.IO;
+using System.Linq;
+using System.Security.Cryptography;
+using Microsoft.Framework.Runtime;
+
+namespace Microsoft.Framework.DesignTimeHost
+{
+    /// <summary>
+    /// Writes compiled assemblies to files named by their content hash so applications the same user runs
+    /// can load them from disk instead of receiving the bytes over the socket. A file is never changed after
+    /// it is written, an application may still have the previous image of a project loaded.
+    /// </summary>
+    public static class SharedAssemblyStore
+    {
+        // Files not used for this long are left behind by hosts that went away
+        private static readonly TimeSpan MaxAge = TimeSpan.FromDays(1);
+
+        private static readonly Lazy<string> _root = new Lazy<string>(CreateRoot);
+
+        /// <summary>
+        /// Returns the path of the assembly, the pdb is written next to it so the loader picks it up.
+        /// <paramref name="hash"/> is the SHA-256 of the assembly followed by the pdb.
+        /// </summary>
+        public static string Write(string assemblyName, byte[] assemblyBytes, byte[] pdbBytes, out string hash)
+        {
+            hash = ComputeHash(assemblyBytes, pdbBytes);
+            var directory = Path.Combine(_root.Value, hash);
+            var assemblyPath = Path.Combine(directory, assemblyName + ".dll");
+
+            if (File.Exists(assemblyPath))
+            {
+                // Written before by this or another host, the name alone doesn't prove the content
+                if (IsSameImage(directory, assemblyName, assemblyBytes, pdbBytes))
+                {
+                    Directory.SetLastWriteTimeUtc(directory, DateTime.UtcNow);
+                    return assemblyPath;
+                }
+
+                Trace.TraceInformation("[{0}]: Replacing {1}, the content doesn't match", typeof(SharedAssemblyStore).Name, directory);
+                Directory.Delete(directory, recursive: true);
+            }
+
+            // Write everything somewhere else first so a reader never sees a partial image
+            var tempDirectory = Path.Combine(_root.Value, "tmp-" + Guid.NewGuid().ToString("N"));
+            Directory.CreateDirectory(tempDirectory);
+
+            try
+            {
+                if (pdbBytes.Length > 0)
+                {
+                    File.WriteAllBytes(Path.Combine(tempDirectory, assemblyName + ".pdb"), pdbBytes);
+                }
+                File.WriteAllBytes(Path.Combine(tempDirectory, assemblyName + ".dll"), assemblyBytes);
+
+                Directory.Move(tempDirectory, directory);
+            }
+            catch (IOException)
+            {
+                // Another host stored the same image first
+                if (!IsSameImage(directory, assemblyName, assemblyBytes, pdbBytes))
+                {
+                    throw;
+                }
+            }
+            finally
+            {
+                if (Directory.Exists(tempDirectory))
+                {
+                    Directory.Delete(tempDirectory, recursive: true);
+                }
+            }
+
+            return assemblyPath;
+        }
+
+        /// <summary>
+        /// Stores a copy of an assembly built to disk and the pdb next to it, if there is one.
+        /// </summary>
+        public static string WriteFile(string assemblyName, string assemblyPath, out string hash)
+        {
+            var pdbPath = Path.ChangeExtension(assemblyPath, ".pdb");
+            var pdbBytes = File.Exists(pdbPath) ? File.ReadAllBytes(pdbPath) : new byte[0];
+
+            return Write(assemblyName, File.ReadAllBytes(assemblyPath), pdbBytes, out hash);
+        }
+
+        private static bool IsSameImage(string directory, string assemblyName, byte[] assemblyBytes, byte[] pdbBytes)
+        {
+            var pdbPath = Path.Combine(directory, assemblyName + ".pdb");
+
+            try
+            {
+                if (!File.ReadAllBytes(Path.Combine(directory, assemblyName + ".dll")).SequenceEqual(assemblyBytes))
+                {
+                    return false;
+                }
+
+                return pdbBytes.Length > 0 ?
+                    File.Exists(pdbPath) && File.ReadAllBytes(pdbPath).SequenceEqual(pdbBytes) :
+                    !File.Exists(pdbPath);
+            }
+            catch (IOException)
+            {
+                return false;
+            }
+        }
+
+        private static string CreateRoot()
+        {
+            // Per user, images in a shared location could be planted by anyone on the machine
+            var root = UserCacheDirectory.Get("designtime", inMemory: true);
+            if (root == null)
+            {
+                throw new InvalidOperationException("There is no directory for the current user to share assemblies in.");
+            }
+
+            RemoveStaleImages(root);
+
+            return root;
+        }
+
+        private static void RemoveStaleImages(string root)
+        {
+            foreach (var directory in Directory.EnumerateDirectories(root))
+            {
+                if (DateTime.UtcNow - Directory.GetLastWriteTimeUtc(directory) < MaxAge)
+                {
+                    continue;
+                }
+
+                try
+                {
+                    Directory.Delete(directory, recursive: true);
+                }
+                catch (Exception ex)
+                {
+                    // Still loaded by an application
+                    Trace.TraceInformation("[{0}]: Unable to remove {1}: {2}", typeof(SharedAssemblyStore).Name, directory, ex.Message);
+                }
+            }
+        }
+
+        private static string ComputeHash(byte[] assemblyBytes, byte[] pdbBytes)
+        {
+            using (var sha = SHA256.Create())
+            {
+                sha.TransformBlock(assemblyBytes, 0, assemblyBytes.Length, null, 0);
+                sha.TransformFinalBlock(pdbBytes, 0, pdbBytes.Length);
+
+                return BitConverter.ToString(sha.Hash).Replace("-", string.Empty).ToLowerInvariant();
+            }
+        }
+    }
+}
@@ -0,0 +1,79 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+using System.Collections.Generic;
+
+namespace Microsoft.Framework.DesignTimeHost
+{
+    /// <summary>
+    /// Keeps the versions of a message that were sent but not yet superseded by a client acknowledgement,
+    /// so the next change can be sent as a delta against the last version the client has.
+    /// </summary>
+    public class SnapshotHistory<T> where T : class
+    {
+        // Bounds the memory held for clients that stop acknowledging, they fall back to full messages
+        private const int MaxSnapshots = 8;
+
+        private readonly LinkedList<KeyValuePair<int, T>> _snapshots = new LinkedList<KeyValuePair<int, T>>();
+        private int _acknowledgedVersion;
+
+        public int Version { get; private set; }
+
+        public int Add(T snapshot)
+        {
+            Version++;
+
+            _snapshots.AddLast(new KeyValuePair<int, T>(Version, snapshot));
+            if (_snapshots.Count > MaxSnapshots)
+            {
+                _snapshots.RemoveFirst();
+            }
+
+            return Version;
+        }
+
+        public void Acknowledge(int version)
+        {
+            if (version <= _acknowledgedVersion || version > Version)
+            {
+                // Stale or bogus acknowledgement
+                return;
+            }
+
+            _acknowledgedVersion = version;
+
+            // Nothing older than the acknowledged version will be used as a baseline again
+            while (_snapshots.Count > 0 && _snapshots.First.Value.Key < version)
+            {
+                _snapshots.RemoveFirst();
+            }
+        }
+
+        /// <summary>
+        /// Returns the snapshot the client acknowledged last, or null if a full message has to be sent.
+        /// </summary>
+        public T GetAcknowledged()
+        {
+            if (_acknowledgedVersion == 0)
+            {
+                return null;
+            }
+
+            foreach (var snapshot in _snapshots)
+            {
+                if (snapshot.Key == _acknowledgedVersion)
+                {
+                    return snapshot.Value;
+                }
+            }
+
+            return null;
+        }
+
+        public void Reset()
+        {
+            _acknowledgedVersion = 0;
+            _snapshots.Clear();
+        }
+    }
+}
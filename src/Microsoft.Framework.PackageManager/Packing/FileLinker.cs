@@ -0,0 +1,290 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Runtime.InteropServices;
+
+namespace Microsoft.Framework.PackageManager.Packing
+{
+    public enum FileLinkKind
+    {
+        Reflink,
+        Hardlink,
+        Copy
+    }
+
+    /// <summary>
+    /// Puts a file into the output without duplicating its contents where the file system allows it. A reflink
+    /// shares the blocks copy-on-write (btrfs, xfs), so writes to either file never reach the other. A hardlink
+    /// is the package file itself, so it is only made for read-only package files. Anything else gets a copy.
+    /// Linked files are left as they are, their attributes belong to the packages folder.
+    /// </summary>
+    internal static class FileLinker
+    {
+        // Linux values, reflinks are only tried there
+        private const int O_WRONLY = 0x1;
+        private const int O_CREAT = 0x40;
+        private const int O_EXCL = 0x80;
+        private const int FileMode644 = 420;
+        private static readonly UIntPtr FICLONE = new UIntPtr(0x40049409);
+
+        // Errors that mean the file systems can't link at all rather than that this one file can't be linked
+        private const int EXDEV = 18;
+        private const int EINVAL = 22;
+        private const int ENOTTY = 25;
+        private const int EOPNOTSUPP = 95;
+        private const int ERROR_INVALID_FUNCTION = 1;
+        private const int ERROR_NOT_SAME_DEVICE = 17;
+        private const int ERROR_NOT_SUPPORTED = 50;
+
+        private static readonly bool _isWindows = Path.DirectorySeparatorChar == '\\';
+        private static readonly bool _isLinux = !_isWindows && Directory.Exists("/proc/self");
+
+        private static readonly Lazy<List<string>> _mountPoints = new Lazy<List<string>>(ReadMountPoints);
+
+        // By source and target volume, the packages and the output don't move to another file system half way
+        private static readonly ConcurrentDictionary<string, bool> _reflinkUnsupported = new ConcurrentDictionary<string, bool>(StringComparer.Ordinal);
+        private static readonly ConcurrentDictionary<string, bool> _hardlinkUnsupported = new ConcurrentDictionary<string, bool>(StringComparer.Ordinal);
+
+        public static FileLinkKind Link(string sourcePath, string targetPath)
+        {
+            var volumes = GetVolume(sourcePath) + "|" + GetVolume(targetPath);
+
+            if (_isLinux && !_reflinkUnsupported.ContainsKey(volumes))
+            {
+                int error;
+                if (TryReflink(sourcePath, targetPath, out error))
+                {
+                    CopyLastWriteTime(sourcePath, targetPath);
+                    return FileLinkKind.Reflink;
+                }
+
+                if (error == EXDEV || error == EOPNOTSUPP || error == EINVAL || error == ENOTTY)
+                {
+                    _reflinkUnsupported[volumes] = true;
+                }
+            }
+
+            // A hardlink is the package file itself, a restore that rewrites a writable one would change every
+            // application linked to it
+            if (!_hardlinkUnsupported.ContainsKey(volumes) && IsReadOnly(sourcePath))
+            {
+                int error;
+                if (TryHardlink(sourcePath, targetPath, out error))
+                {
+                    return FileLinkKind.Hardlink;
+                }
+
+                if (IsHardlinkUnsupported(error))
+                {
+                    _hardlinkUnsupported[volumes] = true;
+                }
+            }
+
+            Copy(sourcePath, targetPath);
+            return FileLinkKind.Copy;
+        }
+
+        /// <summary>
+        /// Makes sure the target can't change with the packages folder, otherwise it is replaced with a copy.
+        /// A reflink or copy has its own blocks and must still have the size and write time of the source. A
+        /// hardlink shares them, so it must also still be read-only: the size and write time of the two names of
+        /// one file always match and say nothing about whether it can be written.
+        /// </summary>
+        public static FileLinkKind Verify(string sourcePath, string targetPath, FileLinkKind kind)
+        {
+            var source = new FileInfo(sourcePath);
+            var target = new FileInfo(targetPath);
+
+            if (target.Exists &&
+                target.Length == source.Length &&
+                target.LastWriteTimeUtc == source.LastWriteTimeUtc &&
+                (kind != FileLinkKind.Hardlink || IsReadOnly(targetPath)))
+            {
+                return kind;
+            }
+
+            if (target.Exists)
+            {
+                // Break the link rather than write through it
+                File.Delete(targetPath);
+            }
+
+            Copy(sourcePath, targetPath);
+            return FileLinkKind.Copy;
+        }
+
+        private static void Copy(string sourcePath, string targetPath)
+        {
+            File.Copy(sourcePath, targetPath, overwrite: true);
+
+            // The source may be read-only
+            var attributes = File.GetAttributes(targetPath);
+            if ((attributes & FileAttributes.ReadOnly) == FileAttributes.ReadOnly)
+            {
+                File.SetAttributes(targetPath, attributes & ~FileAttributes.ReadOnly);
+            }
+
+            CopyLastWriteTime(sourcePath, targetPath);
+        }
+
+        private static void CopyLastWriteTime(string sourcePath, string targetPath)
+        {
+            File.SetLastWriteTimeUtc(targetPath, File.GetLastWriteTimeUtc(sourcePath));
+        }
+
+        private static bool IsReadOnly(string path)
+        {
+            return (File.GetAttributes(path) & FileAttributes.ReadOnly) == FileAttributes.ReadOnly;
+        }
+
+        private static bool IsHardlinkUnsupported(int error)
+        {
+            if (_isWindows)
+            {
+                return error == ERROR_NOT_SAME_DEVICE || error == ERROR_INVALID_FUNCTION || error == ERROR_NOT_SUPPORTED;
+            }
+
+            // Not EPERM, protected_hardlinks refuses that for read-only files of other users
+            return error == EXDEV || error == EOPNOTSUPP;
+        }
+
+        private static string GetVolume(string path)
+        {
+            var fullPath = Path.GetFullPath(path);
+            if (!_isLinux)
+            {
+                return Path.GetPathRoot(fullPath);
+            }
+
+            // The longest mount point the path is in
+            return _mountPoints.Value.FirstOrDefault(mountPoint =>
+                fullPath.StartsWith(mountPoint.TrimEnd('/') + "/", StringComparison.Ordinal)) ?? "/";
+        }
+
+        private static List<string> ReadMountPoints()
+        {
+            try
+            {
+                // <device> <mount point> <type> ..., with spaces in the mount point escaped as \040
+                return File.ReadAllLines("/proc/self/mounts")
+                           .Select(line => line.Split(' '))
+                           .Where(parts => parts.Length > 1)
+                           .Select(parts => parts[1].Replace("\\040", " "))
+                           .OrderByDescending(mountPoint => mountPoint.Length)
+                           .ToList();
+            }
+            catch (IOException)
+            {
+                return new List<string>();
+            }
+        }
+
+        private static bool TryReflink(string sourcePath, string targetPath, out int error)
+        {
+            int sourceFd = -1;
+            int targetFd = -1;
+            var cloned = false;
+            error = 0;
+
+            try
+            {
+                sourceFd = open(sourcePath, 0, 0);
+                if (sourceFd < 0)
+                {
+                    error = Marshal.GetLastWin32Error();
+                    return false;
+                }
+
+                targetFd = open(targetPath, O_WRONLY | O_CREAT | O_EXCL, FileMode644);
+                if (targetFd < 0)
+                {
+                    error = Marshal.GetLastWin32Error();
+                    return false;
+                }
+
+                cloned = ioctl(targetFd, FICLONE, sourceFd) == 0;
+                if (!cloned)
+                {
+                    error = Marshal.GetLastWin32Error();
+                }
+            }
+            catch (DllNotFoundException)
+            {
+                error = EOPNOTSUPP;
+                return false;
+            }
+            catch (EntryPointNotFoundException)
+            {
+                error = EOPNOTSUPP;
+                return false;
+            }
+            finally
+            {
+                if (sourceFd >= 0)
+                {
+                    close(sourceFd);
+                }
+                if (targetFd >= 0)
+                {
+                    close(targetFd);
+                }
+            }
+
+            if (!cloned)
+            {
+                // Left empty by a file system that can't clone
+                File.Delete(targetPath);
+            }
+
+            return cloned;
+        }
+
+        private static bool TryHardlink(string sourcePath, string targetPath, out int error)
+        {
+            error = 0;
+
+            try
+            {
+                var linked = _isWindows ?
+                    CreateHardLink(targetPath, sourcePath, IntPtr.Zero) :
+                    link(sourcePath, targetPath) == 0;
+
+                if (!linked)
+                {
+                    error = Marshal.GetLastWin32Error();
+                }
+                return linked;
+            }
+            catch (DllNotFoundException)
+            {
+                error = _isWindows ? ERROR_NOT_SUPPORTED : EOPNOTSUPP;
+                return false;
+            }
+            catch (EntryPointNotFoundException)
+            {
+                error = _isWindows ? ERROR_NOT_SUPPORTED : EOPNOTSUPP;
+                return false;
+            }
+        }
+
+        [DllImport("kernel32.dll", CharSet = CharSet.Unicode, SetLastError = true)]
+        private static extern bool CreateHardLink(string lpFileName, string lpExistingFileName, IntPtr lpSecurityAttributes);
+
+        [DllImport("libc", SetLastError = true)]
+        private static extern int link(string oldpath, string newpath);
+
+        [DllImport("libc", SetLastError = true)]
+        private static extern int open(string pathname, int flags, int mode);
+
+        [DllImport("libc", SetLastError = true)]
+        private static extern int ioctl(int fd, UIntPtr request, int arg);
+
+        [DllImport("libc", SetLastError = true)]
+        private static extern int close(int fd);
+    }
+}
@@ -8,6 +8,7 @@
 using System.Linq;
 using System.Runtime.Versioning;
 using Microsoft.Framework.Runtime;
+using Microsoft.Framework.Runtime.Loader;
 using NuGet;
 
 namespace Microsoft.Framework.PackageManager.Packing
@@ -135,6 +136,13 @@ public bool Package()
 
             string outputPath = _options.OutputDir ?? Path.Combine(_options.ProjectDir, "bin", "output");
 
+            if (_options.Incremental && !PackManifest.CanUpdate(outputPath))
+            {
+                Console.WriteLine("'{0}' wasn't written by an incremental pack, so files left in it couldn't be removed. " +
+                    "Delete it or choose another output folder for '--incremental'.", outputPath);
+                return false;
+            }
+
             var projectDir = project.ProjectDirectory;
 
             var dependencyContexts = new List<DependencyContext>();
@@ -143,7 +151,9 @@ public bool Package()
             {
                 Overwrite = _options.Overwrite,
                 Configuration = _options.Configuration,
-                NoSource = _options.NoSource
+                NoSource = _options.NoSource,
+                Incremental = _options.Incremental,
+                LinkPackages = _options.LinkPackages
             };
 
             Func<string, string> getVariable = key =>
@@ -260,6 +270,22 @@ public bool Package()
                 return false;
             }
 
+            // After native images, they change what goes on the trusted platform assembly list
+            StartupDescriptor.Write(root);
+
+            if (_options.Bundle)
+            {
+                // After native images, assemblies that have one are left out of the bundle and load from disk
+                var applicationRoot = Path.Combine(outputPath, PackRoot.AppRootName);
+                Console.WriteLine("Writing {0}", Path.Combine(applicationRoot, AppBundle.FileName));
+                AppBundle.Write(applicationRoot);
+            }
+            else
+            {
+                // Left by an earlier pack with --bundle
+                AppBundle.Delete(Path.Combine(outputPath, PackRoot.AppRootName));
+            }
+
             sw.Stop();
 
             Console.WriteLine("Time elapsed {0}", sw.Elapsed);
@@ -0,0 +1,240 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.Globalization;
+using System.IO;
+using System.Linq;
+
+namespace Microsoft.Framework.PackageManager.Packing
+{
+    /// <summary>
+    /// What a pack wrote into the output: every copied file with its size, write time and hash, and every
+    /// extracted package with the hash of its nupkg. An incremental pack compares against the manifest of
+    /// the previous one to leave unchanged files alone and to remove what is no longer part of the output.
+    /// </summary>
+    public class PackManifest
+    {
+        public static readonly string ManifestFileName = "pack.manifest";
+
+        // Bump when the format of the entries changes, older manifests are then ignored
+        private const string Header = "#pack.manifest 1";
+
+        private readonly string _outputPath;
+        private readonly string _manifestPath;
+        private readonly IDictionary<string, PackManifestEntry> _previous;
+        private readonly ConcurrentDictionary<string, PackManifestEntry> _current = new ConcurrentDictionary<string, PackManifestEntry>(StringComparer.OrdinalIgnoreCase);
+
+        private PackManifest(string outputPath, string manifestPath, IDictionary<string, PackManifestEntry> previous)
+        {
+            _outputPath = outputPath;
+            _manifestPath = manifestPath;
+            _previous = previous;
+        }
+
+        public static PackManifest Load(string outputPath)
+        {
+            outputPath = Path.GetFullPath(outputPath);
+            var manifestPath = Path.Combine(outputPath, PackRoot.AppRootName, ManifestFileName);
+            var previous = new Dictionary<string, PackManifestEntry>(StringComparer.OrdinalIgnoreCase);
+
+            if (File.Exists(manifestPath))
+            {
+                var lines = File.ReadAllLines(manifestPath);
+                if (lines.Length > 0 && string.Equals(lines[0], Header, StringComparison.Ordinal))
+                {
+                    foreach (var line in lines.Skip(1))
+                    {
+                        var entry = PackManifestEntry.Parse(line);
+                        if (entry != null)
+                        {
+                            previous[entry.RelativePath] = entry;
+                        }
+                    }
+                }
+            }
+
+            return new PackManifest(outputPath, manifestPath, previous);
+        }
+
+        /// <summary>
+        /// Returns false if <paramref name="outputPath"/> already has an application that wasn't written by an
+        /// incremental pack. There is no telling which of its files are left over, so they would never be removed.
+        /// </summary>
+        public static bool CanUpdate(string outputPath)
+        {
+            var applicationRoot = Path.Combine(Path.GetFullPath(outputPath), PackRoot.AppRootName);
+            if (!Directory.Exists(applicationRoot))
+            {
+                return true;
+            }
+
+            var manifestPath = Path.Combine(applicationRoot, ManifestFileName);
+            return File.Exists(manifestPath) &&
+                   string.Equals(File.ReadLines(manifestPath).FirstOrDefault(), Header, StringComparison.Ordinal);
+        }
+
+        /// <summary>
+        /// Returns the entry the previous pack wrote for <paramref name="targetPath"/>, or null.
+        /// </summary>
+        public PackManifestEntry GetPreviousEntry(string targetPath)
+        {
+            PackManifestEntry entry;
+            _previous.TryGetValue(GetRelativePath(targetPath), out entry);
+            return entry;
+        }
+
+        public void AddFile(string targetPath, long size, DateTime lastWriteTimeUtc, string hash)
+        {
+            var relativePath = GetRelativePath(targetPath);
+            _current[relativePath] = new PackManifestEntry(relativePath, isDirectory: false, size: size, lastWriteTimeUtcTicks: lastWriteTimeUtc.Ticks, hash: hash);
+        }
+
+        public void AddDirectory(string targetPath, string hash)
+        {
+            var relativePath = GetRelativePath(targetPath);
+            _current[relativePath] = new PackManifestEntry(relativePath, isDirectory: true, size: 0, lastWriteTimeUtcTicks: 0, hash: hash);
+        }
+
+        /// <summary>
+        /// Keeps a directory the previous pack extracted from a nupkg with the same hash.
+        /// </summary>
+        public bool TryKeepDirectory(string targetPath, string hash)
+        {
+            var previous = GetPreviousEntry(targetPath);
+            if (previous == null || !previous.IsDirectory ||
+                !string.Equals(previous.Hash, hash, StringComparison.Ordinal) ||
+                !Directory.Exists(targetPath))
+            {
+                return false;
+            }
+
+            _current[previous.RelativePath] = previous;
+            return true;
+        }
+
+        /// <summary>
+        /// Deletes what the previous pack wrote and this one didn't, then writes the manifest of this pack.
+        /// </summary>
+        public void Complete(PackOperations operations)
+        {
+            var removed = 0;
+            foreach (var entry in _previous.Values)
+            {
+                if (_current.ContainsKey(entry.RelativePath))
+                {
+                    continue;
+                }
+
+                var path = Path.Combine(_outputPath, entry.RelativePath);
+                if (entry.IsDirectory)
+                {
+                    if (Directory.Exists(path))
+                    {
+                        operations.Delete(path);
+                        Directory.Delete(path);
+                        RemoveEmptyDirectories(Path.GetDirectoryName(path));
+                    }
+                }
+                else if (File.Exists(path))
+                {
+                    File.Delete(path);
+                    RemoveEmptyDirectories(Path.GetDirectoryName(path));
+                }
+
+                removed++;
+            }
+
+            if (removed > 0)
+            {
+                Console.WriteLine("  Removed {0} files and packages left from the previous pack", removed);
+            }
+
+            Directory.CreateDirectory(Path.GetDirectoryName(_manifestPath));
+
+            var lines = new[] { Header }.Concat(_current.Values.OrderBy(entry => entry.RelativePath, StringComparer.OrdinalIgnoreCase)
+                                                              .Select(entry => entry.ToString()));
+            File.WriteAllLines(_manifestPath, lines);
+        }
+
+        private void RemoveEmptyDirectories(string directory)
+        {
+            while (directory.Length > _outputPath.Length &&
+                   directory.StartsWith(_outputPath, StringComparison.OrdinalIgnoreCase) &&
+                   !Directory.EnumerateFileSystemEntries(directory).Any())
+            {
+                Directory.Delete(directory);
+                directory = Path.GetDirectoryName(directory);
+            }
+        }
+
+        private string GetRelativePath(string targetPath)
+        {
+            var fullPath = Path.GetFullPath(targetPath);
+            if (!fullPath.StartsWith(_outputPath, StringComparison.OrdinalIgnoreCase))
+            {
+                throw new InvalidOperationException(string.Format("{0} is not in the output path {1}", fullPath, _outputPath));
+            }
+
+            return fullPath.Substring(_outputPath.Length).TrimStart(Path.DirectorySeparatorChar, Path.AltDirectorySeparatorChar);
+        }
+    }
+
+    public class PackManifestEntry
+    {
+        public PackManifestEntry(string relativePath, bool isDirectory, long size, long lastWriteTimeUtcTicks, string hash)
+        {
+            RelativePath = relativePath;
+            IsDirectory = isDirectory;
+            Size = size;
+            LastWriteTimeUtcTicks = lastWriteTimeUtcTicks;
+            Hash = hash;
+        }
+
+        public string RelativePath { get; private set; }
+
+        public bool IsDirectory { get; private set; }
+
+        public long Size { get; private set; }
+
+        /// <summary>
+        /// When the source of the file was last written. The hash is only computed again if this changed.
+        /// </summary>
+        public long LastWriteTimeUtcTicks { get; private set; }
+
+        public string Hash { get; private set; }
+
+        public static PackManifestEntry Parse(string line)
+        {
+            // <kind> <size> <ticks> <hash> <relative path>, tab separated. The path goes last since it is the
+            // only part that may contain spaces
+            var parts = line.Split(new[] { '\t' }, 5);
+            if (parts.Length != 5)
+            {
+                return null;
+            }
+
+            long size;
+            long ticks;
+            if (!long.TryParse(parts[1], NumberStyles.Integer, CultureInfo.InvariantCulture, out size) ||
+                !long.TryParse(parts[2], NumberStyles.Integer, CultureInfo.InvariantCulture, out ticks))
+            {
+                return null;
+            }
+
+            return new PackManifestEntry(parts[4], isDirectory: parts[0] == "D", size: size, lastWriteTimeUtcTicks: ticks, hash: parts[3]);
+        }
+
+        public override string ToString()
+        {
+            return string.Join("\t",
+                IsDirectory ? "D" : "F",
+                Size.ToString(CultureInfo.InvariantCulture),
+                LastWriteTimeUtcTicks.ToString(CultureInfo.InvariantCulture),
+                Hash,
+                RelativePath);
+        }
+    }
+}
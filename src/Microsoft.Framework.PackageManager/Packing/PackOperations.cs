@@ -2,15 +2,26 @@
 // Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
 
 using System;
+using System.Collections.Generic;
 using System.Diagnostics;
 using System.IO;
 using System.IO.Compression;
 using System.Linq;
+using System.Security.Cryptography;
+using System.Threading;
+using System.Threading.Tasks;
 
 namespace Microsoft.Framework.PackageManager.Packing
 {
     public class PackOperations
     {
+        private const int ExtractBufferSize = 81920;
+
+        /// <summary>
+        /// Set for an incremental pack. Files that didn't change since the previous pack are not copied again.
+        /// </summary>
+        public PackManifest Manifest { get; set; }
+
         public void Delete(string folderPath)
         {
             // Calling DeleteRecursive rather than Directory.Delete(..., recursive: true)
@@ -27,7 +38,17 @@ private void DeleteRecursive(string deletePath)
 
             foreach (var deleteFilePath in Directory.EnumerateFiles(deletePath).Select(Path.GetFileName))
             {
-                File.Delete(Path.Combine(deletePath, deleteFilePath));
+                var fullDeletePath = Path.Combine(deletePath, deleteFilePath);
+                try
+                {
+                    File.Delete(fullDeletePath);
+                }
+                catch (UnauthorizedAccessException)
+                {
+                    // Read-only files only stop the delete on Windows
+                    File.SetAttributes(fullDeletePath, File.GetAttributes(fullDeletePath) & ~FileAttributes.ReadOnly);
+                    File.Delete(fullDeletePath);
+                }
             }
 
             foreach (var deleteFolderPath in Directory.EnumerateDirectories(deletePath).Select(Path.GetFileName))
@@ -39,23 +60,173 @@ private void DeleteRecursive(string deletePath)
 
         public void Copy(string sourcePath, string targetPath)
         {
-            CopyRecursive(
-                sourcePath, 
-                targetPath, 
-                isProjectRootFolder: true, 
-                shouldInclude: (_, __) => true);
+            Copy(sourcePath, targetPath, shouldInclude: (_, __) => true);
         }
 
         public void Copy(string sourcePath, string targetPath, Func<bool, string, bool> shouldInclude)
         {
+            var files = new List<KeyValuePair<string, string>>();
+
             CopyRecursive(
                 sourcePath, 
                 targetPath, 
                 isProjectRootFolder: true,
-                shouldInclude: shouldInclude);
+                shouldInclude: shouldInclude,
+                files: files);
+
+            // The files are copied in parallel once the filter has seen all of them
+            var workerCount = Math.Min(Environment.ProcessorCount, files.Count);
+            var nextFile = -1;
+            var workers = new Task[workerCount];
+
+            for (int i = 0; i < workerCount; i++)
+            {
+                workers[i] = Task.Run(() =>
+                {
+                    var buffer = new byte[ExtractBufferSize];
+                    int index;
+                    while ((index = Interlocked.Increment(ref nextFile)) < files.Count)
+                    {
+                        CopyFile(files[index].Key, files[index].Value, buffer);
+                    }
+                });
+            }
+
+            Task.WaitAll(workers);
+        }
+
+        /// <summary>
+        /// Links every file under <paramref name="sourcePath"/> into <paramref name="targetPath"/>, see
+        /// <see cref="FileLinker"/>. Every file is verified once all of them are linked. Returns how many
+        /// files ended up as each kind of link.
+        /// </summary>
+        public IDictionary<FileLinkKind, int> Link(string sourcePath, string targetPath)
+        {
+            var sourceFiles = Directory.EnumerateFiles(sourcePath, "*", SearchOption.AllDirectories).ToList();
+            var targetFiles = new string[sourceFiles.Count];
+            var kinds = new FileLinkKind[sourceFiles.Count];
+
+            for (int i = 0; i < sourceFiles.Count; i++)
+            {
+                targetFiles[i] = Path.Combine(targetPath, sourceFiles[i].Substring(sourcePath.Length).TrimStart(Path.DirectorySeparatorChar, Path.AltDirectorySeparatorChar));
+                Directory.CreateDirectory(Path.GetDirectoryName(targetFiles[i]));
+            }
+
+            ForEachInParallel(sourceFiles.Count, i => kinds[i] = FileLinker.Link(sourceFiles[i], targetFiles[i]));
+            ForEachInParallel(sourceFiles.Count, i => kinds[i] = FileLinker.Verify(sourceFiles[i], targetFiles[i], kinds[i]));
+
+            return kinds.GroupBy(kind => kind).ToDictionary(group => group.Key, group => group.Count());
+        }
+
+        private static void ForEachInParallel(int count, Action<int> action)
+        {
+            var workerCount = Math.Min(Environment.ProcessorCount, count);
+            var next = -1;
+            var workers = new Task[workerCount];
+
+            for (int i = 0; i < workerCount; i++)
+            {
+                workers[i] = Task.Run(() =>
+                {
+                    int index;
+                    while ((index = Interlocked.Increment(ref next)) < count)
+                    {
+                        action(index);
+                    }
+                });
+            }
+
+            Task.WaitAll(workers);
+        }
+
+        public void CopyFile(string sourcePath, string targetPath)
+        {
+            CopyFile(sourcePath, targetPath, new byte[ExtractBufferSize]);
+        }
+
+        private void CopyFile(string sourcePath, string targetPath, byte[] buffer)
+        {
+            if (Manifest == null)
+            {
+                File.Copy(
+                    sourcePath,
+                    targetPath,
+                    overwrite: true);
+
+                // clear read-only bit if set
+                var fileAttributes = File.GetAttributes(targetPath);
+                if ((fileAttributes & FileAttributes.ReadOnly) == FileAttributes.ReadOnly)
+                {
+                    File.SetAttributes(targetPath, fileAttributes & ~FileAttributes.ReadOnly);
+                }
+                return;
+            }
+
+            var source = new FileInfo(sourcePath);
+            var target = new FileInfo(targetPath);
+            var previous = Manifest.GetPreviousEntry(targetPath);
+
+            if (previous != null && !previous.IsDirectory && target.Exists &&
+                previous.Size == source.Length && target.Length == source.Length)
+            {
+                // Only hash the source again when it was written since, it may have just been touched
+                var hash = previous.LastWriteTimeUtcTicks == source.LastWriteTimeUtc.Ticks ?
+                    previous.Hash :
+                    ComputeHash(sourcePath, buffer);
+
+                if (string.Equals(hash, previous.Hash, StringComparison.Ordinal))
+                {
+                    Manifest.AddFile(targetPath, source.Length, source.LastWriteTimeUtc, hash);
+                    return;
+                }
+            }
+
+            Manifest.AddFile(targetPath, source.Length, source.LastWriteTimeUtc, CopyAndHash(sourcePath, targetPath, buffer));
+        }
+
+        private static string CopyAndHash(string sourcePath, string targetPath, byte[] buffer)
+        {
+            using (var sha = SHA256.Create())
+            {
+                using (var sourceStream = new FileStream(sourcePath, FileMode.Open, FileAccess.Read, FileShare.Read, bufferSize: 1))
+                {
+                    using (var targetStream = new FileStream(targetPath, FileMode.Create, FileAccess.Write, FileShare.None, bufferSize: 1))
+                    {
+                        targetStream.SetLength(sourceStream.Length);
+
+                        int read;
+                        while ((read = sourceStream.Read(buffer, 0, buffer.Length)) > 0)
+                        {
+                            sha.TransformBlock(buffer, 0, read, null, 0);
+                            targetStream.Write(buffer, 0, read);
+                        }
+                    }
+                }
+
+                sha.TransformFinalBlock(buffer, 0, 0);
+                return BitConverter.ToString(sha.Hash).Replace("-", string.Empty).ToLowerInvariant();
+            }
+        }
+
+        private static string ComputeHash(string path, byte[] buffer)
+        {
+            using (var sha = SHA256.Create())
+            {
+                using (var stream = new FileStream(path, FileMode.Open, FileAccess.Read, FileShare.Read, bufferSize: 1))
+                {
+                    int read;
+                    while ((read = stream.Read(buffer, 0, buffer.Length)) > 0)
+                    {
+                        sha.TransformBlock(buffer, 0, read, null, 0);
+                    }
+                }
+
+                sha.TransformFinalBlock(buffer, 0, 0);
+                return BitConverter.ToString(sha.Hash).Replace("-", string.Empty).ToLowerInvariant();
+            }
         }
 
-        private void CopyRecursive(string sourcePath, string targetPath, bool isProjectRootFolder, Func<bool, string, bool> shouldInclude)
+        private void CopyRecursive(string sourcePath, string targetPath, bool isProjectRootFolder, Func<bool, string, bool> shouldInclude, IList<KeyValuePair<string, string>> files)
         {
             foreach (var sourceFilePath in Directory.EnumerateFiles(sourcePath))
             {
@@ -73,21 +244,11 @@ private void CopyRecursive(string sourcePath, string targetPath, bool isProjectR
                     Directory.CreateDirectory(targetPath);
                 }
 
-                // copy file
+                // queue file, see Copy
                 var fullSourcePath = Path.Combine(sourcePath, fileName);
                 var fullTargetPath = Path.Combine(targetPath, fileName);
 
-                File.Copy(
-                    fullSourcePath,
-                    fullTargetPath,
-                    overwrite: true);
-
-                // clear read-only bit if set
-                var fileAttributes = File.GetAttributes(fullTargetPath);
-                if ((fileAttributes & FileAttributes.ReadOnly) == FileAttributes.ReadOnly)
-                {
-                    File.SetAttributes(fullTargetPath, fileAttributes & ~FileAttributes.ReadOnly);
-                }
+                files.Add(new KeyValuePair<string, string>(fullSourcePath, fullTargetPath));
             }
 
             foreach (var sourceFolderPath in Directory.EnumerateDirectories(sourcePath))
@@ -104,7 +265,8 @@ private void CopyRecursive(string sourcePath, string targetPath, bool isProjectR
                     Path.Combine(sourcePath, folderName),
                     Path.Combine(targetPath, folderName),
                     isProjectRootFolder: false,
-                    shouldInclude: shouldInclude);
+                    shouldInclude: shouldInclude,
+                    files: files);
             }
         }
 
@@ -117,6 +279,42 @@ public void ExtractNupkg(ZipArchive archive, string targetPath)
                 shouldInclude: NupkgFilter);
         }
 
+        /// <summary>
+        /// Extracts a nupkg that is already in memory. Entries are decompressed in parallel, each worker reads
+        /// its own <see cref="ZipArchive"/> over the shared bytes since an archive can't be read concurrently.
+        /// </summary>
+        public void ExtractNupkg(byte[] nupkg, string targetPath)
+        {
+            int entryCount;
+            using (var archive = new ZipArchive(new MemoryStream(nupkg, writable: false), ZipArchiveMode.Read))
+            {
+                entryCount = archive.Entries.Count;
+            }
+
+            var workerCount = Math.Min(Environment.ProcessorCount, entryCount);
+            var nextEntry = -1;
+            var workers = new Task[workerCount];
+
+            for (int i = 0; i < workerCount; i++)
+            {
+                workers[i] = Task.Run(() =>
+                {
+                    var buffer = new byte[ExtractBufferSize];
+                    using (var archive = new ZipArchive(new MemoryStream(nupkg, writable: false), ZipArchiveMode.Read))
+                    {
+                        var entries = archive.Entries;
+                        int index;
+                        while ((index = Interlocked.Increment(ref nextEntry)) < entries.Count)
+                        {
+                            ExtractEntry(entries[index], targetPath, NupkgFilter, buffer);
+                        }
+                    }
+                });
+            }
+
+            Task.WaitAll(workers);
+        }
+
         private static bool NupkgFilter(string fullName)
         {
             var fileName = Path.GetFileName(fullName);
@@ -143,44 +341,57 @@ private static bool NupkgFilter(string fullName)
 
         public void ExtractFiles(ZipArchive archive, string targetPath, Func<string, bool> shouldInclude)
         {
+            var buffer = new byte[ExtractBufferSize];
             foreach (ZipArchiveEntry entry in archive.Entries)
             {
-                var entryFullName = entry.FullName;
-                if (entryFullName.StartsWith("/", StringComparison.Ordinal))
-                {
-                    entryFullName = entryFullName.Substring(1);
-                }
-                entryFullName = Uri.UnescapeDataString(entryFullName.Replace('/', Path.DirectorySeparatorChar));
+                ExtractEntry(entry, targetPath, shouldInclude, buffer);
+            }
+        }
 
+        private static void ExtractEntry(ZipArchiveEntry entry, string targetPath, Func<string, bool> shouldInclude, byte[] buffer)
+        {
+            var entryFullName = entry.FullName;
+            if (entryFullName.StartsWith("/", StringComparison.Ordinal))
+            {
+                entryFullName = entryFullName.Substring(1);
+            }
+            entryFullName = Uri.UnescapeDataString(entryFullName.Replace('/', Path.DirectorySeparatorChar));
 
-                var targetFile = Path.Combine(targetPath, entryFullName);
-                if (!targetFile.StartsWith(targetPath, StringComparison.OrdinalIgnoreCase))
-                {
-                    continue;
-                }
 
-                if (!shouldInclude(entryFullName))
-                {
-                    continue;
-                }
+            var targetFile = Path.Combine(targetPath, entryFullName);
+            if (!targetFile.StartsWith(targetPath, StringComparison.OrdinalIgnoreCase))
+            {
+                return;
+            }
+
+            if (!shouldInclude(entryFullName))
+            {
+                return;
+            }
 
-                if (Path.GetFileName(targetFile).Length == 0)
+            if (Path.GetFileName(targetFile).Length == 0)
+            {
+                Directory.CreateDirectory(targetFile);
+            }
+            else
+            {
+                var targetEntryPath = Path.GetDirectoryName(targetFile);
+                if (!Directory.Exists(targetEntryPath))
                 {
-                    Directory.CreateDirectory(targetFile);
+                    Directory.CreateDirectory(targetEntryPath);
                 }
-                else
+
+                using (var entryStream = entry.Open())
                 {
-                    var targetEntryPath = Path.GetDirectoryName(targetFile);
-                    if (!Directory.Exists(targetEntryPath))
+                    using (var targetStream = new FileStream(targetFile, FileMode.Create, FileAccess.Write, FileShare.None, bufferSize: 1))
                     {
-                        Directory.CreateDirectory(targetEntryPath);
-                    }
+                        // Allocate the whole file up front and write through the caller's buffer
+                        targetStream.SetLength(entry.Length);
 
-                    using (var entryStream = entry.Open())
-                    {
-                        using (var targetStream = new FileStream(targetFile, FileMode.Create, FileAccess.Write, FileShare.None))
+                        int read;
+                        while ((read = entryStream.Read(buffer, 0, buffer.Length)) > 0)
                         {
-                            entryStream.CopyTo(targetStream);
+                            targetStream.Write(buffer, 0, read);
                         }
                     }
                 }
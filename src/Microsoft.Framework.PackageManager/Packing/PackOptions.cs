@@ -27,5 +27,11 @@ public class PackOptions
         public IEnumerable<string> Runtimes { get; set; }
 
         public bool Native { get; set; }
+
+        public bool Incremental { get; set; }
+
+        public bool LinkPackages { get; set; }
+
+        public bool Bundle { get; set; }
     }
 }
\ No newline at end of file
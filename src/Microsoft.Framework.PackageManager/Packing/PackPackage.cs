@@ -3,6 +3,7 @@
 
 using System;
 using System.IO;
+using System.Linq;
 using System.IO.Compression;
 using Microsoft.Framework.Runtime;
 using System.Security.Cryptography;
@@ -37,9 +38,25 @@ public void Emit(PackRoot root)
 
             TargetPath = resolver.GetInstallPath(package.Id, package.Version);
 
+            var targetNupkgPath = resolver.GetPackageFilePath(package.Id, package.Version);
+            var hashPath = resolver.GetHashPath(package.Id, package.Version);
+
+            var manifest = root.Operations.Manifest;
+            if (manifest != null)
+            {
+                var packageHash = GetPackageHash(package, Path.Combine(_libraryDescription.Path, Path.GetFileName(hashPath)));
+
+                if (manifest.TryKeepDirectory(TargetPath, packageHash))
+                {
+                    Console.WriteLine("  {0} is up to date.", TargetPath);
+                    return;
+                }
+            }
+
             if (Directory.Exists(TargetPath))
             {
-                if (root.Overwrite)
+                // An incremental pack replaces a package that changed
+                if (root.Overwrite || manifest != null)
                 {
                     root.Operations.Delete(TargetPath);
                 }
@@ -52,8 +69,28 @@ public void Emit(PackRoot root)
 
             Console.WriteLine("  Target {0}", TargetPath);
 
-            var targetNupkgPath = resolver.GetPackageFilePath(package.Id, package.Version);
-            var hashPath = resolver.GetHashPath(package.Id, package.Version);
+            if (root.LinkPackages)
+            {
+                // The package as restore installed it has the same layout, nupkg and hash included
+                var sourcePath = _libraryDescription.Path;
+                if (File.Exists(Path.Combine(sourcePath, Path.GetFileName(targetNupkgPath))) &&
+                    File.Exists(Path.Combine(sourcePath, Path.GetFileName(hashPath))))
+                {
+                    var kinds = root.Operations.Link(sourcePath, TargetPath);
+                    Console.WriteLine("  Linked {0} files from {1}: {2}",
+                        kinds.Values.Sum(),
+                        sourcePath,
+                        string.Join(", ", kinds.Select(kind => string.Format("{0} {1}", kind.Value, kind.Key))));
+
+                    if (manifest != null)
+                    {
+                        manifest.AddDirectory(TargetPath, File.ReadAllText(hashPath));
+                    }
+                    return;
+                }
+
+                Console.WriteLine("  {0} isn't an installed package, extracting instead", sourcePath);
+            }
 
             using (var sourceStream = package.GetStream())
             {
@@ -72,6 +109,26 @@ public void Emit(PackRoot root)
                 sourceStream.Seek(0, SeekOrigin.Begin);
                 var sha512Bytes = SHA512.Create().ComputeHash(sourceStream);
                 File.WriteAllText(hashPath, Convert.ToBase64String(sha512Bytes));
+
+                if (manifest != null)
+                {
+                    manifest.AddDirectory(TargetPath, Convert.ToBase64String(sha512Bytes));
+                }
+            }
+        }
+
+        private static string GetPackageHash(IPackage package, string restoredHashPath)
+        {
+            // Restore wrote the hash next to the package it installed, hashing every nupkg again is most of the time
+            // of an incremental pack
+            if (File.Exists(restoredHashPath))
+            {
+                return File.ReadAllText(restoredHashPath);
+            }
+
+            using (var sourceStream = package.GetStream())
+            {
+                return Convert.ToBase64String(SHA512.Create().ComputeHash(sourceStream));
             }
         }
     }
@@ -7,6 +7,7 @@
 using System.IO.Compression;
 using System.Linq;
 using System.Security.Cryptography;
+using System.Text;
 using Microsoft.Framework.Runtime;
 using Newtonsoft.Json.Linq;
 using NuGet;
@@ -53,7 +54,11 @@ public void EmitSource(PackRoot root)
             Console.WriteLine("  Source {0}", project.ProjectDirectory);
             Console.WriteLine("  Target {0}", TargetPath);
 
-            root.Operations.Delete(TargetPath);
+            // An incremental pack removes the files that are gone once everything is copied
+            if (!root.Incremental)
+            {
+                root.Operations.Delete(TargetPath);
+            }
 
             // A set of excluded files/directories used as a filter when doing copy
             var excludeSet = new HashSet<string>(project.PackExcludeFiles, StringComparer.OrdinalIgnoreCase);
@@ -102,7 +107,7 @@ public void EmitSource(PackRoot root)
                     var relativeSourcePath = PathUtility.GetRelativePath(project.ProjectFilePath, sourceFile);
                     var relativeParentDir = Path.GetDirectoryName(relativeSourcePath);
                     Directory.CreateDirectory(Path.Combine(TargetPath, relativeParentDir));
-                    File.Copy(sourceFile, Path.Combine(TargetPath, relativeSourcePath));
+                    root.Operations.CopyFile(sourceFile, Path.Combine(TargetPath, relativeSourcePath));
                 }
                 else
                 {
@@ -130,7 +135,8 @@ public void EmitNupkg(PackRoot root)
             Console.WriteLine("  Source {0}", project.ProjectDirectory);
             Console.WriteLine("  Target {0}", TargetPath);
 
-            if (Directory.Exists(TargetPath))
+            // An incremental pack builds the project first to find out whether the package changed
+            if (Directory.Exists(TargetPath) && !root.Incremental)
             {
                 if (root.Overwrite)
                 {
@@ -143,6 +149,19 @@ public void EmitNupkg(PackRoot root)
                 }
             }
 
+            // The nupkg is built again every time, so whether the package changed is decided by what goes into it
+            string inputsHash = null;
+            if (root.Operations.Manifest != null)
+            {
+                inputsHash = GetInputsHash(project, root.Configuration);
+
+                if (root.Operations.Manifest.TryKeepDirectory(TargetPath, inputsHash))
+                {
+                    Console.WriteLine("  {0} is up to date.", TargetPath);
+                    return;
+                }
+            }
+
             // Generate nupkg from this project dependency
             var buildOptions = new BuildOptions();
             buildOptions.ProjectDir = project.ProjectDirectory;
@@ -159,6 +178,11 @@ public void EmitNupkg(PackRoot root)
             var targetNupkgPath = resolver.GetPackageFilePath(project.Name, project.Version);
             var hashFile = resolver.GetHashPath(project.Name, project.Version);
 
+            if (root.Operations.Manifest != null)
+            {
+                root.Operations.Delete(TargetPath);
+            }
+
             using (var sourceStream = new FileStream(srcNupkgPath, FileMode.Open, FileAccess.Read))
             {
                 using (var archive = new ZipArchive(sourceStream, ZipArchiveMode.Read))
@@ -177,6 +201,68 @@ public void EmitNupkg(PackRoot root)
                 sourceStream.Seek(0, SeekOrigin.Begin);
                 var sha512Bytes = SHA512.Create().ComputeHash(sourceStream);
                 File.WriteAllText(hashFile, Convert.ToBase64String(sha512Bytes));
+
+                if (root.Operations.Manifest != null)
+                {
+                    root.Operations.Manifest.AddDirectory(TargetPath, inputsHash);
+                }
+            }
+        }
+
+        private string GetInputsHash(Runtime.Project project, string configuration)
+        {
+            var builder = new StringBuilder();
+            builder.Append(configuration).Append('\n');
+
+            // The versions the dependencies resolved to end up in the nuspec
+            foreach (var dependency in _libraryDescription.Dependencies.OrderBy(library => library.Name, StringComparer.OrdinalIgnoreCase))
+            {
+                builder.Append(dependency.Name).Append('\t').Append(dependency.Version).Append('\n');
+            }
+
+            AppendInputs(project, builder, new HashSet<string>(StringComparer.OrdinalIgnoreCase));
+
+            using (var sha = SHA512.Create())
+            {
+                return Convert.ToBase64String(sha.ComputeHash(Encoding.UTF8.GetBytes(builder.ToString())));
+            }
+        }
+
+        private void AppendInputs(Runtime.Project project, StringBuilder builder, HashSet<string> visited)
+        {
+            if (!visited.Add(project.Name))
+            {
+                return;
+            }
+
+            builder.Append(project.Name).Append('\t').Append(project.Version).Append('\n');
+
+            // Files are compared by size and write time, the same way the copied sources are
+            var files = new[] { project.ProjectFilePath }
+                .Concat(project.SourceFiles)
+                .Concat(project.PreprocessSourceFiles)
+                .Concat(project.ResourceFiles)
+                .Concat(project.SharedFiles)
+                .Distinct(StringComparer.OrdinalIgnoreCase)
+                .OrderBy(path => path, StringComparer.OrdinalIgnoreCase);
+
+            foreach (var path in files)
+            {
+                var file = new FileInfo(path);
+                builder.Append(path).Append('\t')
+                       .Append(file.Exists ? file.Length : -1).Append('\t')
+                       .Append(file.Exists ? file.LastWriteTimeUtc.Ticks : 0).Append('\n');
+            }
+
+            // The assembly is compiled against the projects it references
+            var dependencies = project.Dependencies.Concat(project.GetTargetFrameworks().SelectMany(framework => framework.Dependencies));
+            foreach (var dependency in dependencies)
+            {
+                Runtime.Project reference;
+                if (_projectResolver.TryResolveProject(dependency.Name, out reference))
+                {
+                    AppendInputs(reference, builder, visited);
+                }
             }
         }
 
@@ -199,8 +285,12 @@ public void PostProcess(PackRoot root)
             // Default name of public app folder is the same as main project
             var wwwRootOutPath = Path.Combine(root.OutputPath, WwwRootOut);
 
-            // Delete old public app folder because we don't want leftovers from previous operations
-            root.Operations.Delete(wwwRootOutPath);
+            // Delete old public app folder because we don't want leftovers from previous operations,
+            // an incremental pack removes those itself
+            if (!root.Incremental)
+            {
+                root.Operations.Delete(wwwRootOutPath);
+            }
             Directory.CreateDirectory(wwwRootOutPath);
 
             // Copy content files (e.g. html, js and images) of main project into public app folder
@@ -33,6 +33,8 @@ public PackRoot(Runtime.Project project, string outputPath, IServiceProvider hos
 
         public bool Overwrite { get; set; }
         public bool NoSource { get; set; }
+        public bool Incremental { get; set; }
+        public bool LinkPackages { get; set; }
         public string Configuration { get; set; }
 
         public IList<PackRuntime> Runtimes { get; set; }
@@ -47,6 +49,11 @@ public void Emit()
         {
             Console.WriteLine("Copying to output path {0}", OutputPath);
 
+            if (Incremental)
+            {
+                Operations.Manifest = PackManifest.Load(OutputPath);
+            }
+
             var mainProject = Projects.Single(project => project.Name == _project.Name);
 
             foreach (var deploymentPackage in Packages)
@@ -107,6 +114,11 @@ public void Emit()
                         string.Format(template2, commandName, Path.Combine(AppRootName, "src", _project.Name)));
                 }
             }
+
+            if (Operations.Manifest != null)
+            {
+                Operations.Manifest.Complete(Operations);
+            }
         }
 
         private void WriteGlobalJson()
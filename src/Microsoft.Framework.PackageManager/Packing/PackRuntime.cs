@@ -36,7 +36,26 @@ public void Emit(PackRoot root)
         {
             Console.WriteLine("Packing runtime {0}", Name);
 
-            if (Directory.Exists(TargetPath))
+            var manifest = root.Operations.Manifest;
+            if (manifest != null)
+            {
+                string kreNupkgHash;
+                using (var sourceStream = File.OpenRead(_kreNupkgPath))
+                {
+                    kreNupkgHash = Convert.ToBase64String(SHA512.Create().ComputeHash(sourceStream));
+                }
+
+                if (manifest.TryKeepDirectory(TargetPath, kreNupkgHash))
+                {
+                    Console.WriteLine("  {0} is up to date.", TargetPath);
+                    return;
+                }
+
+                // An incremental pack replaces a runtime that changed
+                root.Operations.Delete(TargetPath);
+            }
+
+            if (Directory.Exists(TargetPath) && manifest == null)
             {
                 Console.WriteLine("  {0} already exists.", TargetPath);
                 return;
@@ -65,6 +84,11 @@ public void Emit(PackRoot root)
                 sourceStream.Seek(0, SeekOrigin.Begin);
                 var sha512Bytes = SHA512.Create().ComputeHash(sourceStream);
                 File.WriteAllText(targetNupkgPath + ".sha512", Convert.ToBase64String(sha512Bytes));
+
+                if (manifest != null)
+                {
+                    manifest.AddDirectory(TargetPath, Convert.ToBase64String(sha512Bytes));
+                }
             }
         }
     }
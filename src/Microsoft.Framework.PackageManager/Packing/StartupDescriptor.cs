@@ -0,0 +1,93 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Text;
+
+namespace Microsoft.Framework.PackageManager.Packing
+{
+    /// <summary>
+    /// What the hosts would otherwise find out by scanning directories at startup, computed once when packing.
+    /// One section per packed runtime, each line is tab separated:
+    ///
+    ///   runtime     the bin folder of the runtime, starts a section
+    ///   tpa         a candidate for the trusted platform assembly list (CoreCLR only), klr.core45 leaves out
+    ///               the assemblies it loads itself like it does when scanning the folder
+    ///   apppath     a folder the CoreCLR loader probes
+    ///   assembly    name and path of an assembly in the bin folder of the runtime
+    ///
+    /// Paths are relative to the application root with '\' separators, so the output can be moved.
+    /// </summary>
+    public static class StartupDescriptor
+    {
+        public static readonly string FileName = "klr.startup";
+
+        // Bump when the format of the lines changes, the hosts then ignore the descriptor
+        private const string Header = "#klr.startup 2";
+
+        public static void Write(PackRoot root)
+        {
+            var applicationRoot = Path.GetFullPath(Path.Combine(root.OutputPath, PackRoot.AppRootName));
+            var descriptorPath = Path.Combine(applicationRoot, FileName);
+            var lines = new List<string> { Header };
+
+            foreach (var runtime in root.Runtimes)
+            {
+                var runtimeBin = Path.Combine(runtime.TargetPath, "bin");
+
+                lines.Add(Line("runtime", GetRelativePath(applicationRoot, runtimeBin)));
+
+                if (File.Exists(Path.Combine(runtimeBin, "coreclr.dll")))
+                {
+                    // The same choice klr.core45 makes, native images if there are any
+                    var trustedAssemblies = GetTrustedPlatformAssemblies(runtimeBin, "*.ni.dll");
+                    if (!trustedAssemblies.Any())
+                    {
+                        trustedAssemblies = GetTrustedPlatformAssemblies(runtimeBin, "*.dll");
+                    }
+
+                    lines.AddRange(trustedAssemblies.Select(path => Line("tpa", GetRelativePath(applicationRoot, path))));
+                    lines.Add(Line("apppath", GetRelativePath(applicationRoot, runtimeBin)));
+                }
+
+                // Only what the host would probe the runtime folder for, packages are resolved after startup
+                foreach (var path in GetAssemblies(runtimeBin))
+                {
+                    lines.Add(Line("assembly", Path.GetFileNameWithoutExtension(path), GetRelativePath(applicationRoot, path)));
+                }
+            }
+
+            File.WriteAllLines(descriptorPath, lines, new UTF8Encoding(encoderShouldEmitUTF8Identifier: false));
+        }
+
+        private static IEnumerable<string> GetTrustedPlatformAssemblies(string runtimeBin, string pattern)
+        {
+            return Directory.EnumerateFiles(runtimeBin, pattern)
+                            .OrderBy(path => path, StringComparer.OrdinalIgnoreCase)
+                            .ToList();
+        }
+
+        private static IEnumerable<string> GetAssemblies(string runtimeBin)
+        {
+            return Directory.EnumerateFiles(runtimeBin, "*.dll")
+                            .Where(path => !path.EndsWith(".ni.dll", StringComparison.OrdinalIgnoreCase))
+                            .OrderBy(path => path, StringComparer.OrdinalIgnoreCase)
+                            .ToList();
+        }
+
+        private static string GetRelativePath(string applicationRoot, string path)
+        {
+            return Path.GetFullPath(path).Substring(applicationRoot.Length)
+                                         .TrimStart(Path.DirectorySeparatorChar, Path.AltDirectorySeparatorChar)
+                                         .Replace(Path.DirectorySeparatorChar, '\\');
+        }
+
+        private static string Line(params string[] parts)
+        {
+            return string.Join("\t", parts);
+        }
+    }
+}
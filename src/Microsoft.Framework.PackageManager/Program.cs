@@ -64,6 +64,8 @@ public int Main(string[] args)
                 var optPackageFolder = c.Option("--packages", "Path to restore packages", CommandOptionType.SingleValue);
                 var optQuiet = c.Option("--quiet", "Do not show output such as HTTP request/cache information",
                     CommandOptionType.NoValue);
+                var optParallel = c.Option("--parallel <COUNT>", "Maximum number of concurrent requests to each package source",
+                    CommandOptionType.SingleValue);
                 c.HelpOption("-?|-h|--help");
 
                 c.OnExecute(async () =>
@@ -77,6 +79,20 @@ public int Main(string[] args)
                     command.NoCache = optNoCache.HasValue();
                     command.PackageFolder = optPackageFolder.Value();
 
+                    if (optParallel.HasValue())
+                    {
+                        int maxConcurrentRequests;
+                        if (!int.TryParse(optParallel.Value(), out maxConcurrentRequests) || maxConcurrentRequests < 1)
+                        {
+                            command.Reports.Information.WriteLine(string.Format(
+                                "Error: unexpected value '{0}' for option '{1}', expected a positive number".Red().Bold(),
+                                optParallel.Value(), optParallel.LongName));
+                            return 1;
+                        }
+
+                        command.MaxConcurrentRequests = maxConcurrentRequests;
+                    }
+
                     if (optProxy.HasValue())
                     {
                         Environment.SetEnvironmentVariable("http_proxy", optProxy.Value());
@@ -103,6 +119,12 @@ public int Main(string[] args)
                     CommandOptionType.MultipleValue);
                 var optionNative = c.Option("--native", "Build and include native images. User must provide targeted CoreCLR runtime versions along with this option.",
                     CommandOptionType.NoValue);
+                var optionIncremental = c.Option("--incremental", "Only copy what changed since the previous pack to the same output and remove what it no longer contains",
+                    CommandOptionType.NoValue);
+                var optionLinkPackages = c.Option("--link-packages", "Link package files into the output instead of copying them where the file system allows it",
+                    CommandOptionType.NoValue);
+                var optionBundle = c.Option("--bundle", "Also write the application root into a single file the packages are loaded from",
+                    CommandOptionType.NoValue);
                 var optionWwwRoot = c.Option("--wwwroot <NAME>", "Name of public folder in the project directory",
                     CommandOptionType.SingleValue);
                 var optionWwwRootOut = c.Option("--wwwroot-out <NAME>",
@@ -131,7 +153,10 @@ public int Main(string[] args)
                             string.Join(";", optionRuntime.Values).
                                 Split(new[] { ';' }, StringSplitOptions.RemoveEmptyEntries) :
                             new string[0],
-                        Native = optionNative.HasValue()
+                        Native = optionNative.HasValue(),
+                        Incremental = optionIncremental.HasValue(),
+                        LinkPackages = optionLinkPackages.HasValue(),
+                        Bundle = optionBundle.HasValue()
                     };
 
                     var manager = new PackManager(_hostServices, options);
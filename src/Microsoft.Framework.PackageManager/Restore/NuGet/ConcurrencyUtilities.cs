@@ -2,42 +2,185 @@
 // Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
 
 using System;
+using System.Collections.Generic;
 using System.IO;
+using System.Security.Cryptography;
+using System.Text;
 using System.Threading;
 using System.Threading.Tasks;
+using Microsoft.Framework.Runtime;
 
 namespace Microsoft.Framework.PackageManager
 {
     internal static class ConcurrencyUtilities
     {
+        private static readonly TimeSpan MaxLockRetryDelay = TimeSpan.FromMilliseconds(200);
+
+        // A process that hangs while holding a lock shouldn't hang every restore after it
+        private static readonly TimeSpan LockTimeout = TimeSpan.FromMinutes(10);
+
+        // In-process locks by file path. Entries are removed when nobody holds or waits on them so
+        // a restore doesn't keep one lock per file it ever touched.
+        private static readonly Dictionary<string, ProcessLock> _processLocks = new Dictionary<string, ProcessLock>(StringComparer.Ordinal);
+
         internal static string FilePathToLockName(string filePath)
         {
-            // If we use a file path directly as the name of a semaphore,
-            // the ctor of semaphore looks for the file and throws an IOException
-            // when the file doesn't exist. So we need a conversion from a file path
-            // to a unique lock name.
-            return filePath.Replace(Path.DirectorySeparatorChar, '_');
+            // The lock files for all paths live in one folder, so they are named after a hash of the full path
+            var fullPath = Path.GetFullPath(filePath);
+            if (Path.DirectorySeparatorChar == '\\')
+            {
+                fullPath = fullPath.ToUpperInvariant();
+            }
+
+            using (var sha = SHA1.Create())
+            {
+                var hash = sha.ComputeHash(Encoding.UTF8.GetBytes(fullPath));
+                return BitConverter.ToString(hash).Replace("-", string.Empty) + ".lock";
+            }
         }
 
+        /// <summary>
+        /// Runs <paramref name="action"/> while holding an exclusive lock on <paramref name="filePath"/> for this
+        /// process and for other processes. The action is told whether the lock was free when it was requested,
+        /// i.e. nobody else was working on the file. Throws a <see cref="TimeoutException"/> if the lock isn't
+        /// acquired within ten minutes.
+        /// </summary>
         internal async static Task<T> ExecuteWithFileLocked<T>(string filePath, Func<bool, Task<T>> action)
         {
-            var createdNew = false;
-            var fileLock = new Semaphore(initialCount: 0, maximumCount: 1, name: FilePathToLockName(filePath),
-                createdNew: out createdNew);
+            var lockName = FilePathToLockName(filePath);
+            var lockPath = GetLockPath(lockName);
+            var deadline = DateTime.UtcNow + LockTimeout;
+            var processLock = AcquireProcessLock(lockName);
             try
             {
-                // If this lock is already acquired by another process, wait until we can acquire it
-                if (!createdNew)
+                // If this lock is already acquired by another thread, wait until we can acquire it
+                var createdNew = processLock.Semaphore.Wait(0);
+                if (!createdNew && !await processLock.Semaphore.WaitAsync(LockTimeout))
                 {
-                    fileLock.WaitOne();
+                    throw CreateTimeoutException(filePath, lockPath);
                 }
 
-                return await action(createdNew);
+                try
+                {
+                    var retryDelay = TimeSpan.FromMilliseconds(10);
+                    while (true)
+                    {
+                        var lockFile = TryLockFile(lockPath);
+                        if (lockFile != null)
+                        {
+                            using (lockFile)
+                            {
+                                return await action(createdNew);
+                            }
+                        }
+
+                        if (DateTime.UtcNow > deadline)
+                        {
+                            throw CreateTimeoutException(filePath, lockPath);
+                        }
+
+                        // If this lock is already acquired by another process, wait until we can acquire it
+                        createdNew = false;
+                        await Task.Delay(retryDelay);
+                        retryDelay = TimeSpan.FromTicks(Math.Min(retryDelay.Ticks * 2, MaxLockRetryDelay.Ticks));
+                    }
+                }
+                finally
+                {
+                    processLock.Semaphore.Release();
+                }
             }
             finally
             {
-                fileLock.Release();
+                ReleaseProcessLock(lockName, processLock);
             }
         }
+
+        private static FileStream TryLockFile(string lockPath)
+        {
+            FileStream lockFile = null;
+            try
+            {
+                // Opening without sharing is enforced across processes by share modes on Windows and by
+                // flock on CoreCLR. Mono only checks share modes within the process, so the file is also
+                // locked with fcntl (LockFile on Windows).
+                lockFile = new FileStream(lockPath, FileMode.OpenOrCreate, FileAccess.ReadWrite, FileShare.None);
+#if NET45
+                lockFile.Lock(0, 1);
+#endif
+                return lockFile;
+            }
+            catch (IOException)
+            {
+            }
+            catch (UnauthorizedAccessException)
+            {
+                // Windows reports a lock file another process is still closing as access denied
+            }
+
+            if (lockFile != null)
+            {
+                lockFile.Dispose();
+            }
+            return null;
+        }
+
+        private static string GetLockPath(string lockName)
+        {
+            // Lock files are left behind, removing one another process has open would let two processes
+            // lock different files for the same path. They are per user so nobody else can hold them.
+            var lockDirectory = UserCacheDirectory.Get(Path.Combine("kpm", "locks"));
+            if (lockDirectory == null)
+            {
+                // No profile, use the temp folder so the lock files don't pile up next to the packages
+                return Path.Combine(Path.GetTempPath(), "kpm-" + lockName);
+            }
+
+            return Path.Combine(lockDirectory, lockName);
+        }
+
+        private static TimeoutException CreateTimeoutException(string filePath, string lockPath)
+        {
+            return new TimeoutException(string.Format("Timed out waiting for the lock on '{0}' ({1}).", filePath, lockPath));
+        }
+
+        private static ProcessLock AcquireProcessLock(string lockName)
+        {
+            lock (_processLocks)
+            {
+                ProcessLock processLock;
+                if (!_processLocks.TryGetValue(lockName, out processLock))
+                {
+                    processLock = new ProcessLock();
+                    _processLocks[lockName] = processLock;
+                }
+                processLock.References++;
+                return processLock;
+            }
+        }
+
+        private static void ReleaseProcessLock(string lockName, ProcessLock processLock)
+        {
+            lock (_processLocks)
+            {
+                if (--processLock.References == 0)
+                {
+                    _processLocks.Remove(lockName);
+                    processLock.Semaphore.Dispose();
+                }
+            }
+        }
+
+        private class ProcessLock
+        {
+            public ProcessLock()
+            {
+                Semaphore = new SemaphoreSlim(1, 1);
+            }
+
+            public SemaphoreSlim Semaphore { get; private set; }
+
+            public int References { get; set; }
+        }
     }
 }
\ No newline at end of file
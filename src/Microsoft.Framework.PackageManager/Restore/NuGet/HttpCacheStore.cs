@@ -0,0 +1,477 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Security.Cryptography;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace Microsoft.Framework.PackageManager.Restore.NuGet
+{
+    /// <summary>
+    /// The HTTP cache of a user. Response bodies are stored once per content hash and never change after
+    /// they are written, so they can be read without locking. An append-only index log maps each URI to its
+    /// current body, ETag and fetch time; processes read the records appended by others when they miss.
+    /// The first time a process uses the store the log is rewritten with only the live entries and the
+    /// bodies nothing refers to anymore are deleted.
+    /// </summary>
+    internal class HttpCacheStore
+    {
+        private const string IndexFileName = "index.log";
+        private const int CopyBufferSize = 81920;
+        private const int MaxReplaceAttempts = 5;
+
+        // Bump when the records change, a log with another header is started over
+        private const string IndexFormat = "kpm-http-index 1\n";
+
+        // Entries not fetched again for this long are dropped when the log is rewritten
+        private static readonly TimeSpan MaxEntryAge = TimeSpan.FromDays(30);
+
+        // A body this young may belong to a record another process is about to append
+        private static readonly TimeSpan MinUnreferencedBlobAge = TimeSpan.FromHours(1);
+
+        private static readonly TimeSpan ReplaceRetryDelay = TimeSpan.FromMilliseconds(100);
+
+        private static readonly byte[] _indexFormatBytes = Encoding.UTF8.GetBytes(IndexFormat);
+        private static readonly int _headerLength = _indexFormatBytes.Length + 16;
+
+        private static readonly ConcurrentDictionary<string, HttpCacheStore> _stores = new ConcurrentDictionary<string, HttpCacheStore>(StringComparer.OrdinalIgnoreCase);
+
+        private readonly string _blobsFolder;
+        private readonly string _indexPath;
+        private readonly Dictionary<string, HttpCacheEntry> _entries = new Dictionary<string, HttpCacheEntry>(StringComparer.Ordinal);
+        private readonly object _entriesLock = new object();
+        private readonly Lazy<Task> _compaction;
+
+        // The log _entries were read from, it gets a new one each time it is rewritten
+        private Guid _generation;
+
+        // How much of the index log has been read into _entries
+        private long _indexOffset;
+
+        // Records read that a later record of the same URI replaced
+        private int _replacedRecords;
+
+        private HttpCacheStore(string root)
+        {
+            _blobsFolder = Path.Combine(root, "blobs");
+            _indexPath = Path.Combine(root, IndexFileName);
+            _compaction = new Lazy<Task>(CompactAsync);
+            Directory.CreateDirectory(_blobsFolder);
+        }
+
+        public static HttpCacheStore GetStore(string root)
+        {
+            return _stores.GetOrAdd(Path.GetFullPath(root), path => new HttpCacheStore(path));
+        }
+
+        /// <summary>
+        /// Returns the latest entry for <paramref name="uri"/> whose body is still on disk, or null.
+        /// </summary>
+        public async Task<HttpCacheEntry> FindAsync(string uri, TimeSpan maxAge)
+        {
+            await _compaction.Value;
+
+            lock (_entriesLock)
+            {
+                var entry = FindEntry(uri);
+                if (entry == null || entry.Age >= maxAge)
+                {
+                    // Another process may have fetched it since we last looked
+                    ReadIndex();
+                    entry = FindEntry(uri);
+                }
+                return entry;
+            }
+        }
+
+        /// <summary>
+        /// Stores <paramref name="content"/> as a blob named by its hash. Identical bodies are only kept once.
+        /// </summary>
+        public async Task<string> AddBlobAsync(Stream content)
+        {
+            var tempPath = Path.Combine(_blobsFolder, "tmp-" + Guid.NewGuid().ToString("N"));
+            string hash;
+
+            using (var sha = SHA256.Create())
+            {
+                using (var stream = new FileStream(tempPath, FileMode.Create, FileAccess.Write, FileShare.None))
+                {
+                    var buffer = new byte[CopyBufferSize];
+                    int read;
+                    while ((read = await content.ReadAsync(buffer, 0, buffer.Length)) > 0)
+                    {
+                        sha.TransformBlock(buffer, 0, read, buffer, 0);
+                        await stream.WriteAsync(buffer, 0, read);
+                    }
+                }
+
+                sha.TransformFinalBlock(new byte[0], 0, 0);
+                hash = BitConverter.ToString(sha.Hash).Replace("-", string.Empty).ToLowerInvariant();
+            }
+
+            var blobPath = GetBlobPath(hash);
+            Directory.CreateDirectory(Path.GetDirectoryName(blobPath));
+
+            try
+            {
+                if (!File.Exists(blobPath))
+                {
+                    File.Move(tempPath, blobPath);
+                }
+                else
+                {
+                    // Referenced again, keep it from looking unreferenced while the record is appended
+                    File.SetLastWriteTimeUtc(blobPath, DateTime.UtcNow);
+                }
+            }
+            catch (IOException)
+            {
+                // Someone else stored the same body first
+            }
+
+            if (File.Exists(tempPath))
+            {
+                File.Delete(tempPath);
+            }
+
+            return hash;
+        }
+
+        public async Task<HttpCacheEntry> AddEntryAsync(string uri, string hash, string etag)
+        {
+            var entry = new HttpCacheEntry(uri, GetBlobPath(hash), hash, etag, DateTime.UtcNow);
+            var record = CreateRecord(entry);
+
+            await ConcurrencyUtilities.ExecuteWithFileLocked(_indexPath, async _ =>
+            {
+                using (var stream = new FileStream(_indexPath, FileMode.Append, FileAccess.Write, FileShare.ReadWrite | FileShare.Delete))
+                {
+                    if (stream.Length == 0)
+                    {
+                        var header = CreateHeader(Guid.NewGuid());
+                        await stream.WriteAsync(header, 0, header.Length);
+                    }
+
+                    await stream.WriteAsync(record, 0, record.Length);
+                }
+                return 0;
+            });
+
+            lock (_entriesLock)
+            {
+                SetEntry(entry);
+            }
+
+            return entry;
+        }
+
+        private HttpCacheEntry FindEntry(string uri)
+        {
+            HttpCacheEntry entry;
+            if (_entries.TryGetValue(uri, out entry) && File.Exists(entry.BlobPath))
+            {
+                return entry;
+            }
+            return null;
+        }
+
+        private void SetEntry(HttpCacheEntry entry)
+        {
+            // Records of several processes interleave in the log, the most recent fetch wins
+            HttpCacheEntry existing;
+            if (!_entries.TryGetValue(entry.Uri, out existing) || existing.Timestamp <= entry.Timestamp)
+            {
+                _entries[entry.Uri] = entry;
+            }
+        }
+
+        private async Task CompactAsync()
+        {
+            try
+            {
+                // Locked like an append so no record gets lost while the log is replaced
+                await ConcurrencyUtilities.ExecuteWithFileLocked(_indexPath, _ => Task.FromResult(Compact()));
+            }
+            catch (Exception ex)
+            {
+                // The cache works without it, the log is rewritten by the next process
+                if (!(ex is IOException || ex is UnauthorizedAccessException || ex is TimeoutException))
+                {
+                    throw;
+                }
+            }
+        }
+
+        private bool Compact()
+        {
+            List<HttpCacheEntry> liveEntries;
+            lock (_entriesLock)
+            {
+                ReadIndex();
+
+                liveEntries = _entries.Values.Where(entry => entry.Age < MaxEntryAge && File.Exists(entry.BlobPath))
+                                             .ToList();
+
+                if (_generation != Guid.Empty && _replacedRecords == 0 && liveEntries.Count == _entries.Count)
+                {
+                    // Nothing to drop
+                    return false;
+                }
+            }
+
+            var generation = Guid.NewGuid();
+            var tempPath = _indexPath + "." + generation.ToString("N");
+
+            try
+            {
+                using (var stream = new FileStream(tempPath, FileMode.CreateNew, FileAccess.Write, FileShare.None))
+                {
+                    var header = CreateHeader(generation);
+                    stream.Write(header, 0, header.Length);
+
+                    foreach (var entry in liveEntries)
+                    {
+                        var record = CreateRecord(entry);
+                        stream.Write(record, 0, record.Length);
+                    }
+                }
+
+                ReplaceIndex(tempPath);
+            }
+            finally
+            {
+                if (File.Exists(tempPath))
+                {
+                    File.Delete(tempPath);
+                }
+            }
+
+            lock (_entriesLock)
+            {
+                _entries.Clear();
+                foreach (var entry in liveEntries)
+                {
+                    SetEntry(entry);
+                }
+
+                _generation = generation;
+                _indexOffset = new FileInfo(_indexPath).Length;
+                _replacedRecords = 0;
+            }
+
+            RemoveUnreferencedBlobs(new HashSet<string>(liveEntries.Select(entry => entry.BlobPath), StringComparer.Ordinal));
+            return true;
+        }
+
+        private void ReplaceIndex(string tempPath)
+        {
+            // Readers that have the old log open keep reading it, they see the new header when they open it again
+            for (int attempt = 1; ; attempt++)
+            {
+                try
+                {
+                    if (!File.Exists(_indexPath))
+                    {
+                        File.Move(tempPath, _indexPath);
+                    }
+                    else
+                    {
+#if NET45
+                        // Swaps the name over in one step, so readers always find a log
+                        File.Replace(tempPath, _indexPath, destinationBackupFileName: null);
+#else
+                        // No File.Replace here, a reader that finds no log in between reads it the next time it misses
+                        File.Delete(_indexPath);
+                        File.Move(tempPath, _indexPath);
+#endif
+                    }
+                    return;
+                }
+                catch (IOException)
+                {
+                    // On Windows a log deleted while a reader has it open keeps its name until the reader closes it
+                    if (attempt == MaxReplaceAttempts)
+                    {
+                        throw;
+                    }
+                }
+
+                Thread.Sleep(ReplaceRetryDelay);
+            }
+        }
+
+        private void RemoveUnreferencedBlobs(ISet<string> referencedBlobs)
+        {
+            foreach (var path in Directory.EnumerateFiles(_blobsFolder, "*", SearchOption.AllDirectories))
+            {
+                if (referencedBlobs.Contains(path) ||
+                    DateTime.UtcNow - File.GetLastWriteTimeUtc(path) < MinUnreferencedBlobAge)
+                {
+                    continue;
+                }
+
+                try
+                {
+                    File.Delete(path);
+                }
+                catch (IOException)
+                {
+                    // Being read
+                }
+                catch (UnauthorizedAccessException)
+                {
+                }
+            }
+        }
+
+        private void ReadIndex()
+        {
+            if (!File.Exists(_indexPath))
+            {
+                return;
+            }
+
+            using (var stream = new FileStream(_indexPath, FileMode.Open, FileAccess.Read, FileShare.ReadWrite | FileShare.Delete))
+            {
+                Guid generation;
+                if (!TryReadHeader(stream, out generation))
+                {
+                    // Still being created, or written by another version
+                    return;
+                }
+
+                if (generation != _generation)
+                {
+                    // Rewritten or started over since it was last read, offsets into the old log mean nothing
+                    _entries.Clear();
+                    _generation = generation;
+                    _indexOffset = _headerLength;
+                    _replacedRecords = 0;
+                }
+
+                stream.Position = _indexOffset;
+                var reader = new BinaryReader(stream);
+
+                while (stream.Length - stream.Position >= sizeof(int))
+                {
+                    var length = reader.ReadInt32();
+                    if (length <= 0 || stream.Length - stream.Position < length)
+                    {
+                        break;
+                    }
+
+                    var recordEnd = stream.Position + length;
+                    var uri = reader.ReadString();
+                    var hash = reader.ReadString();
+                    var etag = reader.ReadString();
+                    var timestamp = new DateTime(reader.ReadInt64(), DateTimeKind.Utc);
+
+                    if (_entries.ContainsKey(uri))
+                    {
+                        _replacedRecords++;
+                    }
+
+                    SetEntry(new HttpCacheEntry(uri, GetBlobPath(hash), hash, etag.Length == 0 ? null : etag, timestamp));
+
+                    stream.Position = recordEnd;
+                    _indexOffset = recordEnd;
+                }
+            }
+        }
+
+        private static bool TryReadHeader(Stream stream, out Guid generation)
+        {
+            generation = Guid.Empty;
+
+            var header = new byte[_headerLength];
+            var read = 0;
+            int count;
+            while (read < header.Length && (count = stream.Read(header, read, header.Length - read)) > 0)
+            {
+                read += count;
+            }
+
+            if (read < header.Length)
+            {
+                return false;
+            }
+
+            for (int i = 0; i < _indexFormatBytes.Length; i++)
+            {
+                if (header[i] != _indexFormatBytes[i])
+                {
+                    return false;
+                }
+            }
+
+            var generationBytes = new byte[16];
+            Array.Copy(header, _indexFormatBytes.Length, generationBytes, 0, generationBytes.Length);
+            generation = new Guid(generationBytes);
+            return true;
+        }
+
+        private static byte[] CreateHeader(Guid generation)
+        {
+            return _indexFormatBytes.Concat(generation.ToByteArray()).ToArray();
+        }
+
+        private static byte[] CreateRecord(HttpCacheEntry entry)
+        {
+            using (var memoryStream = new MemoryStream())
+            {
+                using (var writer = new BinaryWriter(memoryStream))
+                {
+                    // The length prefix lets readers skip a record that is still being written
+                    writer.Write(0);
+                    writer.Write(entry.Uri);
+                    writer.Write(entry.Hash);
+                    writer.Write(entry.ETag ?? string.Empty);
+                    writer.Write(entry.Timestamp.Ticks);
+                    writer.Flush();
+
+                    memoryStream.Position = 0;
+                    writer.Write((int)memoryStream.Length - sizeof(int));
+                }
+                return memoryStream.ToArray();
+            }
+        }
+
+        private string GetBlobPath(string hash)
+        {
+            return Path.Combine(_blobsFolder, hash.Substring(0, 2), hash);
+        }
+    }
+
+    internal class HttpCacheEntry
+    {
+        public HttpCacheEntry(string uri, string blobPath, string hash, string etag, DateTime timestamp)
+        {
+            Uri = uri;
+            BlobPath = blobPath;
+            Hash = hash;
+            ETag = etag;
+            Timestamp = timestamp;
+        }
+
+        public string Uri { get; private set; }
+
+        public string BlobPath { get; private set; }
+
+        public string Hash { get; private set; }
+
+        public string ETag { get; private set; }
+
+        public DateTime Timestamp { get; private set; }
+
+        public TimeSpan Age
+        {
+            get { return DateTime.UtcNow - Timestamp; }
+        }
+    }
+}
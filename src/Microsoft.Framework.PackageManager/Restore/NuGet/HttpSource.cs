@@ -11,8 +11,6 @@
 using System.Text;
 using System.Threading;
 using System.Threading.Tasks;
-using System.Linq;
-using System.Security.Cryptography;
 
 namespace Microsoft.Framework.PackageManager.Restore.NuGet
 {
@@ -89,16 +87,20 @@ internal class HttpSource
             }
         }
 
-        internal async Task<HttpSourceResult> GetAsync(string uri, string cacheKey, TimeSpan cacheAgeLimit)
+        internal async Task<HttpSourceResult> GetAsync(string uri, TimeSpan cacheAgeLimit)
         {
             Stopwatch sw = new Stopwatch();
             sw.Start();
 
-            var result = await TryCache(uri, cacheKey, cacheAgeLimit);
-            if (result.Stream != null)
+            // Zero value of TTL means we always download the latest package
+            // So we neither read from nor write to the cache
+            var store = cacheAgeLimit.Equals(TimeSpan.Zero) ? null : GetCacheStore();
+            var entry = store == null ? null : await store.FindAsync(uri, cacheAgeLimit);
+
+            if (entry != null && entry.Age < cacheAgeLimit)
             {
                 _report.WriteLine(string.Format("  {0} {1}", "CACHE".Green(), uri));
-                return result;
+                return OpenCacheEntry(entry);
             }
 
             _report.WriteLine(string.Format("  {0} {1}.", "GET".Yellow(), uri));
@@ -118,25 +120,37 @@ internal async Task<HttpSourceResult> GetAsync(string uri, string cacheKey, Time
             }
 #endif
 
-            var response = await _client.SendAsync(request);
+            // A stale entry is still good if the server says the content didn't change
+            if (entry != null && entry.ETag != null)
+            {
+                request.Headers.IfNoneMatch.Add(EntityTagHeaderValue.Parse(entry.ETag));
+            }
 
-            var newFile = result.CacheFileName + "-new";
+            var response = await _client.SendAsync(request);
+            HttpSourceResult result;
 
-            // Zero value of TTL means we always download the latest package
-            // So we write to a temp file instead of cache
-            if (cacheAgeLimit.Equals(TimeSpan.Zero))
+            if (entry != null && response.StatusCode == HttpStatusCode.NotModified)
             {
-                result.CacheFileName = Path.GetTempFileName();
-                newFile = Path.GetTempFileName();
+                result = OpenCacheEntry(await store.AddEntryAsync(uri, entry.Hash, entry.ETag));
             }
-
-            // The update of a cached file is divided into two steps:
-            // 1) Delete the old file. 2) Create a new file with the same name.
-            // To prevent race condition among multiple processes, here we use a lock to make the update atomic.
-            await ConcurrencyUtilities.ExecuteWithFileLocked(result.CacheFileName, async _ =>
+            else if (store != null)
             {
+                var etag = response.Headers.ETag == null ? null : response.Headers.ETag.ToString();
+                using (var content = await response.Content.ReadAsStreamAsync())
+                {
+                    var hash = await store.AddBlobAsync(content);
+                    result = OpenCacheEntry(await store.AddEntryAsync(uri, hash, etag));
+                }
+            }
+            else
+            {
+                result = new HttpSourceResult
+                {
+                    CacheFileName = Path.GetTempFileName()
+                };
+
                 using (var stream = CreateAsyncFileStream(
-                    newFile,
+                    result.CacheFileName,
                     FileMode.Create,
                     FileAccess.ReadWrite,
                     FileShare.ReadWrite | FileShare.Delete))
@@ -145,136 +159,40 @@ internal async Task<HttpSourceResult> GetAsync(string uri, string cacheKey, Time
                     await stream.FlushAsync();
                 }
 
-                if (File.Exists(result.CacheFileName))
-                {
-                    // Process B can perform deletion on an opened file if the file is opened by process A
-                    // with FileShare.Delete flag. However, the file won't be actually deleted until A close it.
-                    // This special feature can cause race condition, so we never delete an opened file.
-                    if (!IsFileAlreadyOpen(result.CacheFileName))
-                    {
-                        File.Delete(result.CacheFileName);
-                    }
-                }
-
-                // If the desitnation file doesn't exist, we can safely perform moving operation.
-                // Otherwise, moving operation will fail.
-                if (!File.Exists(result.CacheFileName))
-                {
-                    File.Move(
-                        newFile,
-                        result.CacheFileName);
-                }
-
-                // Even the file deletion operation above succeeds but the file is not actually deleted,
-                // we can still safely read it because it means that some other process just updated it
-                // and we don't need to update it with the same content again.
                 result.Stream = CreateAsyncFileStream(
                     result.CacheFileName,
                     FileMode.Open,
                     FileAccess.Read,
                     FileShare.Read | FileShare.Delete);
-
-                return 0;
-            });
+            }
 
             _report.WriteLine(string.Format("  {1} {0} {2}ms", uri, response.StatusCode.ToString().Green(), sw.ElapsedMilliseconds.ToString().Bold()));
 
             return result;
         }
 
-        private async Task<HttpSourceResult> TryCache(string uri, string cacheKey, TimeSpan cacheAgeLimit)
+        private static HttpCacheStore GetCacheStore()
         {
-            var baseFolderName = RemoveInvalidFileNameChars(ComputeHash(_baseUri));
-            var baseFileName = RemoveInvalidFileNameChars(cacheKey) + ".dat";
-
 #if NET45
             var localAppDataFolder = Environment.GetFolderPath(Environment.SpecialFolder.LocalApplicationData);
 #else
             var localAppDataFolder = Environment.GetEnvironmentVariable("LocalAppData");
 #endif
-            var cacheFolder = Path.Combine(localAppDataFolder, "kpm", "cache", baseFolderName);
-            var cacheFile = Path.Combine(cacheFolder, baseFileName);
-
-            if (!Directory.Exists(cacheFolder) && !cacheAgeLimit.Equals(TimeSpan.Zero))
-            {
-                Directory.CreateDirectory(cacheFolder);
-            }
-
-            // Acquire the lock on a file before we open it to prevent this process
-            // from opening a file deleted by the logic in HttpSource.GetAsync() in another process
-            return await ConcurrencyUtilities.ExecuteWithFileLocked(cacheFile, _ =>
-            {
-                if (File.Exists(cacheFile))
-                {
-                    var fileInfo = new FileInfo(cacheFile);
-#if NET45
-                    var age = DateTime.UtcNow.Subtract(fileInfo.LastWriteTimeUtc);
-#else
-                    var age = DateTime.Now.Subtract(fileInfo.LastWriteTime);
-#endif
-                    if (age < cacheAgeLimit)
-                    {
-                        var stream = CreateAsyncFileStream(
-                            cacheFile,
-                            FileMode.Open,
-                            FileAccess.Read,
-                            FileShare.Read | FileShare.Delete);
-
-                        return Task.FromResult(new HttpSourceResult
-                        {
-                            CacheFileName = cacheFile,
-                            Stream = stream,
-                        });
-                    }
-                }
-
-                return Task.FromResult(new HttpSourceResult
-                {
-                    CacheFileName = cacheFile,
-                });
-            });
+            return HttpCacheStore.GetStore(Path.Combine(localAppDataFolder, "kpm", "cache"));
         }
 
-        private static string ComputeHash(string value)
+        private static HttpSourceResult OpenCacheEntry(HttpCacheEntry entry)
         {
-            var trailing = value.Length > 32 ? value.Substring(value.Length - 32) : value;
-            var sha = SHA1.Create();
-            var hash = sha.ComputeHash(Encoding.UTF8.GetBytes(value));
-            var hex = "0123456789abcdef";
-            return hash.Aggregate("$" + trailing, (result, ch) => "" + hex[ch / 0x10] + hex[ch % 0x10] + result);
-        }
-
-        private static string RemoveInvalidFileNameChars(string value)
-        {
-            var invalid = Path.GetInvalidFileNameChars();
-            return new String(
-                    value.Select(ch => invalid.Contains(ch) ? '_' : ch).ToArray()
-                )
-                .Replace("__", "_")
-                .Replace("__", "_");
-        }
-
-        private static bool IsFileAlreadyOpen(string filePath)
-        {
-            FileStream stream = null;
-
-            try
-            {
-                stream = new FileStream(filePath, FileMode.Open, FileAccess.ReadWrite, FileShare.None);
-            }
-            catch
-            {
-                return true;
-            }
-            finally
+            // Blobs are never rewritten, so they can be read without taking a lock
+            return new HttpSourceResult
             {
-                if (stream != null)
-                {
-                    stream.Dispose();
-                }
-            }
-
-            return false;
+                CacheFileName = entry.BlobPath,
+                Stream = CreateAsyncFileStream(
+                    entry.BlobPath,
+                    FileMode.Open,
+                    FileAccess.Read,
+                    FileShare.Read | FileShare.Delete)
+            };
         }
 
         private static FileStream CreateAsyncFileStream(string path, FileMode mode, FileAccess access, FileShare share)
@@ -82,7 +82,6 @@ public async Task<IEnumerable<PackageInfo>> FindPackagesByIdAsyncCore(string id)
                         // (2) cache for pages is valid for only 30 min.
                         // So we decide to leave current logic and observe.
                         using (var data = await _httpSource.GetAsync(uri,
-                        string.Format("list_{0}_page{1}", id, page),
                         retry == 0 ? _cacheAgeLimitList : TimeSpan.Zero))
                         {
                             var doc = XDocument.Load(data.Stream);
@@ -183,14 +182,9 @@ public async Task<Stream> OpenNupkgStreamAsync(PackageInfo package)
                 return null;
             }
 
-            // Acquire the lock on a file before we open it to prevent this process
-            // from opening a file deleted by the logic in HttpSource.GetAsync() in another process
-            return await ConcurrencyUtilities.ExecuteWithFileLocked(result.TempFileName, _ =>
-            {
-                return Task.FromResult(
-                    new FileStream(result.TempFileName, FileMode.Open, FileAccess.Read,
-                    FileShare.ReadWrite | FileShare.Delete));
-            });
+            // Cached packages are never rewritten, so no lock is needed to open one
+            return new FileStream(result.TempFileName, FileMode.Open, FileAccess.Read,
+                FileShare.ReadWrite | FileShare.Delete);
         }
 
         private async Task<NupkgEntry> _OpenNupkgStreamAsync(PackageInfo package)
@@ -201,7 +195,6 @@ private async Task<NupkgEntry> _OpenNupkgStreamAsync(PackageInfo package)
                 {
                     using (var data = await _httpSource.GetAsync(
                         package.ContentUri,
-                        "nupkg_" + package.Id + "." + package.Version,
                         retry == 0 ? _cacheAgeLimitNupkg : TimeSpan.Zero))
                     {
                         return new NupkgEntry
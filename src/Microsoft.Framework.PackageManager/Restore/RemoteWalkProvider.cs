@@ -1,10 +1,12 @@
 // Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
 // Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
 
+using System;
 using System.Collections.Generic;
 using System.IO;
 using System.Linq;
 using System.Runtime.Versioning;
+using System.Threading;
 using System.Threading.Tasks;
 using Microsoft.Framework.PackageManager.Restore.NuGet;
 using Microsoft.Framework.Runtime;
@@ -14,11 +16,24 @@ namespace Microsoft.Framework.PackageManager
 {
     public class RemoteWalkProvider : IWalkProvider
     {
-        private IPackageFeed _source;
+        public const int DefaultMaxConcurrentRequests = 16;
+
+        private readonly IPackageFeed _source;
+        private readonly SemaphoreSlim _throttle;
+
+        // Every framework and every branch of the walk asks for the same ids, only the first one goes to the source
+        private readonly Dictionary<string, Task<IEnumerable<PackageInfo>>> _packagesById = new Dictionary<string, Task<IEnumerable<PackageInfo>>>(StringComparer.OrdinalIgnoreCase);
+        private readonly Dictionary<string, Task<IEnumerable<PackageDependencySet>>> _dependencySets = new Dictionary<string, Task<IEnumerable<PackageDependencySet>>>(StringComparer.OrdinalIgnoreCase);
 
         public RemoteWalkProvider(IPackageFeed source)
+            : this(source, DefaultMaxConcurrentRequests)
+        {
+        }
+
+        public RemoteWalkProvider(IPackageFeed source, int maxConcurrentRequests)
         {
             _source = source;
+            _throttle = new SemaphoreSlim(Math.Max(maxConcurrentRequests, 1));
         }
 
         public Task<WalkProviderMatch> FindLibraryByName(string name, FrameworkName targetFramework)
@@ -33,7 +48,7 @@ public async Task<WalkProviderMatch> FindLibraryByVersion(Library library, Frame
 
         public async Task<WalkProviderMatch> FindLibraryBySnapshot(Library library, FrameworkName targetFramework)
         {
-            var results = await _source.FindPackagesByIdAsync(library.Name);
+            var results = await FindPackagesById(library.Name);
             PackageInfo bestResult = null;
             foreach (var result in results)
             {
@@ -58,6 +73,63 @@ public async Task<WalkProviderMatch> FindLibraryBySnapshot(Library library, Fram
         }
 
         public async Task<IEnumerable<Library>> GetDependencies(WalkProviderMatch match, FrameworkName targetFramework)
+        {
+            var dependencySets = await GetDependencySets(match);
+            IEnumerable<PackageDependencySet> dependencySet;
+            if (VersionUtility.TryGetCompatibleItems(targetFramework, dependencySets, out dependencySet))
+            {
+                return dependencySet
+                    .SelectMany(x => x.Dependencies)
+                    .Select(x => new Library { Name = x.Id,
+                        Version = x.VersionSpec != null ? x.VersionSpec.MinVersion : null })
+                    .ToList();
+            }
+            return Enumerable.Empty<Library>();
+        }
+
+        private Task<IEnumerable<PackageInfo>> FindPackagesById(string id)
+        {
+            return GetOrAdd(_packagesById, id, () => Throttle(() => _source.FindPackagesByIdAsync(id)));
+        }
+
+        private Task<IEnumerable<PackageDependencySet>> GetDependencySets(WalkProviderMatch match)
+        {
+            // The nuspec is the same for every target framework, read it once and pick the dependency set per framework
+            var key = match.Library.Name + " " + match.Library.Version;
+            return GetOrAdd(_dependencySets, key, () => Throttle(() => ReadDependencySets(match)));
+        }
+
+        private static Task<T> GetOrAdd<T>(Dictionary<string, Task<T>> tasks, string key, Func<Task<T>> create)
+        {
+            Task<T> task;
+            lock (tasks)
+            {
+                if (tasks.TryGetValue(key, out task))
+                {
+                    return task;
+                }
+
+                task = tasks[key] = create();
+            }
+
+            // Callers already waiting see the failure, the next one asks the source again
+            task.ContinueWith(_ =>
+            {
+                lock (tasks)
+                {
+                    Task<T> current;
+                    if (tasks.TryGetValue(key, out current) && current == task)
+                    {
+                        tasks.Remove(key);
+                    }
+                }
+            },
+            TaskContinuationOptions.NotOnRanToCompletion | TaskContinuationOptions.ExecuteSynchronously);
+
+            return task;
+        }
+
+        private async Task<IEnumerable<PackageDependencySet>> ReadDependencySets(WalkProviderMatch match)
         {
             using (var stream = await _source.OpenNuspecStreamAsync(new PackageInfo
             {
@@ -67,17 +139,21 @@ public async Task<IEnumerable<Library>> GetDependencies(WalkProviderMatch match,
             }))
             {
                 var metadata = (IPackageMetadata)Manifest.ReadFrom(stream, validateSchema: false).Metadata;
-                IEnumerable<PackageDependencySet> dependencySet;
-                if (VersionUtility.TryGetCompatibleItems(targetFramework, metadata.DependencySets, out dependencySet))
-                {
-                    return dependencySet
-                        .SelectMany(x => x.Dependencies)
-                        .Select(x => new Library { Name = x.Id,
-                            Version = x.VersionSpec != null ? x.VersionSpec.MinVersion : null })
-                        .ToList();
-                }
+                return metadata.DependencySets.ToList();
+            }
+        }
+
+        private async Task<T> Throttle<T>(Func<Task<T>> operation)
+        {
+            await _throttle.WaitAsync();
+            try
+            {
+                return await operation();
+            }
+            finally
+            {
+                _throttle.Release();
             }
-            return Enumerable.Empty<Library>();
         }
 
         public async Task CopyToAsync(WalkProviderMatch match, Stream stream)
@@ -5,7 +5,6 @@
 using System.Collections.Generic;
 using System.Diagnostics;
 using System.IO;
-using System.IO.Compression;
 using System.Linq;
 using System.Runtime.Versioning;
 using System.Security.Cryptography;
@@ -28,6 +27,7 @@ public RestoreCommand(IApplicationEnvironment env)
             Sources = Enumerable.Empty<string>();
             FallbackSources = Enumerable.Empty<string>();
             ScriptExecutor = new ScriptExecutor();
+            MaxConcurrentRequests = RemoteWalkProvider.DefaultMaxConcurrentRequests;
         }
 
         public string RestoreDirectory { get; set; }
@@ -37,6 +37,7 @@ public RestoreCommand(IApplicationEnvironment env)
         public bool NoCache { get; set; }
         public string PackageFolder { get; set; }
         public string GlobalJsonFile { get; set; }
+        public int MaxConcurrentRequests { get; set; }
 
         public ScriptExecutor ScriptExecutor { get; private set; }
 
@@ -245,6 +246,11 @@ private async Task<bool> RestoreForProject(string projectJsonPath, string rootDi
 
             ScriptExecutor.Execute(project, "prepare", getVariable);
 
+            if (success)
+            {
+                WriteLockFile(project, packagesDirectory, contexts.Select(context => context.FrameworkName));
+            }
+
             Reports.Information.WriteLine(string.Format("{0}, {1}ms elapsed", "Restore complete".Green().Bold(), sw.ElapsedMilliseconds));
 
             for (int i = 0; i < contexts.Count; i++)
@@ -255,6 +261,49 @@ private async Task<bool> RestoreForProject(string projectJsonPath, string rootDi
             return success;
         }
 
+        private void WriteLockFile(Runtime.Project project, string packagesDirectory, IEnumerable<FrameworkName> frameworks)
+        {
+            var lockFile = new LockFile();
+
+            foreach (var framework in frameworks)
+            {
+                // Walk the way the runtime will, so the lock file holds exactly what it would resolve
+                var cacheContextAccessor = new CacheContextAccessor();
+                var cache = new Cache(cacheContextAccessor);
+                var hostContext = new ApplicationHostContext(
+                    serviceProvider: null,
+                    projectDirectory: project.ProjectDirectory,
+                    packagesDirectory: packagesDirectory,
+                    // Any configuration will do, none of them changes what the walk resolves (see
+                    // ApplicationHostContext.ComputeLockFileHash) so one entry serves them all
+                    configuration: "Debug",
+                    targetFramework: framework,
+                    cache: cache,
+                    cacheContextAccessor: cacheContextAccessor);
+
+                hostContext.DependencyWalker.Walk(project.Name, project.Version, framework);
+
+                if (hostContext.UnresolvedDependencyProvider.UnresolvedDependencies.Any())
+                {
+                    Reports.Verbose.WriteLine(string.Format("Skipping lock file entry for {0}, it has unresolved dependencies", framework));
+                    continue;
+                }
+
+                lockFile.Targets.Add(hostContext.CreateLockFileTarget());
+            }
+
+            var lockFilePath = Path.Combine(project.ProjectDirectory, LockFile.FileName);
+            if (lockFile.Targets.Any())
+            {
+                lockFile.Write(project.ProjectDirectory);
+                Reports.Verbose.WriteLine(string.Format("Wrote {0}", lockFilePath));
+            }
+            else if (File.Exists(lockFilePath))
+            {
+                File.Delete(lockFilePath);
+            }
+        }
+
         private async Task<bool> RestoreFromGlobalJson(string rootDirectory, string packagesDirectory)
         {
             var success = true;
@@ -365,10 +414,11 @@ private async Task InstallPackages(List<GraphItem> installItems, string packages
                 {
                     var library = item.Match.Library;
 
+                    // The nupkg is fetched once, hashed, written and extracted from memory
                     var memStream = new MemoryStream();
                     await item.Match.Provider.CopyToAsync(item.Match, memStream);
-                    memStream.Seek(0, SeekOrigin.Begin);
-                    var nupkgSHA = Convert.ToBase64String(sha512.ComputeHash(memStream));
+                    var nupkg = memStream.ToArray();
+                    var nupkgSHA = Convert.ToBase64String(sha512.ComputeHash(nupkg));
 
                     bool shouldInstall = packageFilter(library, nupkgSHA);
                     if (!shouldInstall)
@@ -394,12 +444,11 @@ private async Task InstallPackages(List<GraphItem> installItems, string packages
                             Directory.CreateDirectory(targetPath);
                             using (var stream = new FileStream(targetNupkg, FileMode.Create, FileAccess.ReadWrite, FileShare.ReadWrite | FileShare.Delete))
                             {
-                                await item.Match.Provider.CopyToAsync(item.Match, stream);
-                                stream.Seek(0, SeekOrigin.Begin);
-
-                                ExtractPackage(targetPath, stream);
+                                await stream.WriteAsync(nupkg, 0, nupkg.Length);
                             }
 
+                            ExtractPackage(targetPath, nupkg);
+
                             File.WriteAllText(hashPath, nupkgSHA);
                         }
 
@@ -407,6 +456,12 @@ private async Task InstallPackages(List<GraphItem> installItems, string packages
                     });
                 }
             }
+
+            // Only packages added since the last restore have their nuspec read
+            if (Directory.Exists(packagesDirectory))
+            {
+                PackageMetadataIndex.Update(packagesDirectory);
+            }
         }
 
         private void AddRemoteProvidersFromSources(List<IWalkProvider> remoteProviders, List<PackageSource> effectiveSources)
@@ -419,7 +474,8 @@ private void AddRemoteProvidersFromSources(List<IWalkProvider> remoteProviders,
                         new RemoteWalkProvider(
                             PackageFolderFactory.CreatePackageFolderFromPath(
                                 source.Source,
-                                Reports.Quiet)));
+                                Reports.Quiet),
+                            MaxConcurrentRequests));
                 }
                 else
                 {
@@ -430,7 +486,8 @@ private void AddRemoteProvidersFromSources(List<IWalkProvider> remoteProviders,
                                 source.UserName,
                                 source.Password,
                                 NoCache,
-                                Reports.Quiet)));
+                                Reports.Quiet),
+                            MaxConcurrentRequests));
                 }
             }
         }
@@ -469,13 +526,10 @@ private void PrintDependencyGraph(GraphNode root, FrameworkName frameworkName)
             Reports.Verbose.WriteLine();
         }
 
-        private static void ExtractPackage(string targetPath, FileStream stream)
+        private static void ExtractPackage(string targetPath, byte[] nupkg)
         {
-            using (var archive = new ZipArchive(stream, ZipArchiveMode.Read))
-            {
-                var packOperations = new PackOperations();
-                packOperations.ExtractNupkg(archive, targetPath);
-            }
+            var packOperations = new PackOperations();
+            packOperations.ExtractNupkg(nupkg, targetPath);
         }
 
         void ForEach(IEnumerable<GraphNode> nodes, Action<GraphNode> callback)
@@ -54,11 +54,10 @@ public async Task<GraphNode> CreateGraphNode(RestoreContext context, Library lib
                         tasks.Add(CreateGraphNode(context, dependency, ChainPredicate(predicate, node.Item, dependency)));
                     }
                 }
-                while (tasks.Any())
+
+                // All dependencies of the node are resolved concurrently, keep them in the order they were declared
+                foreach (var dependency in await Task.WhenAll(tasks))
                 {
-                    var task = await Task.WhenAny(tasks);
-                    tasks.Remove(task);
-                    var dependency = await task;
                     node.Dependencies.Add(dependency);
                 }
             }
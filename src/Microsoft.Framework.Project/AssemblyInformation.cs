@@ -6,6 +6,7 @@
 using System.IO;
 using System.Reflection.PortableExecutable;
 using System.Reflection.Metadata;
+using System.Security.Cryptography;
 
 namespace Microsoft.Framework.Project
 {
@@ -13,6 +14,9 @@ public class AssemblyInformation
     {
         public static readonly IEqualityComparer<AssemblyInformation> NameComparer = new AssemblyNameComparer();
 
+        private readonly Lazy<string> _hash;
+        private ICollection<string> _dependencies;
+
         public AssemblyInformation(string path, string processorArchitecture)
         {
             path = Path.GetFullPath(path);
@@ -20,6 +24,8 @@ public AssemblyInformation(string path, string processorArchitecture)
 
             AssemblyPath = path;
             ProcessorArchitecture = processorArchitecture;
+
+            _hash = new Lazy<string>(ComputeHash);
         }
 
         public bool IsRuntimeAssembly { get; set; }
@@ -60,12 +66,40 @@ public string NativePdbPath
             }
         }
 
+        /// <summary>
+        /// Records the inputs the native image was generated from, see <see cref="CrossgenManager"/>.
+        /// </summary>
+        public string NativeImageStampPath
+        {
+            get
+            {
+                return Path.Combine(NativeImageDirectory, Name + ".ni.stamp");
+            }
+        }
+
+        /// <summary>
+        /// SHA256 of the IL image.
+        /// </summary>
+        public string Hash
+        {
+            get
+            {
+                return _hash.Value;
+            }
+        }
+
         public IEnumerable<AssemblyInformation> Closure { get; set; }
 
         public bool Generated { get; set; }
 
         public ICollection<string> GetDependencies()
         {
+            // Sorting the universe asks for these over and over
+            if (_dependencies != null)
+            {
+                return _dependencies;
+            }
+
             var dependencies = new HashSet<string>();
 
             using (var stream = File.OpenRead(AssemblyPath))
@@ -83,6 +117,7 @@ public ICollection<string> GetDependencies()
                 }
             }
 
+            _dependencies = dependencies;
             return dependencies;
         }
 
@@ -102,6 +137,15 @@ public static bool IsValidImage(string path)
             }
         }
 
+        private string ComputeHash()
+        {
+            using (var sha = SHA256.Create())
+            using (var stream = File.OpenRead(AssemblyPath))
+            {
+                return BitConverter.ToString(sha.ComputeHash(stream)).Replace("-", string.Empty).ToLowerInvariant();
+            }
+        }
+
         public override bool Equals(object obj)
         {
             return ((AssemblyInformation)obj).AssemblyPath.Equals(AssemblyPath, StringComparison.OrdinalIgnoreCase);
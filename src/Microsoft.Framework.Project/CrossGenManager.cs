@@ -6,11 +6,24 @@
 using System.Diagnostics;
 using System.IO;
 using System.Linq;
+using System.Security.Cryptography;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
 
 namespace Microsoft.Framework.Project
 {
+    /// <summary>
+    /// Runs crossgen over the universe of assemblies. An assembly is generated as soon as the assemblies it
+    /// references are done, up to KRE_CROSSGEN_WORKERS (the number of cores by default) crossgen processes at a time.
+    /// A stamp next to each native image records the IL it came from and the IL of its closure, images whose
+    /// stamp still matches are not generated again.
+    /// </summary>
     public class CrossgenManager
     {
+        private static readonly int MaxWorkers = GetMaxWorkers();
+        private static readonly object _consoleLock = new object();
+
         private readonly IDictionary<string, AssemblyInformation> _universe;
         private readonly CrossgenOptions _options;
 
@@ -32,17 +45,56 @@ public bool GenerateNativeImages()
                                                             .ToList();
             }
 
-            bool success = true;
+            var sw = Stopwatch.StartNew();
+            var throttle = new SemaphoreSlim(MaxWorkers);
+            var tasks = new Dictionary<AssemblyInformation, Task<bool>>();
 
-            // Generate the native images in dependency order
+            // Dependencies come first in sorted order so their tasks already exist. Within a reference cycle
+            // they don't, GenerateNativeImage then skips the assembly like it always did
             foreach (var assemblyInfo in Sort(_universe.Values))
             {
-                success = success && GenerateNativeImage(assemblyInfo);
+                var dependencies = new List<Task<bool>>();
+                foreach (var dependency in assemblyInfo.GetDependencies())
+                {
+                    AssemblyInformation dependencyInfo;
+                    Task<bool> dependencyTask;
+                    if (_universe.TryGetValue(dependency, out dependencyInfo) &&
+                        tasks.TryGetValue(dependencyInfo, out dependencyTask))
+                    {
+                        dependencies.Add(dependencyTask);
+                    }
+                }
+
+                tasks[assemblyInfo] = GenerateNativeImageAsync(assemblyInfo, dependencies, throttle);
             }
-            
-            return success;
+
+            var results = Task.WhenAll(tasks.Values).GetAwaiter().GetResult();
+
+            sw.Stop();
+            Console.WriteLine("Native images for {0} assemblies took {1}ms", tasks.Count, sw.ElapsedMilliseconds);
+
+            return results.All(generated => generated);
         }
-        
+
+        private async Task<bool> GenerateNativeImageAsync(AssemblyInformation assemblyInfo,
+                                                          IEnumerable<Task<bool>> dependencies,
+                                                          SemaphoreSlim throttle)
+        {
+            // Failed dependencies are handled by GenerateNativeImage
+            await Task.WhenAll(dependencies);
+
+            await throttle.WaitAsync();
+            try
+            {
+                // Blocks on crossgen for the whole time, don't hold up a thread pool thread
+                return await Task.Factory.StartNew(() => GenerateNativeImage(assemblyInfo), TaskCreationOptions.LongRunning);
+            }
+            finally
+            {
+                throttle.Release();
+            }
+        }
+
         private bool ExecuteCrossgen(string filename, string arguments, string assemblyName)
         {
             var options = new ProcessStartInfo
@@ -58,19 +110,28 @@ private bool ExecuteCrossgen(string filename, string arguments, string assemblyN
                 RedirectStandardOutput = true
             };
 
+            // Several crossgen processes run at once, keep the output of each one together
+            var output = new StringBuilder();
+            var error = new StringBuilder();
+
             var p = Process.Start(options);
 #if NET45
             p.EnableRaisingEvents = true;
 #endif
 
-            p.ErrorDataReceived += OnErrorDataReceived;
-            p.OutputDataReceived += OnOutputDataReceived;
+            p.ErrorDataReceived += (sender, e) => AppendLine(error, e.Data);
+            p.OutputDataReceived += (sender, e) => AppendLine(output, e.Data);
 
             p.BeginErrorReadLine();
             p.BeginOutputReadLine();
             p.WaitForExit();
 
-            Console.WriteLine("Exit code for {0}: {1}", assemblyName, p.ExitCode);
+            lock (_consoleLock)
+            {
+                Console.Write(output.ToString());
+                Console.Error.Write(error.ToString());
+                Console.WriteLine("Exit code for {0}: {1}", assemblyName, p.ExitCode);
+            }
 
             if (p.ExitCode == 0)
             {
@@ -90,6 +151,16 @@ private bool GenerateNativeImage(AssemblyInformation assemblyInfo)
                 return false;
             }
 
+            var stamp = ComputeStamp(assemblyInfo);
+            if (IsUpToDate(assemblyInfo, stamp))
+            {
+                Console.WriteLine("Skipping {0}. Native image is up to date", assemblyInfo.Name);
+                assemblyInfo.Generated = true;
+                return true;
+            }
+
+            var sw = Stopwatch.StartNew();
+
             // Add the assembly itself to the closure
             var closure = assemblyInfo.Closure.Select(d => d.NativeImagePath)
                                       .Concat(new[] { assemblyInfo.AssemblyPath });
@@ -165,17 +236,68 @@ private bool GenerateNativeImage(AssemblyInformation assemblyInfo)
                 retCrossgen = ExecuteCrossgen(_options.CrossgenPath, argsPdb, assemblyInfo.Name);
             }
 
+            if (retCrossgen)
+            {
+                File.WriteAllText(assemblyInfo.NativeImageStampPath, stamp);
+            }
+
+            sw.Stop();
+            Console.WriteLine("Generated native images for {0} in {1}ms", assemblyInfo.Name, sw.ElapsedMilliseconds);
+
             return retCrossgen;
         }
 
-        void OnErrorDataReceived(object sender, DataReceivedEventArgs e)
+        private string ComputeStamp(AssemblyInformation assemblyInfo)
+        {
+            // The native image depends on its own IL and on the IL of everything it was compiled against
+            var builder = new StringBuilder();
+            builder.Append(_options.Symbols).Append('|').Append(assemblyInfo.Hash);
+
+            foreach (var dependency in assemblyInfo.Closure.OrderBy(d => d.Name, StringComparer.OrdinalIgnoreCase))
+            {
+                builder.Append('|').Append(dependency.Name).Append(':').Append(dependency.Hash);
+            }
+
+            using (var sha = SHA256.Create())
+            {
+                var hash = sha.ComputeHash(Encoding.UTF8.GetBytes(builder.ToString()));
+                return BitConverter.ToString(hash).Replace("-", string.Empty).ToLowerInvariant();
+            }
+        }
+
+        private bool IsUpToDate(AssemblyInformation assemblyInfo, string stamp)
+        {
+            if (!File.Exists(assemblyInfo.NativeImagePath) ||
+                !File.Exists(assemblyInfo.NativeImageStampPath) ||
+                (_options.Symbols && !File.Exists(assemblyInfo.NativePdbPath)))
+            {
+                return false;
+            }
+
+            return string.Equals(File.ReadAllText(assemblyInfo.NativeImageStampPath), stamp, StringComparison.Ordinal);
+        }
+
+        private static void AppendLine(StringBuilder builder, string line)
         {
-            Console.Error.WriteLine(e.Data);
+            if (line == null)
+            {
+                return;
+            }
+
+            lock (builder)
+            {
+                builder.AppendLine(line);
+            }
         }
 
-        void OnOutputDataReceived(object sender, DataReceivedEventArgs e)
+        private static int GetMaxWorkers()
         {
-            Console.WriteLine(e.Data);
+            int value;
+            if (Int32.TryParse(Environment.GetEnvironmentVariable("KRE_CROSSGEN_WORKERS"), out value) && value > 0)
+            {
+                return value;
+            }
+            return Environment.ProcessorCount;
         }
 
         private static IDictionary<string, AssemblyInformation> BuildUniverse(string runtimePath, IEnumerable<string> paths)
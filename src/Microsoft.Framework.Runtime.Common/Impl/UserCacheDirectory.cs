@@ -0,0 +1,89 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+using System;
+using System.IO;
+#if NET45
+using System.Runtime.InteropServices;
+#endif
+
+namespace Microsoft.Framework.Runtime
+{
+    /// <summary>
+    /// Directories for files the runtime loads without checking where they came from. They live under the
+    /// profile of the current user so no other user can create or replace them.
+    /// </summary>
+    internal static class UserCacheDirectory
+    {
+#if NET45
+        // rwx for the owner only
+        private const int Mode700 = 448;
+#endif
+
+        private static readonly bool _isWindows = Path.DirectorySeparatorChar == '\\';
+
+        /// <summary>
+        /// Returns the directory <paramref name="name"/> for the current user, created if it doesn't exist,
+        /// or null if the user has no profile to put it in. When <paramref name="inMemory"/> is set a
+        /// per-user tmpfs is preferred where there is one.
+        /// </summary>
+        public static string Get(string name, bool inMemory = false)
+        {
+            var root = GetRoot(inMemory);
+            if (string.IsNullOrEmpty(root))
+            {
+                return null;
+            }
+
+            var directory = Path.Combine(root, "kre", name);
+            Directory.CreateDirectory(directory);
+
+#if NET45
+            // Only the owner can change the mode, so this fails for a directory someone else created
+            if (!_isWindows && chmod(directory, Mode700) != 0)
+            {
+                throw new UnauthorizedAccessException(string.Format(
+                    "Unable to restrict access to '{0}', error {1}.", directory, Marshal.GetLastWin32Error()));
+            }
+#endif
+
+            return directory;
+        }
+
+        private static string GetRoot(bool inMemory)
+        {
+            if (_isWindows)
+            {
+#if NET45
+                return Environment.GetFolderPath(Environment.SpecialFolder.LocalApplicationData);
+#else
+                return Environment.GetEnvironmentVariable("LocalAppData");
+#endif
+            }
+
+            if (inMemory)
+            {
+                // Created by the session manager for this user alone, with mode 0700
+                var runtimeDirectory = Environment.GetEnvironmentVariable("XDG_RUNTIME_DIR");
+                if (!string.IsNullOrEmpty(runtimeDirectory) && Directory.Exists(runtimeDirectory))
+                {
+                    return runtimeDirectory;
+                }
+            }
+
+            var cacheHome = Environment.GetEnvironmentVariable("XDG_CACHE_HOME");
+            if (!string.IsNullOrEmpty(cacheHome))
+            {
+                return cacheHome;
+            }
+
+            var home = Environment.GetEnvironmentVariable("HOME");
+            return string.IsNullOrEmpty(home) ? null : Path.Combine(home, ".cache");
+        }
+
+#if NET45
+        [DllImport("libc", SetLastError = true)]
+        private static extern int chmod(string path, int mode);
+#endif
+    }
+}
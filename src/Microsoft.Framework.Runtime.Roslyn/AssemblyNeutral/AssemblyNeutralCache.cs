@@ -0,0 +1,191 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+using System;
+using System.Diagnostics;
+using System.IO;
+using System.Security.Cryptography;
+using System.Text;
+using System.Threading;
+
+namespace Microsoft.Framework.Runtime.Roslyn
+{
+    /// <summary>
+    /// Generated assembly neutral assemblies stored by a hash of everything that goes into them, shared by
+    /// all compilations and processes of the user. An entry never changes once it is written.
+    /// </summary>
+    public class AssemblyNeutralCache
+    {
+        // Bump when the way assembly neutral assemblies are generated changes
+        private const string FormatVersion = "2";
+
+        // Entries not read for this long belong to references that aren't used anymore
+        private static readonly TimeSpan MaxAge = TimeSpan.FromDays(7);
+
+        private static readonly Lazy<AssemblyNeutralCache> _default = new Lazy<AssemblyNeutralCache>(CreateDefault);
+
+        private readonly string _directory;
+        private int _staleEntriesRemoved;
+
+        public AssemblyNeutralCache(string directory)
+        {
+            _directory = directory;
+        }
+
+        /// <summary>
+        /// The cache in the profile of the current user, null if there is nowhere to put it.
+        /// </summary>
+        public static AssemblyNeutralCache Default
+        {
+            get
+            {
+                return _default.Value;
+            }
+        }
+
+        public static string ComputeKey(params string[] inputs)
+        {
+            var builder = new StringBuilder(FormatVersion);
+            foreach (var input in inputs)
+            {
+                // Length prefixed so the inputs can't run into each other
+                builder.Append('|').Append(input.Length).Append(':').Append(input);
+            }
+
+            return ComputeHash(Encoding.UTF8.GetBytes(builder.ToString()));
+        }
+
+        public byte[] Get(string key)
+        {
+            var path = GetPath(key);
+            RemoveStaleEntriesOnce();
+
+            try
+            {
+                if (!File.Exists(path))
+                {
+                    return null;
+                }
+
+                // The hash of the image is written before it, a truncated or changed entry is generated again
+                var bytes = File.ReadAllBytes(path);
+                var hashLength = bytes.Length > 0 ? bytes[0] : 0;
+                if (bytes.Length > hashLength + 1)
+                {
+                    var hash = Encoding.UTF8.GetString(bytes, 1, hashLength);
+                    var image = new byte[bytes.Length - hashLength - 1];
+                    Array.Copy(bytes, hashLength + 1, image, 0, image.Length);
+
+                    if (string.Equals(hash, ComputeHash(image), StringComparison.Ordinal))
+                    {
+                        // Used, so not stale
+                        File.SetLastWriteTimeUtc(path, DateTime.UtcNow);
+                        return image;
+                    }
+                }
+
+                Trace.TraceInformation("[{0}]: Removing corrupt entry {1}", typeof(AssemblyNeutralCache).Name, key);
+                File.Delete(path);
+                return null;
+            }
+            catch (IOException)
+            {
+                return null;
+            }
+            catch (UnauthorizedAccessException)
+            {
+                return null;
+            }
+        }
+
+        public void Add(string key, byte[] image)
+        {
+            var path = GetPath(key);
+            var tempPath = path + "." + Guid.NewGuid().ToString("N");
+            RemoveStaleEntriesOnce();
+
+            try
+            {
+                Directory.CreateDirectory(_directory);
+
+                var hash = Encoding.UTF8.GetBytes(ComputeHash(image));
+
+                // Write it somewhere else first so nobody reads a partial image
+                using (var stream = new FileStream(tempPath, FileMode.CreateNew, FileAccess.Write))
+                {
+                    stream.WriteByte((byte)hash.Length);
+                    stream.Write(hash, 0, hash.Length);
+                    stream.Write(image, 0, image.Length);
+                }
+
+                File.Move(tempPath, path);
+            }
+            catch (Exception ex)
+            {
+                // Someone else stored it first or the folder isn't writable, it just gets generated again
+                Trace.TraceInformation("[{0}]: Unable to cache {1}: {2}", typeof(AssemblyNeutralCache).Name, key, ex.Message);
+            }
+            finally
+            {
+                if (File.Exists(tempPath))
+                {
+                    File.Delete(tempPath);
+                }
+            }
+        }
+
+        private static AssemblyNeutralCache CreateDefault()
+        {
+            try
+            {
+                // Per user, anyone could plant an image in a shared location
+                var directory = UserCacheDirectory.Get("assemblyneutral");
+                return directory == null ? null : new AssemblyNeutralCache(directory);
+            }
+            catch (Exception ex)
+            {
+                Trace.TraceInformation("[{0}]: Caching disabled: {1}", typeof(AssemblyNeutralCache).Name, ex.Message);
+                return null;
+            }
+        }
+
+        private void RemoveStaleEntriesOnce()
+        {
+            if (Interlocked.Exchange(ref _staleEntriesRemoved, 1) != 0 || !Directory.Exists(_directory))
+            {
+                return;
+            }
+
+            foreach (var path in Directory.EnumerateFiles(_directory))
+            {
+                if (DateTime.UtcNow - File.GetLastWriteTimeUtc(path) < MaxAge)
+                {
+                    continue;
+                }
+
+                try
+                {
+                    File.Delete(path);
+                }
+                catch (Exception ex)
+                {
+                    Trace.TraceInformation("[{0}]: Unable to remove {1}: {2}", typeof(AssemblyNeutralCache).Name, path, ex.Message);
+                }
+            }
+        }
+
+        private string GetPath(string key)
+        {
+            return Path.Combine(_directory, key + ".dll");
+        }
+
+        private static string ComputeHash(byte[] bytes)
+        {
+            using (var sha = SHA256.Create())
+            {
+                var hash = sha.ComputeHash(bytes);
+                return BitConverter.ToString(hash).Replace("-", string.Empty).ToLowerInvariant();
+            }
+        }
+    }
+}
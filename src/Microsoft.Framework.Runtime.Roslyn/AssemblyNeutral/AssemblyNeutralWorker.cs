@@ -22,20 +22,35 @@ public class AssemblyNeutralWorker
 
         public AssemblyNeutralWorker(CSharpCompilation compilation, 
                                      IDictionary<string, MetadataReference> existingReferences)
+            : this(compilation, existingReferences, cache: null)
+        {
+        }
+
+        public AssemblyNeutralWorker(CSharpCompilation compilation,
+                                     IDictionary<string, MetadataReference> existingReferences,
+                                     AssemblyNeutralCache cache)
         {
             OriginalCompilation = compilation;
             _existingReferences = existingReferences;
+            Cache = cache;
         }
 
         public CSharpCompilation OriginalCompilation { get; private set; }
 
         public CSharpCompilation Compilation { get; private set; }
 
+        // Where generated assemblies are looked up and stored, null to always generate them
+        public AssemblyNeutralCache Cache { get; private set; }
+
+        // What every generated assembly is compiled against and how, part of their cache keys. Null if
+        // a reference has no stable identity.
+        public string ReferencesKey { get; private set; }
+
         public IEnumerable<TypeCompilationContext> TypeCompilations
         {
             get
             {
-                return _typeCompilationContexts.Where(t => t.EmitResult != null && t.EmitResult.Success);
+                return _typeCompilationContexts.Where(t => t.Reference != null);
             }
         }
 
@@ -71,21 +86,134 @@ public void OrderTypeCompilations()
 
         public IList<Diagnostic> GenerateTypeCompilations()
         {
-            var diagnostics = new List<Diagnostic>();
+            var contexts = _typeCompilationContexts.Where(context => !_existingReferences.ContainsKey(context.AssemblyName))
+                                                   .ToList();
+            var diagnostics = new IEnumerable<Diagnostic>[contexts.Count];
 
-            foreach (var context in _typeCompilationContexts)
+            if (contexts.Count == 0)
             {
-                if (_existingReferences.ContainsKey(context.AssemblyName))
+                return new List<Diagnostic>();
+            }
+
+            ReferencesKey = GetReferencesKey();
+
+            if (contexts.Count > 1 && !HasForwardReferences(contexts))
+            {
+                // Each type only needs the ones it uses, generate independent ones side by side
+                var tasks = new Dictionary<TypeCompilationContext, Task>();
+                for (int i = 0; i < contexts.Count; i++)
                 {
-                    continue;
+                    var context = contexts[i];
+                    var index = i;
+                    var dependencies = context.Requires.Keys.Where(tasks.ContainsKey)
+                                                            .Select(other => tasks[other])
+                                                            .ToArray();
+
+                    tasks[context] = Task.WhenAll(dependencies).ContinueWith(_ =>
+                    {
+                        diagnostics[index] = context.Generate(_existingReferences);
+                    },
+                    TaskScheduler.Default);
+                }
+
+                Task.WhenAll(tasks.Values).GetAwaiter().GetResult();
+            }
+            else
+            {
+                for (int i = 0; i < contexts.Count; i++)
+                {
+                    diagnostics[i] = contexts[i].Generate(_existingReferences);
                 }
+            }
 
-                var result = context.Generate(_existingReferences);
+            return diagnostics.SelectMany(d => d).ToList();
+        }
+
+        private static bool HasForwardReferences(IList<TypeCompilationContext> contexts)
+        {
+            // A type using one generated after it gets a shallow reference, those are generated
+            // on demand and have to stay in order
+            var seen = new HashSet<TypeCompilationContext>();
+            var pending = new HashSet<TypeCompilationContext>(contexts);
+
+            foreach (var context in contexts)
+            {
+                if (context.Requires.Keys.Any(other => pending.Contains(other) && !seen.Contains(other)))
+                {
+                    return true;
+                }
 
-                diagnostics.AddRange(result.Diagnostics);
+                seen.Add(context);
             }
 
-            return diagnostics;
+            return false;
+        }
+
+        private string GetReferencesKey()
+        {
+            var references = new List<string>();
+            foreach (var reference in OriginalCompilation.References)
+            {
+                // The identity alone doesn't change when an assembly is rebuilt, its module version ids do
+                var referenceKey = GetReferenceKey(reference);
+                if (referenceKey == null)
+                {
+                    return null;
+                }
+
+                references.Add(referenceKey);
+            }
+
+            references.Sort(StringComparer.Ordinal);
+
+            return GetOptionsKey(OriginalCompilation.Options) + ";" + string.Join(";", references);
+        }
+
+        private static string GetReferenceKey(MetadataReference reference)
+        {
+            // A compilation reference is source that hasn't been emitted yet
+            var peReference = reference as PortableExecutableReference;
+            if (peReference == null)
+            {
+                return null;
+            }
+
+            var metadata = peReference.GetMetadata();
+            var assemblyMetadata = metadata as AssemblyMetadata;
+            var modules = assemblyMetadata != null ?
+                assemblyMetadata.GetModules().ToArray() :
+                new[] { (ModuleMetadata)metadata };
+
+            return string.Join(",", modules.Select(module => module.GetModuleVersionId().ToString("N")));
+        }
+
+        private static string GetOptionsKey(CSharpCompilationOptions options)
+        {
+            var diagnosticOptions = options.SpecificDiagnosticOptions.OrderBy(option => option.Key, StringComparer.Ordinal)
+                                                                     .Select(option => option.Key + "=" + option.Value);
+
+            var keyFileHash = string.Empty;
+            if (!string.IsNullOrEmpty(options.CryptoKeyFile) && File.Exists(options.CryptoKeyFile))
+            {
+                // The same path may hold another key
+                keyFileHash = AssemblyNeutralCache.ComputeKey(Convert.ToBase64String(File.ReadAllBytes(options.CryptoKeyFile)));
+            }
+
+            return string.Join(",", new object[]
+            {
+                options.OutputKind,
+                options.Platform,
+                options.OptimizationLevel,
+                options.AllowUnsafe,
+                options.CheckOverflow,
+                options.WarningLevel,
+                options.GeneralDiagnosticOption,
+                string.Join(" ", diagnosticOptions),
+                options.CryptoKeyFile,
+                keyFileHash,
+                options.CryptoKeyContainer,
+                options.DelaySign
+            });
         }
 
         public void Generate()
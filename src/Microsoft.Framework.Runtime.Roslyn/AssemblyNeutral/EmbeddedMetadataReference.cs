@@ -1,8 +1,6 @@
 ﻿// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
 // Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
 
-using System.IO;
-
 namespace Microsoft.Framework.Runtime.Roslyn
 {
     public class EmbeddedMetadataReference : RoslynMetadataReference, IMetadataEmbeddedReference
@@ -10,13 +8,8 @@ public class EmbeddedMetadataReference : RoslynMetadataReference, IMetadataEmbed
         public EmbeddedMetadataReference(TypeCompilationContext context)
             : base(context.AssemblyName, context.RealOrShallowReference())
         {
-            using (var ms = new MemoryStream((int)context.OutputStream.Length))
-            {
-                // This stream is always seekable
-                context.OutputStream.Position = 0;
-                context.OutputStream.CopyTo(ms);
-                Contents = ms.ToArray();
-            }
+            // The image is never modified, the export can share it
+            Contents = context.Image;
         }
 
         public byte[] Contents { get; private set; }
@@ -40,6 +40,11 @@ public string AssemblyName
 
         public CSharpCompilation Compilation { get; private set; }
 
+        // Identifies the generated assembly in the AssemblyNeutralCache, null if it can't be cached
+        public string CacheKey { get; private set; }
+
+        public byte[] Image { get; private set; }
+
         public Stream OutputStream { get; private set; }
         public MetadataReference Reference { get; private set; }
         public EmitResult EmitResult { get; private set; }
@@ -138,13 +143,16 @@ private void AttributeDataSymbolUsage(AttributeData attributeData, Action<ISymbo
             }
         }
 
-        public EmitResult Generate(IDictionary<string, MetadataReference> existingReferences)
+        public IEnumerable<Diagnostic> Generate(IDictionary<string, MetadataReference> existingReferences)
         {
             Compilation = CSharpCompilation.Create(
                 assemblyName: AssemblyName,
                 options: Worker.OriginalCompilation.Options,
                 references: Worker.OriginalCompilation.References);
 
+            var cacheable = Worker.Cache != null && Worker.ReferencesKey != null;
+            var dependencyKeys = new List<string>();
+
             foreach (var other in Requires.Keys)
             {
                 if (other.EmitResult != null && !other.EmitResult.Success)
@@ -159,9 +167,24 @@ public EmitResult Generate(IDictionary<string, MetadataReference> existingRefere
                     continue;
                 }
 
+                if (other.CacheKey == null)
+                {
+                    // A shallow reference or one that couldn't be cached
+                    cacheable = false;
+                }
+                else
+                {
+                    dependencyKeys.Add(other.CacheKey);
+                }
+
                 Compilation = Compilation.AddReferences(other.RealOrShallowReference());
             }
 
+            // The generated source, the options it is parsed and compiled with and everything it references
+            dependencyKeys.Sort(StringComparer.Ordinal);
+            var keyInputs = new List<string> { AssemblyName, Worker.ReferencesKey };
+            keyInputs.AddRange(dependencyKeys);
+
             foreach (var syntaxReference in TypeSymbol.DeclaringSyntaxReferences)
             {
                 var node = syntaxReference.GetSyntax();
@@ -176,20 +199,48 @@ public EmitResult Generate(IDictionary<string, MetadataReference> existingRefere
 
                 // update compilation with code removed
                 Compilation = Compilation.AddSyntaxTrees(newTree);
+
+                var parseOptions = (CSharpParseOptions)tree.Options;
+                keyInputs.Add(string.Join(",", parseOptions.PreprocessorSymbolNames) + parseOptions.LanguageVersion);
+                keyInputs.Add(newRoot.ToFullString());
+            }
+
+            if (cacheable)
+            {
+                CacheKey = AssemblyNeutralCache.ComputeKey(keyInputs.ToArray());
+
+                var image = Worker.Cache.Get(CacheKey);
+                if (image != null)
+                {
+                    SetImage(image);
+                    return Enumerable.Empty<Diagnostic>();
+                }
             }
 
-            OutputStream = new MemoryStream();
-            EmitResult = Compilation.Emit(OutputStream);
+            var outputStream = new MemoryStream();
+            EmitResult = Compilation.Emit(outputStream);
             if (!EmitResult.Success)
             {
-                return EmitResult;
+                OutputStream = outputStream;
+                return EmitResult.Diagnostics;
             }
 
-            OutputStream.Position = 0;
-            Reference = new MetadataImageReference(OutputStream);
-            OutputStream.Position = 0;
+            SetImage(outputStream.ToArray());
 
-            return EmitResult;
+            // Warnings are only reported when the assembly is generated, don't lose them
+            if (CacheKey != null && !EmitResult.Diagnostics.Any())
+            {
+                Worker.Cache.Add(CacheKey, Image);
+            }
+
+            return EmitResult.Diagnostics;
+        }
+
+        private void SetImage(byte[] image)
+        {
+            Image = image;
+            OutputStream = new MemoryStream(image, writable: false);
+            Reference = new MetadataImageReference(image);
         }
 
         private MetadataReference GenerateShallowReference()
@@ -7,6 +7,7 @@
 using System.IO;
 using System.Linq;
 using System.Reflection;
+using System.Runtime.CompilerServices;
 using System.Text;
 using Microsoft.CodeAnalysis;
 using Microsoft.CodeAnalysis.CSharp;
@@ -22,6 +23,8 @@ public class RoslynCompiler
         private readonly IFileWatcher _watcher;
         private readonly IServiceProvider _services;
 
+        private static readonly ConditionalWeakTable<byte[], MetadataReference> _embeddedReferences = new ConditionalWeakTable<byte[], MetadataReference>();
+
         public RoslynCompiler(ICache cache,
                               ICacheContextAccessor cacheContextAccessor,
                               IFileWatcher watcher,
@@ -95,7 +98,7 @@ public class RoslynCompiler
             var aniSw = Stopwatch.StartNew();
             Trace.TraceInformation("[{0}]: Scanning '{1}' for assembly neutral interfaces", GetType().Name, name);
 
-            var assemblyNeutralWorker = new AssemblyNeutralWorker(compilation, embeddedReferences);
+            var assemblyNeutralWorker = new AssemblyNeutralWorker(compilation, embeddedReferences, AssemblyNeutralCache.Default);
             assemblyNeutralWorker.FindTypeCompilations(compilation.Assembly.GlobalNamespace);
 
             assemblyNeutralWorker.OrderTypeCompilations();
@@ -265,7 +268,8 @@ private MetadataReference ConvertMetadataReference(IMetadataReference metadataRe
 
             if (embeddedReference != null)
             {
-                return new MetadataImageReference(embeddedReference.Contents);
+                // The same image shared by every compilation lets Roslyn reuse its symbols
+                return _embeddedReferences.GetValue(embeddedReference.Contents, contents => new MetadataImageReference(contents));
             }
 
             var fileMetadataReference = metadataReference as IMetadataFileReference;
@@ -293,17 +297,19 @@ private MetadataReference ConvertMetadataReference(IMetadataReference metadataRe
 
         private MetadataReference GetMetadataReference(string path)
         {
-            var metadata = _cache.Get<AssemblyMetadata>(path, ctx =>
+            // We don't use the exact path since that might clash with another key. The reference is
+            // shared by every compilation using the cache until the file's write time or size changes.
+            var key = "METADATA_" + path;
+
+            return _cache.Get<MetadataReference>(key, ctx =>
             {
                 ctx.Monitor(new FileWriteTimeCacheDependency(path));
 
                 using (var stream = File.OpenRead(path))
                 {
-                    return AssemblyMetadata.CreateFromImageStream(stream);
+                    return new MetadataImageReference(AssemblyMetadata.CreateFromImageStream(stream));
                 }
             });
-
-            return new MetadataImageReference(metadata);
         }
     }
 }
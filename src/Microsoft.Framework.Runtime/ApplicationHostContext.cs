@@ -1,7 +1,13 @@
 ﻿using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.IO;
+using System.Linq;
 using System.Runtime.Versioning;
+using System.Security.Cryptography;
 using Microsoft.Framework.Runtime.Common.DependencyInjection;
 using Microsoft.Framework.Runtime.FileSystem;
+using NuGet;
 
 namespace Microsoft.Framework.Runtime
 {
@@ -11,6 +17,9 @@ namespace Microsoft.Framework.Runtime
     public class ApplicationHostContext
     {
         private readonly ServiceProvider _serviceProvider;
+        private readonly FrameworkName _targetFramework;
+        private readonly string _configuration;
+        private readonly LibraryGraphCache _libraryGraphCache;
 
         public ApplicationHostContext(IServiceProvider serviceProvider,
                                       string projectDirectory,
@@ -19,7 +28,30 @@ public class ApplicationHostContext
                                       FrameworkName targetFramework,
                                       ICache cache,
                                       ICacheContextAccessor cacheContextAccessor)
+            : this(serviceProvider,
+                   projectDirectory,
+                   packagesDirectory,
+                   configuration,
+                   targetFramework,
+                   cache,
+                   cacheContextAccessor,
+                   libraryGraphCache: null)
         {
+        }
+
+        public ApplicationHostContext(IServiceProvider serviceProvider,
+                                      string projectDirectory,
+                                      string packagesDirectory,
+                                      string configuration,
+                                      FrameworkName targetFramework,
+                                      ICache cache,
+                                      ICacheContextAccessor cacheContextAccessor,
+                                      LibraryGraphCache libraryGraphCache)
+        {
+            _targetFramework = targetFramework;
+            _configuration = configuration;
+            _libraryGraphCache = libraryGraphCache;
+
             ProjectDirectory = projectDirectory;
             RootDirectory = Runtime.ProjectResolver.ResolveRootDirectory(ProjectDirectory);
             ProjectResolver = new ProjectResolver(ProjectDirectory, RootDirectory);
@@ -29,7 +61,11 @@ public class ApplicationHostContext
             PackagesDirectory = packagesDirectory ?? NuGetDependencyResolver.ResolveRepositoryPath(RootDirectory);
 
             var referenceAssemblyDependencyResolver = new ReferenceAssemblyDependencyResolver(FrameworkReferenceResolver);
-            NuGetDependencyProvider = new NuGetDependencyResolver(PackagesDirectory, FrameworkReferenceResolver);
+            var packageRepository = libraryGraphCache != null ?
+                libraryGraphCache.GetPackageRepository(PackagesDirectory) :
+                new PackageRepository(PackagesDirectory);
+
+            NuGetDependencyProvider = new NuGetDependencyResolver(packageRepository, FrameworkReferenceResolver);
             var gacDependencyResolver = new GacDependencyResolver();
             ProjectDepencyProvider = new ProjectReferenceDependencyProvider(ProjectResolver);
             UnresolvedDependencyProvider = new UnresolvedDependencyProvider();
@@ -64,6 +100,205 @@ public class ApplicationHostContext
             _serviceProvider.Add(typeof(ICacheContextAccessor), cacheContextAccessor);
         }
 
+        /// <summary>
+        /// Resolves the project's dependencies, reusing the graph of an identical project from the shared
+        /// <see cref="LibraryGraphCache"/> when there is one. The graph has to be released to the cache
+        /// once this context is no longer used.
+        /// </summary>
+        public LibraryGraph AcquireDependencyGraph()
+        {
+            if (_libraryGraphCache == null)
+            {
+                throw new InvalidOperationException("The context was created without a library graph cache.");
+            }
+
+            var project = Project;
+            var key = new LibraryGraphKey(project.ProjectFilePath,
+                                          HashFile(project.ProjectFilePath),
+                                          _targetFramework,
+                                          _configuration);
+
+            var walked = false;
+            var graph = _libraryGraphCache.Acquire(key, k =>
+            {
+                walked = true;
+                DependencyWalker.Walk(project.Name, project.Version, _targetFramework);
+                return new LibraryGraph(k, DependencyWalker.GraphNodes, GetGraphDependencies());
+            });
+
+            if (!walked)
+            {
+                DependencyWalker.Initialize(graph, _targetFramework);
+            }
+
+            return graph;
+        }
+
+        private static string HashFile(string path)
+        {
+            using (var sha = SHA256.Create())
+            {
+                return BitConverter.ToString(sha.ComputeHash(File.ReadAllBytes(path))).Replace("-", string.Empty);
+            }
+        }
+
+        private IEnumerable<ICacheDependency> GetGraphDependencies()
+        {
+            return GetInputPaths().Select(path => new FileWriteTimeCacheDependency(path));
+        }
+
+        private IEnumerable<string> GetInputPaths()
+        {
+            // Project search paths
+            yield return Path.Combine(RootDirectory, GlobalSettings.GlobalFileName);
+
+            foreach (var library in DependencyWalker.Libraries)
+            {
+                if (library.Type == "Project")
+                {
+                    yield return library.Path;
+                }
+                else if (library.Type != "Assembly")
+                {
+                    // Packages (and unresolved dependencies that might become packages) change
+                    // when a version is installed into the package id folder
+                    yield return Path.Combine(PackagesDirectory, library.Identity.Name);
+                }
+            }
+        }
+
+        /// <summary>
+        /// Captures the result of the last dependency walk so a later run can skip it, see <see cref="TryInitializeFromLockFile"/>.
+        /// </summary>
+        public LockFileTarget CreateLockFileTarget()
+        {
+            var target = new LockFileTarget
+            {
+                TargetFramework = _targetFramework
+            };
+
+            var libraries = DependencyWalker.Libraries.ToDictionary(library => library.Identity);
+            foreach (var node in DependencyWalker.GraphNodes)
+            {
+                var library = new LockFileLibrary
+                {
+                    Identity = node.Identity,
+                    ProviderIndex = node.ProviderIndex
+                };
+
+                LibraryDescription description;
+                if (libraries.TryGetValue(node.Identity, out description))
+                {
+                    library.Type = description.Type;
+                    library.Path = description.Path;
+                }
+
+                library.Dependencies.AddRange(node.Dependencies);
+                target.Libraries.Add(library);
+            }
+
+            foreach (var pair in NuGetDependencyProvider.PackageAssemblyLookup)
+            {
+                target.PackageAssemblies.Add(new LockFileAssembly
+                {
+                    Name = pair.Key,
+                    Path = pair.Value.Path,
+                    LibraryName = pair.Value.Library.Identity.Name
+                });
+            }
+
+            target.InputPaths.AddRange(GetInputPaths().Distinct());
+            target.Hash = ComputeLockFileHash(target.InputPaths);
+
+            return target;
+        }
+
+        /// <summary>
+        /// Initializes the dependency providers from the lock file written by restore. Returns false when
+        /// there is no lock file for the target framework or anything it was computed from has changed,
+        /// the dependencies have to be walked in that case.
+        /// </summary>
+        public bool TryInitializeFromLockFile()
+        {
+            LockFile lockFile;
+            if (!LockFile.TryReadLockFile(ProjectDirectory, out lockFile))
+            {
+                return false;
+            }
+
+            var target = lockFile.GetTarget(_targetFramework);
+            if (target == null)
+            {
+                Trace.TraceInformation("[{0}]: No lock file entry for {1}", GetType().Name, _targetFramework);
+                return false;
+            }
+
+            if (target.Hash != ComputeLockFileHash(target.InputPaths))
+            {
+                Trace.TraceInformation("[{0}]: Lock file for {1} is out of date", GetType().Name, _targetFramework);
+                return false;
+            }
+
+            var providers = DependencyWalker.DependencyProviders.ToList();
+            foreach (var group in target.Libraries.GroupBy(library => library.ProviderIndex))
+            {
+                var descriptions = group.Select(library => new LibraryDescription
+                {
+                    Identity = library.Identity,
+                    Type = library.Type,
+                    Path = library.Path,
+                    Dependencies = library.Dependencies
+                })
+                .ToList();
+
+                var provider = providers[group.Key];
+                if (provider == NuGetDependencyProvider)
+                {
+                    // Package assemblies were resolved by restore, no nuspec has to be read
+                    NuGetDependencyProvider.Initialize(descriptions, target.PackageAssemblies);
+                }
+                else
+                {
+                    provider.Initialize(descriptions, _targetFramework);
+                }
+
+                DependencyWalker.Libraries.AddRange(descriptions);
+            }
+
+            return true;
+        }
+
+        private ulong ComputeLockFileHash(IEnumerable<string> inputPaths)
+        {
+            // FNV-1a over everything that can change the outcome of a walk. Write times stand in for
+            // the contents of the inputs so validating a lock file costs one stat per input
+            var hash = 14695981039346656037UL;
+            Action<string> add = value =>
+            {
+                foreach (var ch in value ?? string.Empty)
+                {
+                    hash = (hash ^ ch) * 1099511628211UL;
+                }
+                hash = (hash ^ 0xFFFF) * 1099511628211UL;
+            };
+
+            add(LockFile.FormatVersion.ToString());
+            add(_targetFramework.FullName);
+            // The configuration is left out on purpose: it only selects compilation options, project.json
+            // can't declare dependencies per configuration, so every configuration walks to the same closure
+            add(File.ReadAllText(Project.ProjectFilePath));
+            add(Path.GetFullPath(PackagesDirectory));
+            add(Environment.GetEnvironmentVariable("KRE_PACKAGES_CACHE"));
+
+            foreach (var path in inputPaths)
+            {
+                add(path);
+                add(File.GetLastWriteTimeUtc(path).Ticks.ToString());
+            }
+
+            return hash;
+        }
+
         public void AddService(Type type, object instance)
         {
             _serviceProvider.Add(type, instance);
@@ -2,6 +2,7 @@
 using System.Collections.Concurrent;
 using System.Collections.Generic;
 using System.Linq;
+using System.Threading;
 
 namespace Microsoft.Framework.Runtime
 {
@@ -9,14 +10,45 @@ public class Cache : ICache
     {
         private readonly ConcurrentDictionary<object, Lazy<CacheEntry>> _entries = new ConcurrentDictionary<object, Lazy<CacheEntry>>();
         private readonly ICacheContextAccessor _accessor;
+        private readonly ICacheDependencyWatcher _watcher;
+
+        private long _hits;
+        private long _misses;
+        private long _invalidations;
 
         public Cache(ICacheContextAccessor accessor)
+            : this(accessor, watcher: null)
+        {
+        }
+
+        public Cache(ICacheContextAccessor accessor, ICacheDependencyWatcher watcher)
         {
             _accessor = accessor;
+            _watcher = watcher;
         }
 
+        public long Hits { get { return Interlocked.Read(ref _hits); } }
+
+        public long Misses { get { return Interlocked.Read(ref _misses); } }
+
+        public long Invalidations { get { return Interlocked.Read(ref _invalidations); } }
+
         public object Get(object key, Func<CacheContext, object> factory)
         {
+            // Fast path: watched dependencies mark the entry expired when they change so a hit
+            // only has to poll the dependencies that couldn't be watched
+            Lazy<CacheEntry> current;
+            if (_entries.TryGetValue(key, out current) && current.IsValueCreated)
+            {
+                var value = current.Value;
+                if (!value.IsExpired)
+                {
+                    Interlocked.Increment(ref _hits);
+                    PropagateCacheDependencies(value);
+                    return value.Result;
+                }
+            }
+
             var entry = _entries.AddOrUpdate(key,
                 k => AddEntry(k, factory),
                 (k, oldValue) => UpdateEntry(oldValue, k, factory));
@@ -38,9 +70,7 @@ private Lazy<CacheEntry> UpdateEntry(Lazy<CacheEntry> currentEntry, object k, Fu
         {
             try
             {
-                bool expired = currentEntry.Value.Dependencies.Any(t => t.HasChanged);
-
-                if (expired)
+                if (currentEntry.Value.IsExpired)
                 {
                     return AddEntry(k, acquire);
                 }
@@ -49,6 +79,7 @@ private Lazy<CacheEntry> UpdateEntry(Lazy<CacheEntry> currentEntry, object k, Fu
                     // Trace.TraceInformation("[{0}]: Cache hit for {1}", GetType().Name, k);
 
                     // Already evaluated
+                    Interlocked.Increment(ref _hits);
                     PropagateCacheDependencies(currentEntry.Value);
                     return currentEntry;
                 }
@@ -73,7 +104,7 @@ private void PropagateCacheDependencies(CacheEntry entry)
 
         private CacheEntry CreateEntry(object k, Func<CacheContext, object> acquire)
         {
-            var entry = new CacheEntry();
+            var entry = new CacheEntry(this);
             var context = new CacheContext(k, entry.AddCacheDependency);
             CacheContext parentContext = null;
             try
@@ -91,24 +122,114 @@ private CacheEntry CreateEntry(object k, Func<CacheContext, object> acquire)
             }
 
             // Trace.TraceInformation("[{0}]: Cache miss for {1}", GetType().Name, k);
+            Interlocked.Increment(ref _misses);
 
             entry.CompactCacheDependencies();
+            entry.Watch(_watcher);
             return entry;
         }
 
         private class CacheEntry
         {
+            private static readonly ICacheDependency[] EmptyDependencies = new ICacheDependency[0];
+
+            private readonly Cache _cache;
             private IList<ICacheDependency> _dependencies;
+            private ICacheDependency[] _polledDependencies = EmptyDependencies;
+            private IDisposable[] _registrations;
+            private int _expired;
 
-            public CacheEntry()
+            public CacheEntry(Cache cache)
             {
-
+                _cache = cache;
             }
 
             public IEnumerable<ICacheDependency> Dependencies { get { return _dependencies ?? Enumerable.Empty<ICacheDependency>(); } }
 
             public object Result { get; set; }
 
+            public bool IsExpired
+            {
+                get
+                {
+                    if (Volatile.Read(ref _expired) != 0)
+                    {
+                        return true;
+                    }
+
+                    foreach (var dependency in _polledDependencies)
+                    {
+                        if (dependency.HasChanged)
+                        {
+                            Expire();
+                            return true;
+                        }
+                    }
+
+                    return false;
+                }
+            }
+
+            public void Watch(ICacheDependencyWatcher watcher)
+            {
+                if (_dependencies == null)
+                {
+                    return;
+                }
+
+                if (watcher == null)
+                {
+                    _polledDependencies = _dependencies.ToArray();
+                    return;
+                }
+
+                var polled = new List<ICacheDependency>();
+                var registrations = new List<IDisposable>();
+
+                foreach (var dependency in _dependencies)
+                {
+                    var registration = watcher.Watch(dependency, Expire);
+                    if (registration == null)
+                    {
+                        polled.Add(dependency);
+                    }
+                    else
+                    {
+                        registrations.Add(registration);
+                    }
+                }
+
+                _polledDependencies = polled.ToArray();
+                _registrations = registrations.ToArray();
+
+                // Catch changes that happened between creating the dependencies and watching them
+                if (_dependencies.Any(d => d.HasChanged))
+                {
+                    Expire();
+                }
+            }
+
+            private void Unwatch()
+            {
+                var registrations = Interlocked.Exchange(ref _registrations, null);
+                if (registrations != null)
+                {
+                    foreach (var registration in registrations)
+                    {
+                        registration.Dispose();
+                    }
+                }
+            }
+
+            private void Expire()
+            {
+                if (Interlocked.Exchange(ref _expired, 1) == 0)
+                {
+                    Interlocked.Increment(ref _cache._invalidations);
+                    Unwatch();
+                }
+            }
+
             public void AddCacheDependency(ICacheDependency cacheDependency)
             {
                 if (_dependencies == null)
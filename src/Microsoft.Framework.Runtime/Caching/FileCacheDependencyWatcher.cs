@@ -0,0 +1,339 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.IO;
+using System.Linq;
+
+namespace Microsoft.Framework.Runtime
+{
+    /// <summary>
+    /// Watches <see cref="FileWriteTimeCacheDependency"/> instances with <see cref="FileSystemWatcher"/>s shared by
+    /// all entries that depend on files under them. Files of a project share one recursive watcher on the project
+    /// directory, any other file a non recursive one on its directory. Past a maximum number of watchers the
+    /// dependencies are polled instead.
+    /// </summary>
+    public class FileCacheDependencyWatcher : ICacheDependencyWatcher, IDisposable
+    {
+        public const int DefaultMaxWatchers = 64;
+
+        private readonly Dictionary<string, DirectoryWatch> _directories = new Dictionary<string, DirectoryWatch>(StringComparer.OrdinalIgnoreCase);
+        private readonly Dictionary<string, string> _projectDirectories = new Dictionary<string, string>(StringComparer.OrdinalIgnoreCase);
+        private readonly object _sync = new object();
+        private readonly int _maxWatchers;
+
+        public FileCacheDependencyWatcher()
+            : this(DefaultMaxWatchers)
+        {
+        }
+
+        public FileCacheDependencyWatcher(int maxWatchers)
+        {
+            _maxWatchers = maxWatchers;
+        }
+
+        public IDisposable Watch(ICacheDependency dependency, Action onChanged)
+        {
+            var fileDependency = dependency as FileWriteTimeCacheDependency;
+            if (fileDependency == null || !File.Exists(fileDependency.Path))
+            {
+                // Directory write times don't reliably raise events for the directory itself
+                return null;
+            }
+
+            var path = Path.GetFullPath(fileDependency.Path);
+            var directory = Path.GetDirectoryName(path);
+
+            lock (_sync)
+            {
+                var projectDirectory = GetProjectDirectory(directory);
+                var watchedDirectory = projectDirectory ?? directory;
+
+                DirectoryWatch watch;
+                if (!_directories.TryGetValue(watchedDirectory, out watch))
+                {
+                    if (_directories.Count >= _maxWatchers)
+                    {
+                        return null;
+                    }
+
+                    watch = DirectoryWatch.Create(this, watchedDirectory, recursive: projectDirectory != null);
+                    if (watch == null)
+                    {
+                        return null;
+                    }
+
+                    _directories[watchedDirectory] = watch;
+                }
+
+                return watch.Add(path, dependency, onChanged);
+            }
+        }
+
+        /// <summary>
+        /// Checks every watched file now. Events are raised asynchronously, so a change made just before
+        /// may not have been reported yet.
+        /// </summary>
+        public void Flush()
+        {
+            DirectoryWatch[] watches;
+            lock (_sync)
+            {
+                watches = _directories.Values.ToArray();
+            }
+
+            foreach (var watch in watches)
+            {
+                watch.Flush();
+            }
+        }
+
+        private string GetProjectDirectory(string directory)
+        {
+            // Called under _sync
+            string projectDirectory;
+            if (_projectDirectories.TryGetValue(directory, out projectDirectory))
+            {
+                return projectDirectory;
+            }
+
+            if (File.Exists(Path.Combine(directory, Project.ProjectFileName)))
+            {
+                projectDirectory = directory;
+            }
+            else
+            {
+                var parent = Path.GetDirectoryName(directory);
+                projectDirectory = parent == null ? null : GetProjectDirectory(parent);
+            }
+
+            _projectDirectories[directory] = projectDirectory;
+            return projectDirectory;
+        }
+
+        public void Dispose()
+        {
+            lock (_sync)
+            {
+                foreach (var watch in _directories.Values)
+                {
+                    watch.Dispose();
+                }
+
+                _directories.Clear();
+            }
+        }
+
+        private void Remove(DirectoryWatch watch)
+        {
+            // Called under _sync
+            _directories.Remove(watch.Directory);
+            watch.Dispose();
+        }
+
+        private class DirectoryWatch : IDisposable
+        {
+            private readonly FileCacheDependencyWatcher _owner;
+            private readonly FileSystemWatcher _watcher;
+            private readonly Dictionary<string, List<Registration>> _files = new Dictionary<string, List<Registration>>(StringComparer.OrdinalIgnoreCase);
+            private int _count;
+
+            private DirectoryWatch(FileCacheDependencyWatcher owner, string directory, FileSystemWatcher watcher)
+            {
+                _owner = owner;
+                _watcher = watcher;
+                Directory = directory;
+
+                _watcher.Changed += OnChanged;
+                _watcher.Created += OnChanged;
+                _watcher.Deleted += OnChanged;
+                _watcher.Renamed += OnRenamed;
+                _watcher.Error += OnError;
+                _watcher.EnableRaisingEvents = true;
+            }
+
+            public string Directory { get; private set; }
+
+            public static DirectoryWatch Create(FileCacheDependencyWatcher owner, string directory, bool recursive)
+            {
+                try
+                {
+                    var watcher = new FileSystemWatcher(directory);
+                    watcher.IncludeSubdirectories = recursive;
+                    return new DirectoryWatch(owner, directory, watcher);
+                }
+                catch (Exception ex)
+                {
+                    // Out of watch handles or an unsupported file system, entries are polled instead
+                    Trace.TraceInformation("[{0}]: Unable to watch {1}: {2}", typeof(FileCacheDependencyWatcher).Name, directory, ex.Message);
+                    return null;
+                }
+            }
+
+            public IDisposable Add(string path, ICacheDependency dependency, Action onChanged)
+            {
+                List<Registration> registrations;
+                if (!_files.TryGetValue(path, out registrations))
+                {
+                    registrations = new List<Registration>();
+                    _files[path] = registrations;
+                }
+
+                var registration = new Registration(this, path, dependency, onChanged);
+                registrations.Add(registration);
+                _count++;
+                return registration;
+            }
+
+            public void Flush()
+            {
+                Registration[] registrations;
+                lock (_owner._sync)
+                {
+                    registrations = _files.Values.SelectMany(r => r).ToArray();
+                }
+
+                foreach (var registration in registrations)
+                {
+                    if (registration.Dependency.HasChanged)
+                    {
+                        registration.Fire();
+                    }
+                }
+            }
+
+            public void Dispose()
+            {
+                _watcher.EnableRaisingEvents = false;
+                _watcher.Dispose();
+            }
+
+            private void Remove(Registration registration)
+            {
+                lock (_owner._sync)
+                {
+                    List<Registration> registrations;
+                    if (_files.TryGetValue(registration.Path, out registrations) && registrations.Remove(registration))
+                    {
+                        if (registrations.Count == 0)
+                        {
+                            _files.Remove(registration.Path);
+                        }
+
+                        if (--_count == 0)
+                        {
+                            _owner.Remove(this);
+                        }
+                    }
+                }
+            }
+
+            private void OnChanged(object sender, FileSystemEventArgs e)
+            {
+                Notify(e.FullPath);
+            }
+
+            private void OnRenamed(object sender, RenamedEventArgs e)
+            {
+                Notify(e.OldFullPath);
+                Notify(e.FullPath);
+            }
+
+            private void OnError(object sender, ErrorEventArgs e)
+            {
+                // Events were dropped, assume every file in the directory changed
+                Registration[] registrations;
+                lock (_owner._sync)
+                {
+                    registrations = _files.Values.SelectMany(r => r).ToArray();
+                }
+
+                foreach (var registration in registrations)
+                {
+                    registration.Fire();
+                }
+            }
+
+            private void Notify(string path)
+            {
+                Registration[] registrations;
+                lock (_owner._sync)
+                {
+                    List<Registration> list;
+                    if (!_files.TryGetValue(path, out list))
+                    {
+                        return;
+                    }
+
+                    registrations = list.ToArray();
+                }
+
+                foreach (var registration in registrations)
+                {
+                    registration.Fire();
+                }
+            }
+
+            private class Registration : IDisposable
+            {
+                private readonly DirectoryWatch _watch;
+                private readonly object _fireLock = new object();
+                private Action _onChanged;
+
+                public Registration(DirectoryWatch watch, string path, ICacheDependency dependency, Action onChanged)
+                {
+                    _watch = watch;
+                    _onChanged = onChanged;
+                    Path = path;
+                    Dependency = dependency;
+                }
+
+                public string Path { get; private set; }
+
+                public ICacheDependency Dependency { get; private set; }
+
+                public void Fire()
+                {
+                    // Registrations fire once. The callback runs under the lock so a Flush racing with the
+                    // watcher event returns only after the entry was expired
+                    var fired = false;
+                    lock (_fireLock)
+                    {
+                        var onChanged = _onChanged;
+                        if (onChanged != null)
+                        {
+                            _onChanged = null;
+                            onChanged();
+                            fired = true;
+                        }
+                    }
+
+                    if (fired)
+                    {
+                        _watch.Remove(this);
+                    }
+                }
+
+                public void Dispose()
+                {
+                    var disposed = false;
+                    lock (_fireLock)
+                    {
+                        if (_onChanged != null)
+                        {
+                            _onChanged = null;
+                            disposed = true;
+                        }
+                    }
+
+                    if (disposed)
+                    {
+                        _watch.Remove(this);
+                    }
+                }
+            }
+        }
+    }
+}
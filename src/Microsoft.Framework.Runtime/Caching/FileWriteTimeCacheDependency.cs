@@ -7,21 +7,50 @@ public class FileWriteTimeCacheDependency : ICacheDependency
     {
         private readonly string _path;
         private readonly DateTime _lastWriteTime;
+        private readonly long _length;
 
         public FileWriteTimeCacheDependency(string path)
         {
             _path = path;
-            _lastWriteTime = File.GetLastWriteTime(path);
+            GetFileIdentity(path, out _lastWriteTime, out _length);
+        }
+
+        public string Path
+        {
+            get
+            {
+                return _path;
+            }
         }
 
         public bool HasChanged
         {
             get
             {
-                return _lastWriteTime < File.GetLastWriteTime(_path);
+                // A file restored from elsewhere can be older than the one it replaces
+                DateTime lastWriteTime;
+                long length;
+                GetFileIdentity(_path, out lastWriteTime, out length);
+
+                return lastWriteTime != _lastWriteTime || length != _length;
             }
         }
 
+        private static void GetFileIdentity(string path, out DateTime lastWriteTime, out long length)
+        {
+            var file = new FileInfo(path);
+            if (file.Exists)
+            {
+                lastWriteTime = file.LastWriteTimeUtc;
+                length = file.Length;
+                return;
+            }
+
+            // Directories and missing files only have a write time
+            lastWriteTime = File.GetLastWriteTimeUtc(path);
+            length = -1;
+        }
+
         public override string ToString()
         {
             return _path;
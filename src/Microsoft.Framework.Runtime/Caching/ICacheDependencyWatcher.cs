@@ -0,0 +1,25 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+using System;
+
+namespace Microsoft.Framework.Runtime
+{
+    /// <summary>
+    /// Reports changes to cache dependencies so cached entries don't have to poll them on every lookup.
+    /// </summary>
+    public interface ICacheDependencyWatcher
+    {
+        /// <summary>
+        /// Calls <paramref name="onChanged"/> once when the dependency changes. Returns null if the
+        /// dependency can't be watched, the cache then falls back to polling <see cref="ICacheDependency.HasChanged"/>.
+        /// </summary>
+        IDisposable Watch(ICacheDependency dependency, Action onChanged);
+
+        /// <summary>
+        /// Checks the watched dependencies now and reports the ones that changed, for changes that haven't
+        /// been reported yet.
+        /// </summary>
+        void Flush();
+    }
+}
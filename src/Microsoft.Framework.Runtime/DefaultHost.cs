@@ -23,6 +23,7 @@ public class DefaultHost : IDisposable
         private ApplicationHostContext _applicationHostContext;
 
         private IFileWatcher _watcher;
+        private AppBundle _bundle;
         private readonly string _projectDirectory;
         private readonly FrameworkName _targetFramework;
         private readonly ApplicationShutdown _shutdown = new ApplicationShutdown();
@@ -72,6 +73,13 @@ public Assembly GetEntryPoint(string applicationName)
 
         public void Initialize()
         {
+            // Restore writes the resolved closure next to project.json, only walk when it is out of date
+            if (_applicationHostContext.TryInitializeFromLockFile())
+            {
+                Trace.TraceInformation("[{0}]: Loaded dependencies from {1}", GetType().Name, LockFile.FileName);
+                return;
+            }
+
             _applicationHostContext.DependencyWalker.Walk(Project.Name, Project.Version, _targetFramework);
         }
 
@@ -88,6 +96,14 @@ public IDisposable AddLoaders(IAssemblyLoaderContainer container)
             {
                 var loader = (IAssemblyLoader)ActivatorUtilities.CreateInstance(ServiceProvider, loaderType);
                 disposables.Add(container.AddLoader(loader));
+
+                if (loaderType == typeof(ProjectAssemblyLoader) && _bundle != null)
+                {
+                    // Packages in the bundle come before the same packages on disk
+                    var loaderEngine = (IAssemblyLoaderEngine)ServiceProvider.GetService(typeof(IAssemblyLoaderEngine));
+                    var bundleLoader = new BundleAssemblyLoader(loaderEngine, _bundle, _applicationHostContext.NuGetDependencyProvider);
+                    disposables.Add(container.AddLoader(bundleLoader));
+                }
             }
 
             return new DisposableAction(() =>
@@ -102,6 +118,11 @@ public IDisposable AddLoaders(IAssemblyLoaderContainer container)
         public void Dispose()
         {
             _watcher.Dispose();
+
+            if (_bundle != null)
+            {
+                _bundle.Dispose();
+            }
         }
 
         private void Initialize(DefaultHostOptions options, IServiceProvider hostServices)
@@ -124,6 +145,9 @@ private void Initialize(DefaultHostOptions options, IServiceProvider hostService
 
             _project = _applicationHostContext.Project;
 
+            // kpm pack --bundle writes it into the application root, next to global.json
+            _bundle = AppBundle.Open(_applicationHostContext.RootDirectory);
+
             if (Project == null)
             {
                 throw new Exception("Unable to locate " + Project.ProjectFileName);
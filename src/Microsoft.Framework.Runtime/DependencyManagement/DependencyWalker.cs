@@ -3,6 +3,7 @@
 
 using System.Collections.Generic;
 using System.Diagnostics;
+using System.Linq;
 using System.Runtime.Versioning;
 using NuGet;
 
@@ -10,12 +11,12 @@ namespace Microsoft.Framework.Runtime
 {
     public class DependencyWalker
     {
-        private readonly IEnumerable<IDependencyProvider> _dependencyProviders;
+        private readonly IList<IDependencyProvider> _dependencyProviders;
         private readonly List<LibraryDescription> _libraries = new List<LibraryDescription>();
 
         public DependencyWalker(IEnumerable<IDependencyProvider> dependencyProviders)
         {
-            _dependencyProviders = dependencyProviders;
+            _dependencyProviders = dependencyProviders.ToList();
         }
 
         public IList<LibraryDescription> Libraries
@@ -46,8 +47,41 @@ public void Walk(string name, SemanticVersion version, FrameworkName targetFrame
 
             context.Populate(targetFramework, Libraries);
 
+            GraphNodes = context.GetGraphNodes(_dependencyProviders);
+
             sw.Stop();
             Trace.TraceInformation("[{0}]: Resolved dependencies for {1} in {2}ms", GetType().Name, name, sw.ElapsedMilliseconds);
         }
+
+        /// <summary>
+        /// The nodes resolved by the last <see cref="Walk"/>, used to build a <see cref="LibraryGraph"/>.
+        /// </summary>
+        public IList<LibraryGraphNode> GraphNodes { get; private set; }
+
+        /// <summary>
+        /// Populates <see cref="Libraries"/> from a graph produced by an earlier walk instead of walking again.
+        /// </summary>
+        public void Initialize(LibraryGraph graph, FrameworkName targetFramework)
+        {
+            var sw = Stopwatch.StartNew();
+
+            foreach (var group in graph.Nodes.GroupBy(node => node.ProviderIndex))
+            {
+                var descriptions = group.Select(node => new LibraryDescription
+                {
+                    Identity = node.Identity,
+                    Dependencies = node.Dependencies
+                })
+                .ToList();
+
+                _dependencyProviders[group.Key].Initialize(descriptions, targetFramework);
+                Libraries.AddRange(descriptions);
+            }
+
+            GraphNodes = graph.Nodes;
+
+            sw.Stop();
+            Trace.TraceInformation("[{0}]: Initialized dependencies for {1} from a shared graph in {2}ms", GetType().Name, graph.Key, sw.ElapsedMilliseconds);
+        }
     }
 }
@@ -0,0 +1,64 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+using System.Collections.Generic;
+using System.Linq;
+using System.Threading;
+
+namespace Microsoft.Framework.Runtime
+{
+    /// <summary>
+    /// The immutable result of a dependency walk. Nodes refer to dependency providers by their position in
+    /// <see cref="DependencyWalker.DependencyProviders"/> so the same graph can initialize any walker built
+    /// with the same provider layout.
+    /// </summary>
+    public class LibraryGraph
+    {
+        private int _references;
+
+        public LibraryGraph(LibraryGraphKey key, IList<LibraryGraphNode> nodes, IEnumerable<ICacheDependency> dependencies)
+        {
+            Key = key;
+            Nodes = nodes;
+            Dependencies = dependencies.Distinct().ToArray();
+        }
+
+        public LibraryGraphKey Key { get; private set; }
+
+        public IList<LibraryGraphNode> Nodes { get; private set; }
+
+        // Files and folders that invalidate the graph when they change
+        public IList<ICacheDependency> Dependencies { get; private set; }
+
+        public bool HasChanged
+        {
+            get { return Dependencies.Any(d => d.HasChanged); }
+        }
+
+        internal int AddReference()
+        {
+            return Interlocked.Increment(ref _references);
+        }
+
+        internal int Release()
+        {
+            return Interlocked.Decrement(ref _references);
+        }
+    }
+
+    public class LibraryGraphNode
+    {
+        public LibraryGraphNode(Library identity, int providerIndex, IList<Library> dependencies)
+        {
+            Identity = identity;
+            ProviderIndex = providerIndex;
+            Dependencies = dependencies;
+        }
+
+        public Library Identity { get; private set; }
+
+        public int ProviderIndex { get; private set; }
+
+        public IList<Library> Dependencies { get; private set; }
+    }
+}
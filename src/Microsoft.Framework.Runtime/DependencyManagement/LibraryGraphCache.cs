@@ -0,0 +1,74 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+using System;
+using System.Collections.Concurrent;
+using NuGet;
+
+namespace Microsoft.Framework.Runtime
+{
+    /// <summary>
+    /// Process wide store of resolved dependency graphs and package repositories. Hosts that keep many
+    /// projects loaded (e.g. the design time host) share one instance so identical walks and nuspec
+    /// parsing happen once.
+    /// </summary>
+    public class LibraryGraphCache
+    {
+        private readonly ConcurrentDictionary<string, PackageRepository> _repositories = new ConcurrentDictionary<string, PackageRepository>(StringComparer.OrdinalIgnoreCase);
+        private readonly ConcurrentDictionary<LibraryGraphKey, LibraryGraph> _graphs = new ConcurrentDictionary<LibraryGraphKey, LibraryGraph>();
+        private readonly object _sync = new object();
+
+        public PackageRepository GetPackageRepository(string packagesDirectory)
+        {
+            return _repositories.GetOrAdd(packagesDirectory, path => new PackageRepository(path, detectChanges: true));
+        }
+
+        /// <summary>
+        /// Returns the graph for <paramref name="key"/>, walking with <paramref name="factory"/> if there is none
+        /// or any of its dependencies changed. Every call must be balanced by <see cref="Release"/>.
+        /// </summary>
+        public LibraryGraph Acquire(LibraryGraphKey key, Func<LibraryGraphKey, LibraryGraph> factory)
+        {
+            LibraryGraph graph;
+            lock (_sync)
+            {
+                if (_graphs.TryGetValue(key, out graph) && !graph.HasChanged)
+                {
+                    graph.AddReference();
+                    return graph;
+                }
+            }
+
+            // Walk outside of the lock, a concurrent miss for the same key only costs a duplicate walk
+            var created = factory(key);
+
+            lock (_sync)
+            {
+                if (!_graphs.TryGetValue(key, out graph) || graph.HasChanged)
+                {
+                    // Existing holders keep their (stale) graph until they release it
+                    graph = created;
+                    _graphs[key] = graph;
+                }
+
+                graph.AddReference();
+                return graph;
+            }
+        }
+
+        public void Release(LibraryGraph graph)
+        {
+            lock (_sync)
+            {
+                LibraryGraph current;
+                if (graph.Release() == 0 &&
+                    _graphs.TryGetValue(graph.Key, out current) &&
+                    ReferenceEquals(current, graph))
+                {
+                    LibraryGraph removed;
+                    _graphs.TryRemove(graph.Key, out removed);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,59 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+using System;
+using System.Runtime.Versioning;
+
+namespace Microsoft.Framework.Runtime
+{
+    public class LibraryGraphKey : IEquatable<LibraryGraphKey>
+    {
+        public LibraryGraphKey(string projectPath, string projectHash, FrameworkName targetFramework, string configuration)
+        {
+            ProjectPath = projectPath;
+            ProjectHash = projectHash;
+            TargetFramework = targetFramework;
+            Configuration = configuration;
+        }
+
+        public string ProjectPath { get; private set; }
+
+        // Of the project.json contents, any edit produces a different key
+        public string ProjectHash { get; private set; }
+
+        public FrameworkName TargetFramework { get; private set; }
+
+        public string Configuration { get; private set; }
+
+        public bool Equals(LibraryGraphKey other)
+        {
+            return other != null &&
+                   string.Equals(ProjectPath, other.ProjectPath, StringComparison.OrdinalIgnoreCase) &&
+                   string.Equals(ProjectHash, other.ProjectHash, StringComparison.Ordinal) &&
+                   Equals(TargetFramework, other.TargetFramework) &&
+                   string.Equals(Configuration, other.Configuration, StringComparison.Ordinal);
+        }
+
+        public override bool Equals(object obj)
+        {
+            return Equals(obj as LibraryGraphKey);
+        }
+
+        public override int GetHashCode()
+        {
+            unchecked
+            {
+                var hash = StringComparer.OrdinalIgnoreCase.GetHashCode(ProjectPath ?? string.Empty);
+                hash = (hash * 397) ^ (ProjectHash ?? string.Empty).GetHashCode();
+                hash = (hash * 397) ^ (TargetFramework != null ? TargetFramework.GetHashCode() : 0);
+                hash = (hash * 397) ^ (Configuration ?? string.Empty).GetHashCode();
+                return hash;
+            }
+        }
+
+        public override string ToString()
+        {
+            return ProjectPath + " " + TargetFramework + " " + Configuration;
+        }
+    }
+}
@@ -0,0 +1,226 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.IO;
+using System.Linq;
+using System.Runtime.Versioning;
+using NuGet;
+
+namespace Microsoft.Framework.Runtime
+{
+    /// <summary>
+    /// The dependency closures resolved by restore, stored next to project.json so the runtime can
+    /// load an application without walking its dependencies again.
+    /// </summary>
+    public class LockFile
+    {
+        public const string FileName = "project.lock.bin";
+
+        // "KLCK"
+        private const int Signature = 0x4B434C4B;
+
+        // Bump when the layout or the meaning of provider indexes changes
+        internal const int FormatVersion = 1;
+
+        public LockFile()
+        {
+            Targets = new List<LockFileTarget>();
+        }
+
+        public IList<LockFileTarget> Targets { get; private set; }
+
+        public LockFileTarget GetTarget(FrameworkName targetFramework)
+        {
+            return Targets.FirstOrDefault(t => Equals(t.TargetFramework, targetFramework));
+        }
+
+        public static bool TryReadLockFile(string projectDirectory, out LockFile lockFile)
+        {
+            lockFile = null;
+
+            var path = Path.Combine(projectDirectory, FileName);
+            if (!File.Exists(path))
+            {
+                return false;
+            }
+
+            try
+            {
+                // The file is small, one read keeps startup to a single I/O
+                using (var reader = new BinaryReader(new MemoryStream(File.ReadAllBytes(path))))
+                {
+                    lockFile = Read(reader);
+                }
+            }
+            catch (Exception ex)
+            {
+                Trace.TraceInformation("[{0}]: Ignoring {1}: {2}", typeof(LockFile).Name, path, ex.Message);
+                lockFile = null;
+            }
+
+            return lockFile != null;
+        }
+
+        public void Write(string projectDirectory)
+        {
+            var path = Path.Combine(projectDirectory, FileName);
+            var tempPath = path + ".tmp";
+
+            using (var writer = new BinaryWriter(new FileStream(tempPath, FileMode.Create, FileAccess.Write, FileShare.None)))
+            {
+                Write(writer);
+            }
+
+            // Readers never see a partially written file
+            if (File.Exists(path))
+            {
+                File.Delete(path);
+            }
+            File.Move(tempPath, path);
+        }
+
+        private static LockFile Read(BinaryReader reader)
+        {
+            if (reader.ReadInt32() != Signature || reader.ReadInt32() != FormatVersion)
+            {
+                return null;
+            }
+
+            var lockFile = new LockFile();
+            var targetCount = reader.ReadInt32();
+            for (var i = 0; i < targetCount; i++)
+            {
+                var target = new LockFileTarget
+                {
+                    TargetFramework = new FrameworkName(reader.ReadString()),
+                    Hash = reader.ReadUInt64()
+                };
+
+                var pathCount = reader.ReadInt32();
+                for (var j = 0; j < pathCount; j++)
+                {
+                    target.InputPaths.Add(reader.ReadString());
+                }
+
+                var libraryCount = reader.ReadInt32();
+                for (var j = 0; j < libraryCount; j++)
+                {
+                    var library = new LockFileLibrary
+                    {
+                        Identity = ReadLibrary(reader),
+                        ProviderIndex = reader.ReadInt32(),
+                        Type = ReadNullableString(reader),
+                        Path = ReadNullableString(reader)
+                    };
+
+                    var dependencyCount = reader.ReadInt32();
+                    for (var k = 0; k < dependencyCount; k++)
+                    {
+                        library.Dependencies.Add(ReadLibrary(reader));
+                    }
+
+                    target.Libraries.Add(library);
+                }
+
+                var assemblyCount = reader.ReadInt32();
+                for (var j = 0; j < assemblyCount; j++)
+                {
+                    target.PackageAssemblies.Add(new LockFileAssembly
+                    {
+                        Name = reader.ReadString(),
+                        Path = reader.ReadString(),
+                        LibraryName = reader.ReadString()
+                    });
+                }
+
+                lockFile.Targets.Add(target);
+            }
+
+            return lockFile;
+        }
+
+        private void Write(BinaryWriter writer)
+        {
+            writer.Write(Signature);
+            writer.Write(FormatVersion);
+            writer.Write(Targets.Count);
+
+            foreach (var target in Targets)
+            {
+                writer.Write(target.TargetFramework.FullName);
+                writer.Write(target.Hash);
+
+                writer.Write(target.InputPaths.Count);
+                foreach (var path in target.InputPaths)
+                {
+                    writer.Write(path);
+                }
+
+                writer.Write(target.Libraries.Count);
+                foreach (var library in target.Libraries)
+                {
+                    WriteLibrary(writer, library.Identity);
+                    writer.Write(library.ProviderIndex);
+                    WriteNullableString(writer, library.Type);
+                    WriteNullableString(writer, library.Path);
+
+                    writer.Write(library.Dependencies.Count);
+                    foreach (var dependency in library.Dependencies)
+                    {
+                        WriteLibrary(writer, dependency);
+                    }
+                }
+
+                writer.Write(target.PackageAssemblies.Count);
+                foreach (var assembly in target.PackageAssemblies)
+                {
+                    writer.Write(assembly.Name);
+                    writer.Write(assembly.Path);
+                    writer.Write(assembly.LibraryName);
+                }
+            }
+        }
+
+        private static Library ReadLibrary(BinaryReader reader)
+        {
+            var name = reader.ReadString();
+            var version = ReadNullableString(reader);
+
+            return new Library
+            {
+                Name = name,
+                Version = version == null ? null : SemanticVersion.Parse(version)
+            };
+        }
+
+        private static void WriteLibrary(BinaryWriter writer, Library library)
+        {
+            string version = null;
+            if (library.Version != null)
+            {
+                // ToString drops the snapshot marker
+                version = library.Version.ToString() + (library.Version.IsSnapshot ? "-*" : string.Empty);
+            }
+
+            writer.Write(library.Name);
+            WriteNullableString(writer, version);
+        }
+
+        private static string ReadNullableString(BinaryReader reader)
+        {
+            return reader.ReadBoolean() ? reader.ReadString() : null;
+        }
+
+        private static void WriteNullableString(BinaryWriter writer, string value)
+        {
+            writer.Write(value != null);
+            if (value != null)
+            {
+                writer.Write(value);
+            }
+        }
+    }
+}
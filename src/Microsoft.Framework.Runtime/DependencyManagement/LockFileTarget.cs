@@ -0,0 +1,61 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+using System.Collections.Generic;
+using System.Runtime.Versioning;
+
+namespace Microsoft.Framework.Runtime
+{
+    /// <summary>
+    /// The resolved dependency closure of a project for one target framework.
+    /// </summary>
+    public class LockFileTarget
+    {
+        public LockFileTarget()
+        {
+            InputPaths = new List<string>();
+            Libraries = new List<LockFileLibrary>();
+            PackageAssemblies = new List<LockFileAssembly>();
+        }
+
+        public FrameworkName TargetFramework { get; set; }
+
+        // Hash of the project, packages folder and the write times of InputPaths when the target was created
+        public ulong Hash { get; set; }
+
+        // Project files and package id folders that invalidate the target when they change
+        public IList<string> InputPaths { get; private set; }
+
+        public IList<LockFileLibrary> Libraries { get; private set; }
+
+        public IList<LockFileAssembly> PackageAssemblies { get; private set; }
+    }
+
+    public class LockFileLibrary
+    {
+        public LockFileLibrary()
+        {
+            Dependencies = new List<Library>();
+        }
+
+        public Library Identity { get; set; }
+
+        // Position of the provider in DependencyWalker.DependencyProviders
+        public int ProviderIndex { get; set; }
+
+        public string Type { get; set; }
+
+        public string Path { get; set; }
+
+        public IList<Library> Dependencies { get; private set; }
+    }
+
+    public class LockFileAssembly
+    {
+        public string Name { get; set; }
+
+        public string Path { get; set; }
+
+        public string LibraryName { get; set; }
+    }
+}
@@ -25,8 +25,13 @@ public class NuGetDependencyResolver : IDependencyProvider, ILibraryExportProvid
         private readonly IFrameworkReferenceResolver _frameworkReferenceResolver;
 
         public NuGetDependencyResolver(string packagesPath, IFrameworkReferenceResolver frameworkReferenceResolver)
+            : this(new PackageRepository(packagesPath), frameworkReferenceResolver)
         {
-            _repository = new PackageRepository(packagesPath);
+        }
+
+        public NuGetDependencyResolver(PackageRepository repository, IFrameworkReferenceResolver frameworkReferenceResolver)
+        {
+            _repository = repository;
             _frameworkReferenceResolver = frameworkReferenceResolver;
             Dependencies = Enumerable.Empty<LibraryDescription>();
         }
@@ -138,14 +143,7 @@ public void Initialize(IEnumerable<LibraryDescription> packages, FrameworkName t
 
                 _packageDescriptions[package.Id] = packageDescription;
 
-                // Try to find a contract folder for this package and store that
-                // for compilation
-                string contractPath = Path.Combine(dependency.Path, "lib", "contract",
-                                                   package.Id + ".dll");
-                if (File.Exists(contractPath))
-                {
-                    packageDescription.ContractPath = contractPath;
-                }
+                packageDescription.ContractPath = GetContractPath(packageDescription);
 
                 foreach (var assemblyInfo in GetPackageAssemblies(packageDescription, targetFramework))
                 {
@@ -158,6 +156,73 @@ public void Initialize(IEnumerable<LibraryDescription> packages, FrameworkName t
             }
         }
 
+        /// <summary>
+        /// Initializes the resolver from a lock file target without reading any package metadata.
+        /// The metadata is loaded on demand when an export is requested.
+        /// </summary>
+        public void Initialize(IEnumerable<LibraryDescription> packages, IEnumerable<LockFileAssembly> assemblies)
+        {
+            Dependencies = packages;
+
+            foreach (var dependency in packages)
+            {
+                if (dependency.Type != "Package")
+                {
+                    continue;
+                }
+
+                _packageDescriptions[dependency.Identity.Name] = new PackageDescription
+                {
+                    Library = dependency
+                };
+            }
+
+            foreach (var assembly in assemblies)
+            {
+                PackageDescription packageDescription;
+                if (_packageDescriptions.TryGetValue(assembly.LibraryName, out packageDescription))
+                {
+                    _packageAssemblyLookup[assembly.Name] = new PackageAssembly()
+                    {
+                        Path = assembly.Path,
+                        Library = packageDescription.Library
+                    };
+                }
+            }
+        }
+
+        private bool EnsurePackage(PackageDescription description)
+        {
+            if (description.Package != null)
+            {
+                return true;
+            }
+
+            var package = FindCandidate(description.Library.Identity.Name, description.Library.Identity.Version);
+            if (package == null)
+            {
+                return false;
+            }
+
+            description.ContractPath = GetContractPath(description);
+            description.Package = package;
+            return true;
+        }
+
+        private static string GetContractPath(PackageDescription description)
+        {
+            // Try to find a contract folder for this package and store that
+            // for compilation
+            string contractPath = Path.Combine(description.Library.Path, "lib", "contract",
+                                               description.Library.Identity.Name + ".dll");
+            if (File.Exists(contractPath))
+            {
+                return contractPath;
+            }
+
+            return null;
+        }
+
         private static string ResolvePackagePath(IPackagePathResolver defaultResolver,
                                                  IEnumerable<IPackagePathResolver> cacheResolvers,
                                                  IPackage package)
@@ -196,7 +261,8 @@ private static IEnumerable<IPackagePathResolver> GetCacheResolvers()
         public ILibraryExport GetLibraryExport(ILibraryKey target)
         {
             PackageDescription description;
-            if (!_packageDescriptions.TryGetValue(target.Name, out description))
+            if (!_packageDescriptions.TryGetValue(target.Name, out description) ||
+                !EnsurePackage(description))
             {
                 return null;
             }
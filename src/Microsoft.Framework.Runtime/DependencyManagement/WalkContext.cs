@@ -15,35 +15,14 @@ namespace Microsoft.Framework.Runtime
 {
     public class WalkContext
     {
-        private readonly IDictionary<string, Item> _usedItems = new Dictionary<string, Item>();
+        // The walk has always given up after this many nodes, keeping the bound means large
+        // graphs keep resolving to exactly the same libraries
+        private const int MaxNodes = 9999;
 
-        void ForEach<TState>(Node root, TState state, Func<Node, TState, TState> visitor)
-        {
-            // breadth-first walk of Node tree
+        // Upper bound on conflict resolution passes, each pass that doesn't finish settles at least one node
+        private const int MaxPasses = 999;
 
-            var queue = new Queue<Tuple<Node, TState>>();
-            var patience = 10000;
-            queue.Enqueue(Tuple.Create(root, state));
-            while (!queue.IsEmpty() && --patience != 0)
-            {
-                var work = queue.Dequeue();
-                var innerState = visitor(work.Item1, work.Item2);
-                foreach (var innerNode in work.Item1.InnerNodes)
-                {
-                    queue.Enqueue(Tuple.Create(innerNode, innerState));
-                }
-            }
-        }
-
-        private void ForEach(Node root, Action<Node> visitor)
-        {
-            // breadth-first walk of Node tree, without TState parameter
-            ForEach(root, 0, (node, _) =>
-            {
-                visitor(node);
-                return 0;
-            });
-        }
+        private readonly IDictionary<string, Item> _usedItems = new Dictionary<string, Item>();
 
         public void Walk(
             IEnumerable<IDependencyProvider> dependencyResolvers,
@@ -51,89 +30,91 @@ private void ForEach(Node root, Action<Node> visitor)
             SemanticVersion version,
             FrameworkName frameworkName)
         {
-            var root = new Node
-            {
-                Key = new Library { Name = name, Version = version }
-            };
-
             var resolvers = dependencyResolvers as IDependencyProvider[] ?? dependencyResolvers.ToArray();
             var resolvedItems = new Dictionary<Library, Item>();
 
+            // Nodes are stored breadth-first, so a parent always precedes its children and every
+            // pass over the tree is a forward scan that reads the parent's state from an array
+            var nodes = new NodeTable();
+            nodes.Add(new Library { Name = name, Version = version }, parent: -1);
+
+            // Dependency names are interned case insensitively for the eclipse check
+            var names = new Dictionary<string, int>(StringComparer.OrdinalIgnoreCase);
+            var rootScope = Bitset.Set(null, Intern(names, name));
+            var scopes = new List<ulong[]>();
+
             // Recurse through dependencies optimistically, asking resolvers for dependencies
             // based on best match of each encountered dependency
-            ForEach(root, node =>
+            for (var index = 0; index < nodes.Count && index < MaxNodes; index++)
             {
-                node.Item = Resolve(resolvedItems, resolvers, node.Key, frameworkName);
-                if (node.Item == null)
+                var parent = nodes.Parents[index];
+                var outerScope = parent == -1 ? rootScope : scopes[parent];
+                var scope = outerScope;
+
+                var item = Resolve(resolvedItems, resolvers, nodes.Keys[index], frameworkName);
+                nodes.Items[index] = item;
+
+                if (item == null)
                 {
-                    node.Disposition = Disposition.Rejected;
-                    return;
+                    nodes.Dispositions[index] = Disposition.Rejected;
                 }
-
-                foreach (var dependency in node.Item.Dependencies)
+                else
                 {
-                    // determine if a child dependency is eclipsed by
-                    // a reference on the line leading to this point. this
-                    // prevents cyclical dependencies, and also implements the
-                    // "nearest wins" rule.
-
-                    var eclipsed = false;
-                    for (var scanNode = node;
-                         scanNode != null && !eclipsed;
-                         scanNode = scanNode.OuterNode)
+                    foreach (var dependency in item.Dependencies)
                     {
-                        eclipsed |= string.Equals(
-                            scanNode.Key.Name,
-                            dependency.Name,
-                            StringComparison.OrdinalIgnoreCase);
-
-                        foreach (var sideNode in scanNode.InnerNodes)
+                        // determine if a child dependency is eclipsed by a reference on the line
+                        // leading to this point, or by a sibling of anything on that line. this
+                        // prevents cyclical dependencies, and also implements the "nearest wins" rule.
+                        // the scope of a node holds exactly those names, so the check is one bit test.
+                        var id = Intern(names, dependency.Name);
+                        if (!Bitset.Contains(scope, id))
                         {
-                            eclipsed |= string.Equals(
-                                sideNode.Key.Name,
-                                dependency.Name,
-                                StringComparison.OrdinalIgnoreCase);
+                            if (ReferenceEquals(scope, outerScope))
+                            {
+                                scope = Bitset.Copy(outerScope);
+                            }
+                            scope = Bitset.Set(scope, id);
+                            nodes.Add(dependency, index);
                         }
                     }
-
-                    if (!eclipsed)
-                    {
-                        var innerNode = new Node
-                        {
-                            OuterNode = node,
-                            Key = dependency,
-                        };
-                        node.InnerNodes.Add(innerNode);
-                    }
                 }
-            });
 
-            // now we walk the tree as often as it takes to determine 
+                scopes.Add(scope);
+            }
+
+            // Nodes past the bound were never resolved
+            var count = Math.Min(nodes.Count, MaxNodes);
+
+            var tracker = new Tracker(nodes, count);
+            var walking = new bool[count];
+            var ambiguous = new bool[count];
+
+            // now we walk the tree as often as it takes to determine
             // which paths are accepted or rejected, based on conflicts occuring
-            // between cousin packages
+            // between cousin packages. a pass only changes dispositions from
+            // Acceptable, so we stop as soon as a pass settles nothing new.
 
-            var patience = 1000;
-            var incomplete = true;
-            while (incomplete && --patience != 0)
+            for (var pass = 0; pass < MaxPasses; pass++)
             {
                 // Create a picture of what has not been rejected yet
-                var tracker = new Tracker();
-                ForEach(root, true, (node, state) =>
+                tracker.Reset();
+                for (var index = 0; index < count; index++)
                 {
-                    if (!state || node.Disposition == Disposition.Rejected)
+                    var parent = nodes.Parents[index];
+                    walking[index] = (parent == -1 || walking[parent]) &&
+                                     nodes.Dispositions[index] != Disposition.Rejected;
+                    if (walking[index])
                     {
-                        return false;
+                        tracker.Track(index);
                     }
-                    tracker.Track(node.Item);
-                    return true;
-                });
+                }
 
                 // Inform tracker of ambiguity beneath nodes that are not resolved yet
                 // between:
                 // a1->b1->d1->x1
                 // a1->c1->d2->z1
                 // first attempt
-                //  d1/d2 are considered disputed 
+                //  d1/d2 are considered disputed
                 //  x1 and z1 are considered ambiguous
                 //  d1 is rejected
                 // second attempt
@@ -141,77 +122,90 @@ private void ForEach(Node root, Action<Node> visitor)
                 //  x1 is no longer seen, and z1 is not ambiguous
                 //  z1 is accepted
 
-                ForEach(root, "Walking", (node, state) =>
+                for (var index = 0; index < count; index++)
                 {
-                    if (node.Disposition == Disposition.Rejected)
+                    var parent = nodes.Parents[index];
+                    if (!walking[index])
                     {
-                        return "Rejected";
+                        // Rejected nodes and everything beneath them
+                        ambiguous[index] = false;
                     }
-                    if (state == "Walking" && tracker.IsDisputed(node.Item))
+                    else if (parent != -1 && ambiguous[parent])
                     {
-                        return "Ambiguous";
+                        tracker.MarkAmbiguous(index);
+                        ambiguous[index] = true;
                     }
-                    if (state == "Ambiguous")
+                    else
                     {
-                        tracker.MarkAmbiguous(node.Item);
+                        ambiguous[index] = tracker.IsDisputed(index);
                     }
-                    return state;
-                });
+                }
 
                 // Now mark unambiguous nodes as accepted or rejected
-                ForEach(root, true, (node, state) =>
+                var changed = false;
+                var incomplete = false;
+                for (var index = 0; index < count; index++)
                 {
-                    if (!state || node.Disposition == Disposition.Rejected)
-                    {
-                        return false;
-                    }
-                    if (tracker.IsAmbiguous(node.Item))
-                    {
-                        return false;
-                    }
-                    if (node.Disposition == Disposition.Acceptable)
+                    var parent = nodes.Parents[index];
+                    var disposition = nodes.Dispositions[index];
+
+                    if ((parent == -1 || walking[parent]) &&
+                        disposition == Disposition.Acceptable &&
+                        !tracker.IsAmbiguous(index))
                     {
-                        node.Disposition = tracker.IsBestVersion(node.Item) ? Disposition.Accepted : Disposition.Rejected;
+                        disposition = tracker.IsBestVersion(index) ? Disposition.Accepted : Disposition.Rejected;
+                        nodes.Dispositions[index] = disposition;
+                        changed = true;
                     }
-                    return node.Disposition == Disposition.Accepted;
-                });
 
-                incomplete = false;
-                ForEach(root, node => incomplete |= node.Disposition == Disposition.Acceptable);
+                    // walking now means accepted along the whole line
+                    walking[index] = (parent == -1 || walking[parent]) &&
+                                     disposition == Disposition.Accepted &&
+                                     !tracker.IsAmbiguous(index);
 
-                // uncomment in case of emergencies: TraceState(root);
-            }
+                    incomplete |= disposition == Disposition.Acceptable;
+                }
 
-            ForEach(root, true, (node, state) =>
-            {
-                if (state == false ||
-                    node.Disposition != Disposition.Accepted ||
-                    node.Item == null)
+                // uncomment in case of emergencies: TraceState(nodes, count);
+
+                if (!incomplete || !changed)
                 {
-                    return false;
+                    break;
                 }
+            }
+
+            for (var index = 0; index < count; index++)
+            {
+                var parent = nodes.Parents[index];
+                var item = nodes.Items[index];
 
-                if (!_usedItems.ContainsKey(node.Item.Key.Name))
+                walking[index] = (parent == -1 || walking[parent]) &&
+                                 nodes.Dispositions[index] == Disposition.Accepted &&
+                                 item != null;
+
+                if (walking[index] && !_usedItems.ContainsKey(item.Key.Name))
                 {
-                    _usedItems[node.Item.Key.Name] = node.Item;
+                    _usedItems[item.Key.Name] = item;
                 }
-                return true;
-            });
+            }
 
-            // uncomment in case of emergencies: TraceState(root);
+            // uncomment in case of emergencies: TraceState(nodes, count);
         }
 
-        private void TraceState(Node root)
+        private void TraceState(NodeTable nodes, int count)
         {
+            var elements = new XElement[count];
             var elt = new XElement("state");
-            ForEach(root, elt, (node, parent) =>
+            for (var index = 0; index < count; index++)
             {
-                var child = new XElement(node.Key.Name,
-                    new XAttribute("version", node.Key.Version == null ? "null" : node.Key.Version.ToString()),
-                    new XAttribute("disposition", node.Disposition.ToString()));
-                parent.Add(child);
-                return child;
-            });
+                var key = nodes.Keys[index];
+                elements[index] = new XElement(key.Name,
+                    new XAttribute("version", key.Version == null ? "null" : key.Version.ToString()),
+                    new XAttribute("disposition", nodes.Dispositions[index].ToString()));
+
+                var parent = nodes.Parents[index];
+                (parent == -1 ? elt : elements[parent]).Add(elements[index]);
+            }
 
             var sb = new StringBuilder();
             using (var writer = XmlWriter.Create(sb, new XmlWriterSettings { Indent = true, IndentChars = "  " }))
@@ -228,6 +222,17 @@ public enum Disposition
             Accepted
         }
 
+        private static int Intern(Dictionary<string, int> names, string name)
+        {
+            int id;
+            if (!names.TryGetValue(name, out id))
+            {
+                id = names.Count;
+                names[name] = id;
+            }
+            return id;
+        }
+
         private Item Resolve(
             Dictionary<Library, Item> resolvedItems,
             IEnumerable<IDependencyProvider> resolvers,
@@ -295,21 +300,15 @@ public void Populate(FrameworkName frameworkName, IList<LibraryDescription> libr
             }
         }
 
-
-        public class Node
+        public IList<LibraryGraphNode> GetGraphNodes(IList<IDependencyProvider> providers)
         {
-            public Node()
-            {
-                InnerNodes = new List<Node>();
-                Disposition = Disposition.Acceptable;
-            }
-
-            public Library Key { get; set; }
-            public Item Item { get; set; }
-            public Node OuterNode { get; set; }
-            public IList<Node> InnerNodes { get; private set; }
-
-            public Disposition Disposition { get; set; }
+            return _usedItems.Values.Select(item => new LibraryGraphNode(
+                item.Key,
+                providers.IndexOf(item.Resolver),
+                item.Dependencies.Where(p => _usedItems.ContainsKey(p.Name))
+                                 .Select(p => _usedItems[p.Name].Key)
+                                 .ToList()))
+                .ToList();
         }
 
         public class Item
@@ -319,62 +318,143 @@ public class Item
             public IEnumerable<Library> Dependencies { get; set; }
         }
 
-        public class Tracker
+        private class NodeTable
         {
-            class Entry
+            public NodeTable()
             {
-                public Entry()
+                Keys = new Library[16];
+                Parents = new int[16];
+                Items = new Item[16];
+                Dispositions = new Disposition[16];
+            }
+
+            public int Count { get; private set; }
+
+            public Library[] Keys { get; private set; }
+            public int[] Parents { get; private set; }
+            public Item[] Items { get; private set; }
+            public Disposition[] Dispositions { get; private set; }
+
+            public void Add(Library key, int parent)
+            {
+                if (Count == Keys.Length)
                 {
-                    List = new List<Item>();
+                    var size = Count * 2;
+                    var keys = Keys;
+                    var parents = Parents;
+                    var items = Items;
+                    var dispositions = Dispositions;
+                    Array.Resize(ref keys, size);
+                    Array.Resize(ref parents, size);
+                    Array.Resize(ref items, size);
+                    Array.Resize(ref dispositions, size);
+                    Keys = keys;
+                    Parents = parents;
+                    Items = items;
+                    Dispositions = dispositions;
                 }
 
-                public List<Item> List { get; set; }
+                Keys[Count] = key;
+                Parents[Count] = parent;
+                Count++;
+            }
+        }
 
-                public bool Ambiguous { get; set; }
+        private static class Bitset
+        {
+            public static bool Contains(ulong[] bits, int index)
+            {
+                var word = index >> 6;
+                return bits != null && word < bits.Length && (bits[word] & (1UL << (index & 63))) != 0;
             }
 
-            readonly Dictionary<string, Entry> _entries = new Dictionary<string, Entry>();
+            public static ulong[] Set(ulong[] bits, int index)
+            {
+                var word = index >> 6;
+                if (bits == null || word >= bits.Length)
+                {
+                    Array.Resize(ref bits, word + 1);
+                }
+                bits[word] |= 1UL << (index & 63);
+                return bits;
+            }
+
+            public static ulong[] Copy(ulong[] bits)
+            {
+                return bits == null ? null : (ulong[])bits.Clone();
+            }
+        }
+
+        /// <summary>
+        /// The versions of each library seen on the lines that are not rejected yet, keyed by
+        /// resolved library name.
+        /// </summary>
+        private class Tracker
+        {
+            private readonly NodeTable _nodes;
+            private readonly int[] _nameIds;
+            private readonly List<Item>[] _seen;
+            private readonly bool[] _ambiguous;
+
+            public Tracker(NodeTable nodes, int count)
+            {
+                var names = new Dictionary<string, int>();
+
+                _nodes = nodes;
+                _nameIds = new int[count];
+                for (var index = 0; index < count; index++)
+                {
+                    var item = nodes.Items[index];
+                    _nameIds[index] = item == null ? -1 : Intern(names, item.Key.Name);
+                }
+
+                _seen = new List<Item>[names.Count];
+                _ambiguous = new bool[names.Count];
+                for (var id = 0; id < _seen.Length; id++)
+                {
+                    _seen[id] = new List<Item>();
+                }
+            }
 
-            private Entry GetEntry(Item item)
+            public void Reset()
             {
-                Entry itemList;
-                if (!_entries.TryGetValue(item.Key.Name, out itemList))
+                for (var id = 0; id < _seen.Length; id++)
                 {
-                    itemList = new Entry();
-                    _entries[item.Key.Name] = itemList;
+                    _seen[id].Clear();
+                    _ambiguous[id] = false;
                 }
-                return itemList;
             }
 
-            public void Track(Item item)
+            public void Track(int node)
             {
-                var entry = GetEntry(item);
-                if (!entry.List.Contains(item))
+                var seen = _seen[_nameIds[node]];
+                var item = _nodes.Items[node];
+                if (!seen.Contains(item))
                 {
-                    entry.List.Add(item);
+                    seen.Add(item);
                 }
             }
 
-            public bool IsDisputed(Item item)
+            public bool IsDisputed(int node)
             {
-                return GetEntry(item).List.Count > 1;
+                return _seen[_nameIds[node]].Count > 1;
             }
 
-            public bool IsAmbiguous(Item item)
+            public bool IsAmbiguous(int node)
             {
-                return GetEntry(item).Ambiguous;
+                return _ambiguous[_nameIds[node]];
             }
 
-            public void MarkAmbiguous(Item item)
+            public void MarkAmbiguous(int node)
             {
-                GetEntry(item).Ambiguous = true;
+                _ambiguous[_nameIds[node]] = true;
             }
 
-            public bool IsBestVersion(Item item)
+            public bool IsBestVersion(int node)
             {
-                var entry = GetEntry(item);
-                return entry.List.All(known => item.Key.Version >= known.Key.Version);
+                var item = _nodes.Items[node];
+                return _seen[_nameIds[node]].All(known => item.Key.Version >= known.Key.Version);
             }
         }
     }
-}
\ No newline at end of file
+}
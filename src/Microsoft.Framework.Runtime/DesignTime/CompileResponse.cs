@@ -13,6 +13,7 @@ public class CompileResponse
         public byte[] PdbBytes { get; set; }
 
         public string AssemblyPath { get; set; }
+        public string AssemblyHash { get; set; }
     }
 
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 using System.Collections.Generic;
 using System.IO;
 using System.Threading.Tasks;
+using Newtonsoft.Json.Linq;
 
 namespace Microsoft.Framework.Runtime
 {
@@ -11,6 +12,7 @@ public class DesignTimeHostCompiler : IDesignTimeHostCompiler
         private readonly ProcessingQueue _queue;
         private readonly ConcurrentDictionary<int, TaskCompletionSource<CompileResponse>> _compileResponses = new ConcurrentDictionary<int, TaskCompletionSource<CompileResponse>>();
         private readonly TaskCompletionSource<Dictionary<string, int>> _projectContexts = new TaskCompletionSource<Dictionary<string, int>>();
+        private readonly bool _useSharedFiles = Environment.GetEnvironmentVariable("KRE_COMPILATION_SERVER_SHARED_FILES") == "1";
 
         public DesignTimeHostCompiler(IApplicationShutdown shutdown, Stream stream)
         {
@@ -43,7 +45,9 @@ public async Task<CompileResponse> Compile(string projectPath)
             {
                 HostId = "Application",
                 MessageType = "GetCompiledAssembly",
-                ContextId = contextId
+                ContextId = contextId,
+                // Hosts that don't know about this still send the bytes
+                Payload = _useSharedFiles ? new JObject { { "Transport", "File" } } : null
             });
 
             return await _compileResponses.GetOrAdd(contextId, _ => new TaskCompletionSource<CompileResponse>()).Task;
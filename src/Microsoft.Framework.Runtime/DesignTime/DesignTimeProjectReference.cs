@@ -3,6 +3,7 @@
 using System.IO;
 using System.Linq;
 using System.Reflection;
+using System.Security.Cryptography;
 
 namespace Microsoft.Framework.Runtime
 {
@@ -46,27 +47,59 @@ public Assembly Load(IAssemblyLoaderEngine loaderEngine)
 
             if (_response.AssemblyPath != null)
             {
-                return loaderEngine.LoadFile(_response.AssemblyPath);
+                byte[] pdbBytes;
+                var assemblyBytes = ReadSharedAssembly(out pdbBytes);
+
+                return loaderEngine.LoadStream(OpenBuffer(assemblyBytes),
+                                               pdbBytes.Length > 0 ? OpenBuffer(pdbBytes) : null);
             }
 
             if (_response.PdbBytes == null)
             {
-                return loaderEngine.LoadStream(new MemoryStream(_response.AssemblyBytes), pdbStream: null);
+                return loaderEngine.LoadStream(OpenBuffer(_response.AssemblyBytes), pdbStream: null);
             }
 
-            return loaderEngine.LoadStream(new MemoryStream(_response.AssemblyBytes),
-                                           new MemoryStream(_response.PdbBytes));
+            return loaderEngine.LoadStream(OpenBuffer(_response.AssemblyBytes),
+                                           OpenBuffer(_response.PdbBytes));
         }
 
-        public void EmitReferenceAssembly(Stream stream)
+        private static MemoryStream OpenBuffer(byte[] bytes)
         {
-            if (_response.AssemblyPath != null)
+            // Expose the buffer so the loader can use the bytes without copying them
+            return new MemoryStream(bytes, 0, bytes.Length, writable: false, publiclyVisible: true);
+        }
+
+        // Whoever else can write the file could have the application load their code, so the bytes are
+        // checked against the hash the host sent and loaded from memory
+        private byte[] ReadSharedAssembly(out byte[] pdbBytes)
+        {
+            var assemblyBytes = File.ReadAllBytes(_response.AssemblyPath);
+            var pdbPath = Path.ChangeExtension(_response.AssemblyPath, ".pdb");
+            pdbBytes = File.Exists(pdbPath) ? File.ReadAllBytes(pdbPath) : new byte[0];
+
+            using (var sha = SHA256.Create())
             {
-                using (var fs = File.OpenRead(_response.AssemblyPath))
+                sha.TransformBlock(assemblyBytes, 0, assemblyBytes.Length, null, 0);
+                sha.TransformFinalBlock(pdbBytes, 0, pdbBytes.Length);
+
+                var hash = BitConverter.ToString(sha.Hash).Replace("-", string.Empty).ToLowerInvariant();
+                if (!string.Equals(hash, _response.AssemblyHash, StringComparison.Ordinal))
                 {
-                    fs.CopyTo(stream);
+                    throw new InvalidOperationException(string.Format("The assembly '{0}' doesn't match the one the design time host compiled.", _response.AssemblyPath));
                 }
             }
+
+            return assemblyBytes;
+        }
+
+        public void EmitReferenceAssembly(Stream stream)
+        {
+            if (_response.AssemblyPath != null)
+            {
+                byte[] pdbBytes;
+                var assemblyBytes = ReadSharedAssembly(out pdbBytes);
+                stream.Write(assemblyBytes, 0, assemblyBytes.Length);
+            }
             else
             {
                 stream.Write(_response.AssemblyBytes, 0, _response.AssemblyBytes.Length);
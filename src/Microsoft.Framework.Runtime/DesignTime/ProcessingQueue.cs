@@ -45,30 +45,8 @@ private void ReceiveMessages()
                     var messageType = _reader.ReadString();
                     if (messageType == "Assembly")
                     {
-                        var compileResponse = new CompileResponse();
-                        var id = _reader.ReadInt32();
-                        var warningsCount = _reader.ReadInt32();
-                        compileResponse.Warnings = new string[warningsCount];
-                        for (int i = 0; i < warningsCount; i++)
-                        {
-                            compileResponse.Warnings[i] = _reader.ReadString();
-                        }
-
-                        var errorsCount = _reader.ReadInt32();
-                        compileResponse.Errors = new string[errorsCount];
-                        for (int i = 0; i < errorsCount; i++)
-                        {
-                            compileResponse.Errors[i] = _reader.ReadString();
-                        }
-                        var embeddedReferencesCount = _reader.ReadInt32();
-                        compileResponse.EmbeddedReferences = new Dictionary<string, byte[]>();
-                        for (int i = 0; i < embeddedReferencesCount; i++)
-                        {
-                            var key = _reader.ReadString();
-                            int valueLength = _reader.ReadInt32();
-                            var value = _reader.ReadBytes(valueLength);
-                            compileResponse.EmbeddedReferences[key] = value;
-                        }
+                        int id;
+                        var compileResponse = ReadCompileResponse(out id);
 
                         var assemblyBytesLength = _reader.ReadInt32();
                         compileResponse.AssemblyBytes = _reader.ReadBytes(assemblyBytesLength);
@@ -77,6 +55,17 @@ private void ReceiveMessages()
 
                         ProjectCompiled(id, compileResponse);
                     }
+                    else if (messageType == "AssemblyFile")
+                    {
+                        int id;
+                        var compileResponse = ReadCompileResponse(out id);
+
+                        // The host wrote the image to a file named by its hash, it is checked before it is loaded
+                        compileResponse.AssemblyPath = _reader.ReadString();
+                        compileResponse.AssemblyHash = _reader.ReadString();
+
+                        ProjectCompiled(id, compileResponse);
+                    }
                     else if (messageType == "ProjectContexts")
                     {
                         int count = _reader.ReadInt32();
@@ -105,5 +94,35 @@ private void ReceiveMessages()
                 return;
             }
         }
+
+        private CompileResponse ReadCompileResponse(out int id)
+        {
+            var compileResponse = new CompileResponse();
+            id = _reader.ReadInt32();
+            var warningsCount = _reader.ReadInt32();
+            compileResponse.Warnings = new string[warningsCount];
+            for (int i = 0; i < warningsCount; i++)
+            {
+                compileResponse.Warnings[i] = _reader.ReadString();
+            }
+
+            var errorsCount = _reader.ReadInt32();
+            compileResponse.Errors = new string[errorsCount];
+            for (int i = 0; i < errorsCount; i++)
+            {
+                compileResponse.Errors[i] = _reader.ReadString();
+            }
+            var embeddedReferencesCount = _reader.ReadInt32();
+            compileResponse.EmbeddedReferences = new Dictionary<string, byte[]>();
+            for (int i = 0; i < embeddedReferencesCount; i++)
+            {
+                var key = _reader.ReadString();
+                int valueLength = _reader.ReadInt32();
+                var value = _reader.ReadBytes(valueLength);
+                compileResponse.EmbeddedReferences[key] = value;
+            }
+
+            return compileResponse;
+        }
     }
 }
\ No newline at end of file
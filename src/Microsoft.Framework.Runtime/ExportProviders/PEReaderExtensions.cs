@@ -12,9 +12,15 @@ namespace Microsoft.Framework.Runtime
 {
     internal static class PEReaderExtensions
     {
-        public static IList<IMetadataEmbeddedReference> GetEmbeddedReferences(this PEReader reader)
+        /// <summary>
+        /// Reads the assembly neutral interfaces embedded in the PE file. <paramref name="peStream"/> is the
+        /// stream <paramref name="reader"/> reads from, each resource is read from it straight into its buffer
+        /// so the rest of the image never has to be loaded.
+        /// </summary>
+        public static IList<IMetadataEmbeddedReference> GetEmbeddedReferences(this PEReader reader, Stream peStream)
         {
             var items = new List<IMetadataEmbeddedReference>();
+            int offsetToResources = -1;
 
             var mdReader = reader.GetMetadataReader();
             foreach (var resourceHandle in mdReader.ManifestResources)
@@ -25,7 +31,12 @@ public static IList<IMetadataEmbeddedReference> GetEmbeddedReferences(this PERea
                 // Embedded interface
                 if (resourceName.EndsWith(".dll", StringComparison.OrdinalIgnoreCase))
                 {
-                    var buffer = GetEmbeddedResourceContents(reader, resource);
+                    if (offsetToResources < 0)
+                    {
+                        offsetToResources = GetOffsetToResources(reader);
+                    }
+
+                    var buffer = GetEmbeddedResourceContents(peStream, offsetToResources, resource);
 
                     // Remove .dll
                     var nameWithoutDll = resourceName.Substring(0, resourceName.Length - 4);
@@ -37,53 +48,63 @@ public static IList<IMetadataEmbeddedReference> GetEmbeddedReferences(this PERea
             return items;
         }
 
-        private static unsafe byte[] GetEmbeddedResourceContents(PEReader peReader, ManifestResource resource)
+        private static int GetOffsetToResources(PEReader peReader)
+        {
+            // Locate offset to resources within the PE file.
+            int offsetToResources;
+            if (!peReader.PEHeaders.TryGetDirectoryOffset(peReader.PEHeaders.CorHeader.ResourcesDirectory, out offsetToResources))
+            {
+                throw new InvalidDataException("Failed to get offset to resources in PE file.");
+            }
+            Debug.Assert(offsetToResources > 0);
+
+            return offsetToResources;
+        }
+
+        private static byte[] GetEmbeddedResourceContents(Stream peStream, int offsetToResources, ManifestResource resource)
         {
             if (!resource.Implementation.IsNil)
             {
                 throw new ArgumentException("Resource is not embedded in the PE file.", "resource");
             }
 
-            checked // arithmetic overflow here could cause AV
+            checked
             {
-                // Locate start and end of PE image in unmanaged memory.
-                var block = peReader.GetEntireImage();
-                IntPtr peImageStartAsIntPtr = block.Pointer;
-                int peImageSize = block.Length;
-                byte* peImageStart = (byte*)peImageStartAsIntPtr;
-                byte* peImageEnd = peImageStart + peImageSize;
-                Debug.Assert(peImageStart != null && peImageSize > 0);
-
-                // Locate offset to resources within PE image.
-                int offsetToResources;
-                if (!peReader.PEHeaders.TryGetDirectoryOffset(peReader.PEHeaders.CorHeader.ResourcesDirectory, out offsetToResources))
-                {
-                    throw new InvalidDataException("Failed to get offset to resources in PE file.");
-                }
-                Debug.Assert(offsetToResources > 0);
-                byte* resourceStart = peImageStart + offsetToResources + resource.Offset;
+                long resourceStart = (long)offsetToResources + resource.Offset;
 
                 // Get the length of the the resource from the first 4 bytes.
-                if (resourceStart >= peImageEnd - sizeof(int))
+                if (resourceStart > peStream.Length - sizeof(int))
                 {
                     throw new InvalidDataException("resource offset out of bounds.");
                 }
-                int resourceLength = *(int*)(resourceStart);
-                resourceStart += sizeof(int);
-                if (resourceLength < 0 || resourceStart >= peImageEnd - resourceLength)
+
+                peStream.Position = resourceStart;
+                var lengthBytes = ReadExactly(peStream, sizeof(int));
+                int resourceLength = lengthBytes[0] | lengthBytes[1] << 8 | lengthBytes[2] << 16 | lengthBytes[3] << 24;
+                if (resourceLength < 0 || resourceLength > peStream.Length - peStream.Position)
                 {
                     throw new InvalidDataException("resource offset or length out of bounds.");
                 }
 
-                // TODO: Use UmanagedMemoryStream when available on core clr
-                var buffer = new byte[resourceLength];
-                for (int i = 0; i < resourceLength; i++)
+                return ReadExactly(peStream, resourceLength);
+            }
+        }
+
+        private static byte[] ReadExactly(Stream stream, int count)
+        {
+            var buffer = new byte[count];
+            int offset = 0;
+            while (offset < count)
+            {
+                int read = stream.Read(buffer, offset, count - offset);
+                if (read == 0)
                 {
-                    buffer[i] = *(resourceStart + i);
+                    throw new InvalidDataException("Unexpected end of PE file.");
                 }
-
-                return buffer;
+                offset += read;
             }
+
+            return buffer;
         }
     }
 }
\ No newline at end of file
@@ -0,0 +1,206 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Linq;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace Microsoft.Framework.Runtime
+{
+    /// <summary>
+    /// Resolves the exports of the projects a library depends on before they are walked. Each project starts as
+    /// soon as the projects it references are done, so independent projects compile at the same time.
+    /// The exports end up in the cache, the walk that follows picks them up from there.
+    /// </summary>
+    internal static class ProjectCompilationScheduler
+    {
+        private static readonly int MaxWorkers = GetMaxWorkers();
+
+        // Shared by every call, applications and the design time host compile several targets at once
+        private static readonly SemaphoreSlim _throttle = new SemaphoreSlim(Math.Max(MaxWorkers, 1));
+
+        // Set while a worker exports a project, the dependencies of that project are already done
+        [ThreadStatic]
+        private static bool _isWorker;
+
+        public static void CompileDependencies(ILibraryManager manager,
+                                               ILibraryExportProvider libraryExportProvider,
+                                               ILibraryKey target)
+        {
+            CompileDependencies(manager, libraryExportProvider, target, MaxWorkers, _throttle);
+        }
+
+        internal static void CompileDependencies(ILibraryManager manager,
+                                                 ILibraryExportProvider libraryExportProvider,
+                                                 ILibraryKey target,
+                                                 int maxWorkers,
+                                                 SemaphoreSlim throttle)
+        {
+            if (_isWorker || maxWorkers <= 1)
+            {
+                return;
+            }
+
+            var projects = GetProjectDependencies(manager, target);
+            if (projects.Count < 2)
+            {
+                // Nothing to run side by side
+                return;
+            }
+
+            var sw = Stopwatch.StartNew();
+            var tasks = new Dictionary<string, Task>(StringComparer.OrdinalIgnoreCase);
+
+            foreach (var name in projects.Keys)
+            {
+                GetOrCreateTask(name, projects, tasks, throttle, libraryExportProvider, target);
+            }
+
+            try
+            {
+                Task.WaitAll(tasks.Values.ToArray());
+            }
+            catch (AggregateException ex)
+            {
+                // The walk exports the project again and reports the failure
+                Trace.TraceInformation("[{0}]: Failed to compile dependencies of '{1}': {2}", typeof(ProjectCompilationScheduler).Name, target.Name, ex.InnerException.Message);
+            }
+
+            sw.Stop();
+            Trace.TraceInformation("[{0}]: Compiled {1} projects for '{2}' in {3}ms", typeof(ProjectCompilationScheduler).Name, projects.Count, target.Name, sw.ElapsedMilliseconds);
+        }
+
+        private static Task GetOrCreateTask(string name,
+                                            IDictionary<string, List<string>> projects,
+                                            IDictionary<string, Task> tasks,
+                                            SemaphoreSlim throttle,
+                                            ILibraryExportProvider libraryExportProvider,
+                                            ILibraryKey target)
+        {
+            Task task;
+            if (tasks.TryGetValue(name, out task))
+            {
+                return task;
+            }
+
+            // Projects can't reference each other in a cycle, a null entry would only be seen for one
+            tasks[name] = null;
+
+            var dependencies = projects[name].Select(dependency => GetOrCreateTask(dependency, projects, tasks, throttle, libraryExportProvider, target))
+                                             .Where(dependency => dependency != null)
+                                             .ToArray();
+
+            task = CompileAsync(dependencies, throttle, () => Export(libraryExportProvider, target.ChangeName(name)));
+            tasks[name] = task;
+            return task;
+        }
+
+        private static async Task CompileAsync(Task[] dependencies, SemaphoreSlim throttle, Action export)
+        {
+            try
+            {
+                await Task.WhenAll(dependencies);
+            }
+            catch
+            {
+                // Try anyways, the project reports its own errors
+            }
+
+            await throttle.WaitAsync();
+            try
+            {
+                await Task.Run(export);
+            }
+            finally
+            {
+                throttle.Release();
+            }
+        }
+
+        private static void Export(ILibraryExportProvider libraryExportProvider, ILibraryKey target)
+        {
+            _isWorker = true;
+            try
+            {
+                libraryExportProvider.GetLibraryExport(target);
+            }
+            finally
+            {
+                _isWorker = false;
+            }
+        }
+
+        // Maps every project reachable from the target, except the target itself, to the projects it references
+        private static IDictionary<string, List<string>> GetProjectDependencies(ILibraryManager manager, ILibraryKey target)
+        {
+            var projects = new Dictionary<string, List<string>>(StringComparer.OrdinalIgnoreCase);
+            var processed = new HashSet<string>(StringComparer.OrdinalIgnoreCase);
+            var queue = new Queue<ILibraryInformation>();
+
+            var root = manager.GetLibraryInformation(target.Name, target.Aspect);
+            if (root == null)
+            {
+                return projects;
+            }
+
+            queue.Enqueue(root);
+            processed.Add(root.Name);
+
+            while (queue.Count > 0)
+            {
+                var library = queue.Dequeue();
+                var projectDependencies = new List<string>();
+
+                foreach (var dependency in library.Dependencies)
+                {
+                    var dependencyLibrary = manager.GetLibraryInformation(dependency, target.Aspect);
+                    if (dependencyLibrary == null)
+                    {
+                        continue;
+                    }
+
+                    if (IsProject(dependencyLibrary))
+                    {
+                        projectDependencies.Add(dependencyLibrary.Name);
+                    }
+
+                    if (processed.Add(dependencyLibrary.Name))
+                    {
+                        queue.Enqueue(dependencyLibrary);
+                    }
+                }
+
+                if (library != root && IsProject(library))
+                {
+                    projects[library.Name] = projectDependencies;
+                }
+            }
+
+            // The target isn't compiled here
+            foreach (var dependencies in projects.Values)
+            {
+                dependencies.RemoveAll(name => string.Equals(name, root.Name, StringComparison.OrdinalIgnoreCase));
+            }
+
+            return projects;
+        }
+
+        private static bool IsProject(ILibraryInformation library)
+        {
+            return string.Equals(library.Type, "Project", StringComparison.Ordinal);
+        }
+
+        private static int GetMaxWorkers()
+        {
+            int value;
+            if (Int32.TryParse(Environment.GetEnvironmentVariable("KRE_COMPILATION_WORKERS"), out value) && value >= 0)
+            {
+                return value;
+            }
+            return Environment.ProcessorCount;
+        }
+    }
+}
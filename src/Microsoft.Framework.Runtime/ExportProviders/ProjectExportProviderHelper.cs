@@ -24,6 +24,9 @@ internal static class ProjectExportProviderHelper
             var dependencyStopWatch = Stopwatch.StartNew();
             Trace.TraceInformation("[{0}]: Resolving references for '{1}' {2}", typeof(ProjectExportProviderHelper).Name, target.Name, target.Aspect);
 
+            // Compile the projects this library depends on side by side, the walk below then finds them in the cache
+            ProjectCompilationScheduler.CompileDependencies(manager, libraryExportProvider, target);
+
             var references = new Dictionary<string, IMetadataReference>(StringComparer.OrdinalIgnoreCase);
             var sourceReferences = new Dictionary<string, ISourceReference>(StringComparer.OrdinalIgnoreCase);
 
@@ -141,7 +144,7 @@ private static void ExpandEmbeddedReferences(ICache cache, IList<IMetadataRefere
                                            using (var fileStream = File.OpenRead(fileReference.Path))
                                            using (var reader = new PEReader(fileStream))
                                            {
-                                               return reader.GetEmbeddedReferences();
+                                               return reader.GetEmbeddedReferences(fileStream);
                                            }
                                        });
 
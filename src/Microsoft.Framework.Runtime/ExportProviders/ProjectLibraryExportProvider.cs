@@ -2,6 +2,7 @@
 // Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
 
 using System;
+using System.Collections.Concurrent;
 using System.Collections.Generic;
 using System.Diagnostics;
 using System.IO;
@@ -13,7 +14,7 @@ public class ProjectLibraryExportProvider : ILibraryExportProvider
     {
         private readonly IProjectResolver _projectResolver;
         private readonly IServiceProvider _serviceProvider;
-        private readonly Dictionary<TypeInformation, IProjectReferenceProvider> _projectReferenceProviders = new Dictionary<TypeInformation, IProjectReferenceProvider>();
+        private readonly ConcurrentDictionary<TypeInformation, IProjectReferenceProvider> _projectReferenceProviders = new ConcurrentDictionary<TypeInformation, IProjectReferenceProvider>();
 
         public ProjectLibraryExportProvider(IProjectResolver projectResolver,
                                             IServiceProvider serviceProvider)
@@ -15,6 +15,9 @@ public class FileWatcher : IFileWatcher
 
         private readonly List<IWatcherRoot> _watchers = new List<IWatcherRoot>();
 
+        // Projects are compiled in parallel and changes are reported on watcher threads
+        private readonly object _lock = new object();
+
         internal FileWatcher()
         {
 
@@ -29,14 +32,20 @@ public FileWatcher(string path)
 
         public void WatchDirectory(string path, string extension)
         {
-            var extensions = _directories.GetOrAdd(path, _ => new HashSet<string>(StringComparer.OrdinalIgnoreCase));
+            lock (_lock)
+            {
+                var extensions = _directories.GetOrAdd(path, _ => new HashSet<string>(StringComparer.OrdinalIgnoreCase));
 
-            extensions.Add(extension);
+                extensions.Add(extension);
+            }
         }
 
         public bool WatchFile(string path)
         {
-            return _files.Add(path);
+            lock (_lock)
+            {
+                return _files.Add(path);
+            }
         }
 
         public void WatchProject(string projectPath)
@@ -46,14 +55,17 @@ public void WatchProject(string projectPath)
                 return;
             }
 
-            // If any watchers already handle this path then noop
-            if (!IsAlreadyWatched(projectPath))
+            lock (_lock)
             {
-                // To reduce the number of watchers we have we add a watcher to the root
-                // of this project so that we'll be notified if anything we care
-                // about changes
-                var rootPath = ProjectResolver.ResolveRootDirectory(projectPath);
-                AddWatcher(rootPath);
+                // If any watchers already handle this path then noop
+                if (!IsAlreadyWatched(projectPath))
+                {
+                    // To reduce the number of watchers we have we add a watcher to the root
+                    // of this project so that we'll be notified if anything we care
+                    // about changes
+                    var rootPath = ProjectResolver.ResolveRootDirectory(projectPath);
+                    AddWatcher(rootPath);
+                }
             }
         }
 
@@ -82,12 +94,15 @@ internal bool IsAlreadyWatched(string projectPath)
 
         public void Dispose()
         {
-            foreach (var w in _watchers)
+            lock (_lock)
             {
-                w.Dispose();
-            }
+                foreach (var w in _watchers)
+                {
+                    w.Dispose();
+                }
 
-            _watchers.Clear();
+                _watchers.Clear();
+            }
         }
 
         public bool ReportChange(string newPath, WatcherChangeTypes changeType)
@@ -97,7 +112,13 @@ public bool ReportChange(string newPath, WatcherChangeTypes changeType)
 
         public bool ReportChange(string oldPath, string newPath, WatcherChangeTypes changeType)
         {
-            if (HasChanged(oldPath, newPath, changeType))
+            bool changed;
+            lock (_lock)
+            {
+                changed = HasChanged(oldPath, newPath, changeType);
+            }
+
+            if (changed)
             {
                 if (oldPath != null)
                 {
@@ -0,0 +1,521 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.IO;
+#if NET45
+using System.IO.MemoryMappedFiles;
+#endif
+using System.Linq;
+using System.Text;
+
+namespace Microsoft.Framework.Runtime.Loader
+{
+    /// <summary>
+    /// The package assemblies of a packed application root in one file that is opened once, so loading from it
+    /// doesn't open a file per assembly. It is memory mapped on net45, aspnetcore50 has no memory mapped files
+    /// so entries are read through one shared handle there. The layout, little endian:
+    ///
+    ///   "KBUNDLE2"  int32 stamp length, stamp, int32 entry count
+    ///   per entry:  int32 name length, UTF-8 name, int64 offset, int64 length, int32 flags
+    ///   data:       assemblies start on a page boundary, anything else on an 8 byte boundary
+    ///
+    /// Names are paths relative to the application root with '/' separators. The stamp is the global.json
+    /// the bundle was written with, it lists the hash of every package so a bundle that doesn't match it
+    /// is out of date. A bundle that can't be read is ignored like a stale one, the files are next to it.
+    /// </summary>
+    public class AppBundle : IDisposable
+    {
+        public const string FileName = "app.bundle";
+
+        public const int AssemblyFlag = 1;
+        public const int SymbolsFlag = 2;
+
+        private const int PageSize = 4096;
+        private static readonly byte[] Magic = Encoding.ASCII.GetBytes("KBUNDLE2");
+
+        private readonly string _rootDirectory;
+#if NET45
+        private readonly MemoryMappedFile _file;
+#else
+        private readonly FileStream _file;
+#endif
+        private readonly Dictionary<string, AppBundleEntry> _entries;
+
+#if NET45
+        private AppBundle(string rootDirectory, MemoryMappedFile file, Dictionary<string, AppBundleEntry> entries)
+#else
+        private AppBundle(string rootDirectory, FileStream file, Dictionary<string, AppBundleEntry> entries)
+#endif
+        {
+            _rootDirectory = rootDirectory;
+            _file = file;
+            _entries = entries;
+        }
+
+        public IEnumerable<AppBundleEntry> Entries
+        {
+            get { return _entries.Values; }
+        }
+
+        /// <summary>
+        /// Opens the bundle in <paramref name="rootDirectory"/>, returns null if there is none or it can't be used.
+        /// </summary>
+        public static AppBundle Open(string rootDirectory)
+        {
+            rootDirectory = Path.GetFullPath(rootDirectory);
+            var bundlePath = Path.Combine(rootDirectory, FileName);
+
+            if (!File.Exists(bundlePath))
+            {
+                return null;
+            }
+
+            var sw = Stopwatch.StartNew();
+            FileStream stream = null;
+
+            try
+            {
+                stream = new FileStream(bundlePath, FileMode.Open, FileAccess.Read, FileShare.Read | FileShare.Delete);
+
+                string reason;
+                var entries = ReadIndex(stream, ReadStamp(rootDirectory), out reason);
+                if (entries == null)
+                {
+                    Trace.TraceInformation("[{0}]: Ignoring {1}, {2}", typeof(AppBundle).Name, bundlePath, reason);
+                    return null;
+                }
+
+#if NET45
+                var file = MemoryMappedFile.CreateFromFile(stream, null, 0, MemoryMappedFileAccess.Read, null, HandleInheritability.None, leaveOpen: false);
+#else
+                var file = stream;
+#endif
+                stream = null;
+
+                sw.Stop();
+                Trace.TraceInformation("[{0}]: Opened {1} with {2} entries in {3}ms", typeof(AppBundle).Name, bundlePath, entries.Count, sw.ElapsedMilliseconds);
+
+                return new AppBundle(rootDirectory, file, entries);
+            }
+            catch (IOException ex)
+            {
+                Trace.TraceInformation("[{0}]: Ignoring {1}: {2}", typeof(AppBundle).Name, bundlePath, ex.Message);
+                return null;
+            }
+            catch (UnauthorizedAccessException ex)
+            {
+                Trace.TraceInformation("[{0}]: Ignoring {1}: {2}", typeof(AppBundle).Name, bundlePath, ex.Message);
+                return null;
+            }
+            finally
+            {
+                if (stream != null)
+                {
+                    stream.Dispose();
+                }
+            }
+        }
+
+        // Returns null with the reason if the bundle is stale, truncated or doesn't describe itself correctly
+        private static Dictionary<string, AppBundleEntry> ReadIndex(Stream stream, byte[] expectedStamp, out string reason)
+        {
+            var capacity = stream.Length;
+            var reader = new BinaryReader(stream);
+
+            if (!reader.ReadBytes(Magic.Length).SequenceEqual(Magic))
+            {
+                // Written by an older kpm, or empty
+                reason = "unknown format";
+                return null;
+            }
+
+            var stamp = ReadBlock(reader, capacity);
+            if (stamp == null)
+            {
+                reason = "the header is truncated";
+                return null;
+            }
+
+            if (!stamp.SequenceEqual(expectedStamp))
+            {
+                reason = "the packages changed since it was written";
+                return null;
+            }
+
+            var count = ReadCount(reader, capacity);
+            if (count < 0)
+            {
+                reason = "the index is truncated";
+                return null;
+            }
+
+            var entries = new Dictionary<string, AppBundleEntry>(StringComparer.OrdinalIgnoreCase);
+            for (int i = 0; i < count; i++)
+            {
+                var name = ReadBlock(reader, capacity);
+                if (name == null || capacity - stream.Position < sizeof(long) + sizeof(long) + sizeof(int))
+                {
+                    reason = "the index is truncated";
+                    return null;
+                }
+
+                var entry = new AppBundleEntry(Encoding.UTF8.GetString(name), reader.ReadInt64(), reader.ReadInt64(), reader.ReadInt32());
+                if (entry.Offset < 0 || entry.Length < 0 || entry.Offset > capacity - entry.Length)
+                {
+                    reason = string.Format("the entry {0} is outside of the file", entry.Name);
+                    return null;
+                }
+
+                entries[entry.Name] = entry;
+            }
+
+            reason = null;
+            return entries;
+        }
+
+        private static int ReadCount(BinaryReader reader, long capacity)
+        {
+            if (capacity - reader.BaseStream.Position < sizeof(int))
+            {
+                return -1;
+            }
+
+            var count = reader.ReadInt32();
+            return count <= capacity - reader.BaseStream.Position ? count : -1;
+        }
+
+        private static byte[] ReadBlock(BinaryReader reader, long capacity)
+        {
+            var length = ReadCount(reader, capacity);
+            return length < 0 ? null : reader.ReadBytes(length);
+        }
+
+        /// <summary>
+        /// Opens the contents of the file at <paramref name="path"/> inside the application root, without
+        /// touching the file system.
+        /// </summary>
+        public bool TryOpen(string path, out Stream stream)
+        {
+            AppBundleEntry entry;
+            if (!TryGetEntry(path, out entry))
+            {
+                stream = null;
+                return false;
+            }
+
+            if (entry.Length == 0)
+            {
+                // A view of length 0 would reach to the end of the bundle
+                stream = new MemoryStream(new byte[0], writable: false);
+                return true;
+            }
+
+#if NET45
+            // A view can be longer than asked for, it ends on a page boundary
+            stream = new EntryStream(_file.CreateViewStream(entry.Offset, entry.Length, MemoryMappedFileAccess.Read), entry.Length);
+#else
+            // The loader reads the whole assembly anyway, one read keeps the shared handle's position to this call
+            var bytes = new byte[entry.Length];
+            lock (_file)
+            {
+                _file.Position = entry.Offset;
+
+                int read;
+                for (int total = 0; total < bytes.Length; total += read)
+                {
+                    read = _file.Read(bytes, total, bytes.Length - total);
+                    if (read == 0)
+                    {
+                        throw new EndOfStreamException(string.Format("{0} was truncated after it was opened", FileName));
+                    }
+                }
+            }
+
+            stream = new MemoryStream(bytes, writable: false);
+#endif
+            return true;
+        }
+
+        public bool Contains(string path)
+        {
+            AppBundleEntry entry;
+            return TryGetEntry(path, out entry);
+        }
+
+        public void Dispose()
+        {
+            _file.Dispose();
+        }
+
+        private bool TryGetEntry(string path, out AppBundleEntry entry)
+        {
+            entry = null;
+
+            var fullPath = Path.GetFullPath(path);
+            if (!fullPath.StartsWith(_rootDirectory, StringComparison.OrdinalIgnoreCase))
+            {
+                return false;
+            }
+
+            return _entries.TryGetValue(GetName(_rootDirectory, fullPath), out entry);
+        }
+
+        /// <summary>
+        /// Writes what the bundle loader serves into the bundle of <paramref name="rootDirectory"/>: the
+        /// assemblies and symbols in the lib folders of packages that don't have a native image.
+        /// </summary>
+        public static void Write(string rootDirectory)
+        {
+            rootDirectory = Path.GetFullPath(rootDirectory);
+            var bundlePath = Path.Combine(rootDirectory, FileName);
+            var packagesPath = Path.Combine(rootDirectory, "packages");
+
+            var files = Directory.Exists(packagesPath) ?
+                Directory.EnumerateFiles(packagesPath, "*", SearchOption.AllDirectories)
+                         .Where(path => IsServed(rootDirectory, path))
+                         .OrderBy(path => path, StringComparer.Ordinal)
+                         .ToList() :
+                new List<string>();
+
+            var stamp = ReadStamp(rootDirectory);
+
+            var names = files.Select(path => Encoding.UTF8.GetBytes(GetName(rootDirectory, path))).ToList();
+            var lengths = files.Select(path => new FileInfo(path).Length).ToList();
+            var flags = files.Select(GetFlags).ToList();
+
+            // The index has a fixed size per entry besides the name, so the data offsets are known up front
+            long offset = Magic.Length + sizeof(int) + stamp.Length + sizeof(int) + names.Sum(name => sizeof(int) + name.Length + sizeof(long) + sizeof(long) + sizeof(int));
+            var offsets = new long[files.Count];
+            for (int i = 0; i < files.Count; i++)
+            {
+                offset = Align(offset, (flags[i] & AssemblyFlag) != 0 ? PageSize : 8);
+                offsets[i] = offset;
+                offset += lengths[i];
+            }
+
+            var tempPath = bundlePath + "." + Guid.NewGuid().ToString("N");
+            try
+            {
+                using (var stream = new FileStream(tempPath, FileMode.Create, FileAccess.Write, FileShare.None))
+                {
+                    stream.SetLength(offset);
+
+                    var writer = new BinaryWriter(stream);
+                    writer.Write(Magic);
+                    writer.Write(stamp.Length);
+                    writer.Write(stamp);
+                    writer.Write(files.Count);
+                    for (int i = 0; i < files.Count; i++)
+                    {
+                        writer.Write(names[i].Length);
+                        writer.Write(names[i]);
+                        writer.Write(offsets[i]);
+                        writer.Write(lengths[i]);
+                        writer.Write(flags[i]);
+                    }
+                    writer.Flush();
+
+                    for (int i = 0; i < files.Count; i++)
+                    {
+                        stream.Position = offsets[i];
+                        using (var source = File.OpenRead(files[i]))
+                        {
+                            source.CopyTo(stream);
+                        }
+                    }
+                }
+
+                if (File.Exists(bundlePath))
+                {
+                    File.Delete(bundlePath);
+                }
+                File.Move(tempPath, bundlePath);
+            }
+            finally
+            {
+                if (File.Exists(tempPath))
+                {
+                    File.Delete(tempPath);
+                }
+            }
+        }
+
+        /// <summary>
+        /// Deletes the bundle of <paramref name="rootDirectory"/> if there is one.
+        /// </summary>
+        public static void Delete(string rootDirectory)
+        {
+            var bundlePath = Path.Combine(rootDirectory, FileName);
+            if (File.Exists(bundlePath))
+            {
+                File.Delete(bundlePath);
+            }
+        }
+
+        /// <summary>
+        /// Where the loader looks for the native image of an assembly, these are loaded from disk instead.
+        /// </summary>
+        public static string GetNativeImagePath(string assemblyPath)
+        {
+            return Path.Combine(Path.GetDirectoryName(assemblyPath),
+                                Environment.GetEnvironmentVariable("PROCESSOR_ARCHITECTURE") ?? string.Empty,
+                                Path.GetFileNameWithoutExtension(assemblyPath) + ".ni.dll");
+        }
+
+        private static bool IsServed(string rootDirectory, string path)
+        {
+            // packages/{id}/{version}/lib/...
+            var parts = GetName(rootDirectory, path).Split('/');
+            if (parts.Length < 5 || !string.Equals(parts[3], "lib", StringComparison.OrdinalIgnoreCase))
+            {
+                return false;
+            }
+
+            var flags = GetFlags(path);
+            if (flags == SymbolsFlag)
+            {
+                return true;
+            }
+
+            return flags == AssemblyFlag &&
+                   !path.EndsWith(".ni.dll", StringComparison.OrdinalIgnoreCase) &&
+                   !File.Exists(GetNativeImagePath(path));
+        }
+
+        private static byte[] ReadStamp(string rootDirectory)
+        {
+            var globalJsonPath = Path.Combine(rootDirectory, GlobalSettings.GlobalFileName);
+            return File.Exists(globalJsonPath) ? File.ReadAllBytes(globalJsonPath) : new byte[0];
+        }
+
+        private static int GetFlags(string path)
+        {
+            var extension = Path.GetExtension(path);
+            if (string.Equals(extension, ".dll", StringComparison.OrdinalIgnoreCase) ||
+                string.Equals(extension, ".exe", StringComparison.OrdinalIgnoreCase))
+            {
+                return AssemblyFlag;
+            }
+
+            if (string.Equals(extension, ".pdb", StringComparison.OrdinalIgnoreCase))
+            {
+                return SymbolsFlag;
+            }
+
+            return 0;
+        }
+
+        private static long Align(long offset, int alignment)
+        {
+            return (offset + alignment - 1) / alignment * alignment;
+        }
+
+        private static string GetName(string rootDirectory, string fullPath)
+        {
+            return fullPath.Substring(rootDirectory.Length)
+                           .TrimStart(Path.DirectorySeparatorChar, Path.AltDirectorySeparatorChar)
+                           .Replace(Path.DirectorySeparatorChar, '/');
+        }
+
+#if NET45
+        private class EntryStream : Stream
+        {
+            private readonly Stream _view;
+            private readonly long _length;
+
+            public EntryStream(Stream view, long length)
+            {
+                _view = view;
+                _length = length;
+            }
+
+            public override bool CanRead { get { return true; } }
+
+            public override bool CanSeek { get { return true; } }
+
+            public override bool CanWrite { get { return false; } }
+
+            public override long Length { get { return _length; } }
+
+            public override long Position
+            {
+                get { return _view.Position; }
+                set { _view.Position = value; }
+            }
+
+            public override int Read(byte[] buffer, int offset, int count)
+            {
+                var remaining = _length - _view.Position;
+                if (remaining <= 0)
+                {
+                    return 0;
+                }
+
+                return _view.Read(buffer, offset, (int)Math.Min(count, remaining));
+            }
+
+            public override long Seek(long offset, SeekOrigin origin)
+            {
+                switch (origin)
+                {
+                    case SeekOrigin.Current:
+                        offset += Position;
+                        break;
+                    case SeekOrigin.End:
+                        offset += _length;
+                        break;
+                }
+
+                Position = offset;
+                return offset;
+            }
+
+            public override void Flush()
+            {
+            }
+
+            public override void SetLength(long value)
+            {
+                throw new NotSupportedException();
+            }
+
+            public override void Write(byte[] buffer, int offset, int count)
+            {
+                throw new NotSupportedException();
+            }
+
+            protected override void Dispose(bool disposing)
+            {
+                if (disposing)
+                {
+                    _view.Dispose();
+                }
+
+                base.Dispose(disposing);
+            }
+        }
+#endif
+    }
+
+    public class AppBundleEntry
+    {
+        public AppBundleEntry(string name, long offset, long length, int flags)
+        {
+            Name = name;
+            Offset = offset;
+            Length = length;
+            Flags = flags;
+        }
+
+        public string Name { get; private set; }
+
+        public long Offset { get; private set; }
+
+        public long Length { get; private set; }
+
+        public int Flags { get; private set; }
+    }
+}
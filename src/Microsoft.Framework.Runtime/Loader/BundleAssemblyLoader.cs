@@ -0,0 +1,56 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+using System.IO;
+using System.Reflection;
+
+namespace Microsoft.Framework.Runtime.Loader
+{
+    /// <summary>
+    /// Loads package assemblies of a packed application out of its <see cref="AppBundle"/>.
+    /// </summary>
+    public class BundleAssemblyLoader : IAssemblyLoader
+    {
+        private readonly IAssemblyLoaderEngine _loaderEngine;
+        private readonly AppBundle _bundle;
+        private readonly NuGetDependencyResolver _dependencyResolver;
+
+        public BundleAssemblyLoader(IAssemblyLoaderEngine loaderEngine, AppBundle bundle, NuGetDependencyResolver dependencyResolver)
+        {
+            _loaderEngine = loaderEngine;
+            _bundle = bundle;
+            _dependencyResolver = dependencyResolver;
+        }
+
+        public Assembly Load(string name)
+        {
+            PackageAssembly assemblyInfo;
+            if (!_dependencyResolver.PackageAssemblyLookup.TryGetValue(name, out assemblyInfo))
+            {
+                return null;
+            }
+
+            if (File.Exists(AppBundle.GetNativeImagePath(assemblyInfo.Path)))
+            {
+                // The NuGet loader loads the native image instead
+                return null;
+            }
+
+            Stream assemblyStream;
+            if (!_bundle.TryOpen(assemblyInfo.Path, out assemblyStream))
+            {
+                // Not packed into the bundle, the NuGet loader finds it on disk
+                return null;
+            }
+
+            Stream pdbStream;
+            _bundle.TryOpen(Path.ChangeExtension(assemblyInfo.Path, ".pdb"), out pdbStream);
+
+            using (assemblyStream)
+            using (pdbStream)
+            {
+                return _loaderEngine.LoadStream(assemblyStream, pdbStream);
+            }
+        }
+    }
+}
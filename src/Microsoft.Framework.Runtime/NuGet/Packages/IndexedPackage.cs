@@ -0,0 +1,110 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Runtime.Versioning;
+
+namespace NuGet
+{
+    /// <summary>
+    /// A package in a packages folder whose dependency and reference metadata comes from a
+    /// <see cref="PackageMetadataIndex"/>. Anything else reads the nuspec on first use.
+    /// </summary>
+    public class IndexedPackage : IPackage
+    {
+        private readonly IFileSystem _repositoryRoot;
+        private readonly string _nuspecPath;
+        private UnzippedPackage _package;
+
+        public IndexedPackage(IFileSystem repositoryRoot, string nuspecPath, string id, SemanticVersion version)
+        {
+            _repositoryRoot = repositoryRoot;
+            _nuspecPath = nuspecPath;
+            Id = id;
+            Version = version;
+        }
+
+        public string Id { get; private set; }
+
+        public SemanticVersion Version { get; private set; }
+
+        public IEnumerable<PackageDependencySet> DependencySets { get; internal set; }
+
+        public IEnumerable<FrameworkAssemblyReference> FrameworkAssemblies { get; internal set; }
+
+        public ICollection<PackageReferenceSet> PackageAssemblyReferences { get; internal set; }
+
+        public IEnumerable<IPackageAssemblyReference> AssemblyReferences { get; internal set; }
+
+        public string Title { get { return Package.Title; } }
+
+        public IEnumerable<string> Authors { get { return Package.Authors; } }
+
+        public IEnumerable<string> Owners { get { return Package.Owners; } }
+
+        public Uri IconUrl { get { return Package.IconUrl; } }
+
+        public Uri LicenseUrl { get { return Package.LicenseUrl; } }
+
+        public Uri ProjectUrl { get { return Package.ProjectUrl; } }
+
+        public bool RequireLicenseAcceptance { get { return Package.RequireLicenseAcceptance; } }
+
+        public string Description { get { return Package.Description; } }
+
+        public string Summary { get { return Package.Summary; } }
+
+        public string ReleaseNotes { get { return Package.ReleaseNotes; } }
+
+        public string Language { get { return Package.Language; } }
+
+        public string Tags { get { return Package.Tags; } }
+
+        public string Copyright { get { return Package.Copyright; } }
+
+        public Version MinClientVersion { get { return Package.MinClientVersion; } }
+
+        public bool IsAbsoluteLatestVersion { get { return Package.IsAbsoluteLatestVersion; } }
+
+        public bool IsLatestVersion { get { return Package.IsLatestVersion; } }
+
+        public bool Listed { get { return Package.Listed; } }
+
+        public DateTimeOffset? Published { get { return Package.Published; } }
+
+        private UnzippedPackage Package
+        {
+            get
+            {
+                if (_package == null)
+                {
+                    _package = new UnzippedPackage(_repositoryRoot, _nuspecPath);
+                }
+
+                return _package;
+            }
+        }
+
+        public IEnumerable<IPackageFile> GetFiles()
+        {
+            return Package.GetFiles();
+        }
+
+        public IEnumerable<FrameworkName> GetSupportedFrameworks()
+        {
+            return Package.GetSupportedFrameworks();
+        }
+
+        public Stream GetStream()
+        {
+            return Package.GetStream();
+        }
+
+        public override string ToString()
+        {
+            return Id + " " + Version;
+        }
+    }
+}
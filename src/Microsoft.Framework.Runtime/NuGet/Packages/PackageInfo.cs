@@ -7,14 +7,21 @@ public class PackageInfo
     {
         private readonly IFileSystem _repositoryRoot;
         private readonly string _versionDir;
+        private readonly PackageMetadataIndex _index;
         private IPackage _package;
 
         public PackageInfo(IFileSystem repositoryRoot, string packageId, SemanticVersion version, string versionDir)
+            : this(repositoryRoot, packageId, version, versionDir, index: null)
+        {
+        }
+
+        public PackageInfo(IFileSystem repositoryRoot, string packageId, SemanticVersion version, string versionDir, PackageMetadataIndex index)
         {
             _repositoryRoot = repositoryRoot;
             Id = packageId;
             Version = version;
             _versionDir = versionDir;
+            _index = index;
         }
 
         public string Id { get; private set; }
@@ -28,7 +35,16 @@ public IPackage Package
                 if (_package == null)
                 {
                     var nuspecPath = Path.Combine(_versionDir, string.Format("{0}.nuspec", Id));
-                    _package = new UnzippedPackage(_repositoryRoot, nuspecPath);
+
+                    if (_index != null)
+                    {
+                        _package = _index.GetPackage(_repositoryRoot, _versionDir, nuspecPath);
+                    }
+
+                    if (_package == null)
+                    {
+                        _package = new UnzippedPackage(_repositoryRoot, nuspecPath);
+                    }
                 }
 
                 return _package;
@@ -0,0 +1,426 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.IO;
+using System.Linq;
+using System.Runtime.Versioning;
+
+namespace NuGet
+{
+    /// <summary>
+    /// A binary index of the nuspec metadata of every package in a packages folder. Entries are sorted by
+    /// version folder so a lookup is a binary search, and an entry is only decoded when it is used. Entries
+    /// are validated against the write time of the nuspec, stale or missing entries fall back to reading
+    /// the nuspec.
+    /// </summary>
+    public class PackageMetadataIndex
+    {
+        public const string FileName = "packages.idx";
+
+        // "KPIX"
+        private const int Signature = 0x5849504B;
+        private const int FormatVersion = 1;
+
+        private readonly string[] _keys;
+        private readonly long[] _nuspecTimes;
+        private readonly int[] _offsets;
+        private readonly byte[] _data;
+
+        private PackageMetadataIndex(string[] keys, long[] nuspecTimes, int[] offsets, byte[] data)
+        {
+            _keys = keys;
+            _nuspecTimes = nuspecTimes;
+            _offsets = offsets;
+            _data = data;
+        }
+
+        public int Count
+        {
+            get { return _keys.Length; }
+        }
+
+        public static PackageMetadataIndex Open(string repositoryRoot)
+        {
+            var path = Path.Combine(repositoryRoot, FileName);
+            if (!File.Exists(path))
+            {
+                return null;
+            }
+
+            try
+            {
+                var data = File.ReadAllBytes(path);
+                using (var reader = new BinaryReader(new MemoryStream(data)))
+                {
+                    if (reader.ReadInt32() != Signature || reader.ReadInt32() != FormatVersion)
+                    {
+                        return null;
+                    }
+
+                    var count = reader.ReadInt32();
+                    var keys = new string[count];
+                    var nuspecTimes = new long[count];
+                    var offsets = new int[count];
+
+                    for (var i = 0; i < count; i++)
+                    {
+                        keys[i] = reader.ReadString();
+                        nuspecTimes[i] = reader.ReadInt64();
+                        offsets[i] = reader.ReadInt32();
+                    }
+
+                    // Offsets are relative to the end of the table
+                    var start = (int)reader.BaseStream.Position;
+                    for (var i = 0; i < count; i++)
+                    {
+                        offsets[i] += start;
+                    }
+
+                    return new PackageMetadataIndex(keys, nuspecTimes, offsets, data);
+                }
+            }
+            catch (Exception ex)
+            {
+                Trace.TraceInformation("[{0}]: Ignoring {1}: {2}", typeof(PackageMetadataIndex).Name, path, ex.Message);
+                return null;
+            }
+        }
+
+        /// <summary>
+        /// Returns the package in <paramref name="versionDir"/> if the index has an up to date entry for it.
+        /// </summary>
+        public IPackage GetPackage(IFileSystem repositoryRoot, string versionDir, string nuspecPath)
+        {
+            var index = Array.BinarySearch(_keys, versionDir, StringComparer.OrdinalIgnoreCase);
+            if (index < 0)
+            {
+                return null;
+            }
+
+            if (_nuspecTimes[index] != GetWriteTime(repositoryRoot.GetFullPath(nuspecPath)))
+            {
+                return null;
+            }
+
+            using (var reader = new BinaryReader(new MemoryStream(_data, _offsets[index], _data.Length - _offsets[index])))
+            {
+                return ReadPackage(reader, repositoryRoot, versionDir, nuspecPath);
+            }
+        }
+
+        /// <summary>
+        /// Brings the index of <paramref name="repositoryRoot"/> up to date. Only packages that were added or
+        /// changed since the last update have their nuspec read.
+        /// </summary>
+        public static void Update(string repositoryRoot)
+        {
+            var fileSystem = new PhysicalFileSystem(repositoryRoot);
+            var existing = Open(repositoryRoot);
+            var entries = new SortedDictionary<string, KeyValuePair<long, byte[]>>(StringComparer.OrdinalIgnoreCase);
+            var reused = 0;
+
+            foreach (var idDir in fileSystem.GetDirectories(string.Empty))
+            {
+                var id = Path.GetFileName(idDir);
+
+                foreach (var versionDir in fileSystem.GetDirectories(idDir))
+                {
+                    var nuspecPath = Path.Combine(versionDir, id + Constants.ManifestExtension);
+                    var nuspecFullPath = fileSystem.GetFullPath(nuspecPath);
+                    if (!File.Exists(nuspecFullPath))
+                    {
+                        continue;
+                    }
+
+                    var writeTime = GetWriteTime(nuspecFullPath);
+                    var payload = existing != null ? existing.GetPayload(versionDir, writeTime) : null;
+
+                    if (payload != null)
+                    {
+                        reused++;
+                    }
+                    else
+                    {
+                        try
+                        {
+                            payload = CreatePayload(new UnzippedPackage(fileSystem, nuspecPath));
+                        }
+                        catch (Exception ex)
+                        {
+                            // Leave broken packages to the nuspec reader so they fail the same way they always did
+                            Trace.TraceInformation("[{0}]: Skipping {1}: {2}", typeof(PackageMetadataIndex).Name, nuspecFullPath, ex.Message);
+                            continue;
+                        }
+                    }
+
+                    entries[versionDir] = new KeyValuePair<long, byte[]>(writeTime, payload);
+                }
+            }
+
+            Write(repositoryRoot, entries);
+
+            Trace.TraceInformation("[{0}]: Indexed {1} packages in {2}, {3} unchanged", typeof(PackageMetadataIndex).Name, entries.Count, repositoryRoot, reused);
+        }
+
+        private byte[] GetPayload(string versionDir, long nuspecTime)
+        {
+            var index = Array.BinarySearch(_keys, versionDir, StringComparer.OrdinalIgnoreCase);
+            if (index < 0 || _nuspecTimes[index] != nuspecTime)
+            {
+                return null;
+            }
+
+            var end = index + 1 < _offsets.Length ? _offsets[index + 1] : _data.Length;
+            var payload = new byte[end - _offsets[index]];
+            Buffer.BlockCopy(_data, _offsets[index], payload, 0, payload.Length);
+            return payload;
+        }
+
+        private static void Write(string repositoryRoot, SortedDictionary<string, KeyValuePair<long, byte[]>> entries)
+        {
+            var path = Path.Combine(repositoryRoot, FileName);
+
+            // Concurrent restores each write their own file, the last one to be moved in wins
+            var tempPath = path + "." + Guid.NewGuid().ToString("N");
+
+            using (var writer = new BinaryWriter(new FileStream(tempPath, FileMode.Create, FileAccess.Write, FileShare.None)))
+            {
+                writer.Write(Signature);
+                writer.Write(FormatVersion);
+                writer.Write(entries.Count);
+
+                var offset = 0;
+                foreach (var entry in entries)
+                {
+                    writer.Write(entry.Key);
+                    writer.Write(entry.Value.Key);
+                    writer.Write(offset);
+                    offset += entry.Value.Value.Length;
+                }
+
+                foreach (var entry in entries)
+                {
+                    writer.Write(entry.Value.Value);
+                }
+            }
+
+            try
+            {
+                if (File.Exists(path))
+                {
+                    File.Delete(path);
+                }
+                File.Move(tempPath, path);
+            }
+            catch (IOException)
+            {
+                File.Delete(tempPath);
+            }
+            catch (UnauthorizedAccessException)
+            {
+                File.Delete(tempPath);
+            }
+        }
+
+        private static long GetWriteTime(string path)
+        {
+            return File.GetLastWriteTimeUtc(path).Ticks;
+        }
+
+        private static byte[] CreatePayload(IPackage package)
+        {
+            using (var stream = new MemoryStream())
+            {
+                using (var writer = new BinaryWriter(stream))
+                {
+                    writer.Write(package.Id);
+                    WriteVersion(writer, package.Version);
+
+                    var dependencySets = package.DependencySets.ToList();
+                    writer.Write(dependencySets.Count);
+                    foreach (var set in dependencySets)
+                    {
+                        WriteFrameworkName(writer, set.TargetFramework);
+                        writer.Write(set.Dependencies.Count);
+                        foreach (var dependency in set.Dependencies)
+                        {
+                            writer.Write(dependency.Id);
+                            WriteVersionSpec(writer, dependency.VersionSpec);
+                        }
+                    }
+
+                    var frameworkAssemblies = package.FrameworkAssemblies.ToList();
+                    writer.Write(frameworkAssemblies.Count);
+                    foreach (var assembly in frameworkAssemblies)
+                    {
+                        writer.Write(assembly.AssemblyName);
+                        var supportedFrameworks = assembly.SupportedFrameworks.ToList();
+                        writer.Write(supportedFrameworks.Count);
+                        foreach (var framework in supportedFrameworks)
+                        {
+                            WriteFrameworkName(writer, framework);
+                        }
+                    }
+
+                    var referenceSets = package.PackageAssemblyReferences.ToList();
+                    writer.Write(referenceSets.Count);
+                    foreach (var set in referenceSets)
+                    {
+                        WriteFrameworkName(writer, set.TargetFramework);
+                        writer.Write(set.References.Count);
+                        foreach (var reference in set.References)
+                        {
+                            writer.Write(reference);
+                        }
+                    }
+
+                    var assemblyReferences = package.AssemblyReferences.ToList();
+                    writer.Write(assemblyReferences.Count);
+                    foreach (var reference in assemblyReferences)
+                    {
+                        writer.Write(reference.Path);
+                    }
+                }
+
+                return stream.ToArray();
+            }
+        }
+
+        private static IPackage ReadPackage(BinaryReader reader, IFileSystem repositoryRoot, string versionDir, string nuspecPath)
+        {
+            var id = reader.ReadString();
+            var version = ReadVersion(reader);
+
+            var dependencySets = new List<PackageDependencySet>();
+            var count = reader.ReadInt32();
+            for (var i = 0; i < count; i++)
+            {
+                var targetFramework = ReadFrameworkName(reader);
+                var dependencies = new List<PackageDependency>();
+                var dependencyCount = reader.ReadInt32();
+                for (var j = 0; j < dependencyCount; j++)
+                {
+                    dependencies.Add(new PackageDependency(reader.ReadString(), ReadVersionSpec(reader)));
+                }
+                dependencySets.Add(new PackageDependencySet(targetFramework, dependencies));
+            }
+
+            var frameworkAssemblies = new List<FrameworkAssemblyReference>();
+            count = reader.ReadInt32();
+            for (var i = 0; i < count; i++)
+            {
+                var assemblyName = reader.ReadString();
+                var supportedFrameworks = new List<FrameworkName>();
+                var frameworkCount = reader.ReadInt32();
+                for (var j = 0; j < frameworkCount; j++)
+                {
+                    supportedFrameworks.Add(ReadFrameworkName(reader));
+                }
+                frameworkAssemblies.Add(new FrameworkAssemblyReference(assemblyName, supportedFrameworks));
+            }
+
+            var referenceSets = new List<PackageReferenceSet>();
+            count = reader.ReadInt32();
+            for (var i = 0; i < count; i++)
+            {
+                var targetFramework = ReadFrameworkName(reader);
+                var references = new List<string>();
+                var referenceCount = reader.ReadInt32();
+                for (var j = 0; j < referenceCount; j++)
+                {
+                    references.Add(reader.ReadString());
+                }
+                referenceSets.Add(new PackageReferenceSet(targetFramework, references));
+            }
+
+            var packageDirectory = repositoryRoot.GetFullPath(versionDir);
+            var assemblyReferences = new List<IPackageAssemblyReference>();
+            count = reader.ReadInt32();
+            for (var i = 0; i < count; i++)
+            {
+                var path = reader.ReadString();
+                assemblyReferences.Add(new PhysicalPackageAssemblyReference(new PhysicalPackageFile
+                {
+                    SourcePath = Path.Combine(packageDirectory, path),
+                    TargetPath = path
+                }));
+            }
+
+            return new IndexedPackage(repositoryRoot, nuspecPath, id, version)
+            {
+                DependencySets = dependencySets,
+                FrameworkAssemblies = frameworkAssemblies,
+                PackageAssemblyReferences = referenceSets,
+                AssemblyReferences = assemblyReferences
+            };
+        }
+
+        private static void WriteVersion(BinaryWriter writer, SemanticVersion version)
+        {
+            // ToString drops the snapshot marker
+            WriteNullableString(writer, version == null ? null : version.ToString() + (version.IsSnapshot ? "-*" : string.Empty));
+        }
+
+        private static SemanticVersion ReadVersion(BinaryReader reader)
+        {
+            var version = ReadNullableString(reader);
+            return version == null ? null : SemanticVersion.Parse(version);
+        }
+
+        private static void WriteVersionSpec(BinaryWriter writer, IVersionSpec versionSpec)
+        {
+            writer.Write(versionSpec != null);
+            if (versionSpec != null)
+            {
+                WriteVersion(writer, versionSpec.MinVersion);
+                writer.Write(versionSpec.IsMinInclusive);
+                WriteVersion(writer, versionSpec.MaxVersion);
+                writer.Write(versionSpec.IsMaxInclusive);
+            }
+        }
+
+        private static IVersionSpec ReadVersionSpec(BinaryReader reader)
+        {
+            if (!reader.ReadBoolean())
+            {
+                return null;
+            }
+
+            return new VersionSpec
+            {
+                MinVersion = ReadVersion(reader),
+                IsMinInclusive = reader.ReadBoolean(),
+                MaxVersion = ReadVersion(reader),
+                IsMaxInclusive = reader.ReadBoolean()
+            };
+        }
+
+        private static void WriteFrameworkName(BinaryWriter writer, FrameworkName frameworkName)
+        {
+            WriteNullableString(writer, frameworkName == null ? null : frameworkName.FullName);
+        }
+
+        private static FrameworkName ReadFrameworkName(BinaryReader reader)
+        {
+            var frameworkName = ReadNullableString(reader);
+            return frameworkName == null ? null : new FrameworkName(frameworkName);
+        }
+
+        private static string ReadNullableString(BinaryReader reader)
+        {
+            return reader.ReadBoolean() ? reader.ReadString() : null;
+        }
+
+        private static void WriteNullableString(BinaryWriter writer, string value)
+        {
+            writer.Write(value != null);
+            if (value != null)
+            {
+                writer.Write(value);
+            }
+        }
+    }
+}
@@ -2,6 +2,7 @@
 // Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
 
 using System;
+using System.Collections.Concurrent;
 using System.Collections.Generic;
 using System.IO;
 
@@ -9,12 +10,28 @@ namespace NuGet
 {
     public class PackageRepository
     {
-        private readonly Dictionary<string, IEnumerable<PackageInfo>> _cache = new Dictionary<string, IEnumerable<PackageInfo>>(StringComparer.OrdinalIgnoreCase);
+        private readonly ConcurrentDictionary<string, PackageEntry> _cache = new ConcurrentDictionary<string, PackageEntry>(StringComparer.OrdinalIgnoreCase);
         private readonly IFileSystem _repositoryRoot;
+        private readonly bool _detectChanges;
+        private readonly object _indexLock = new object();
+        private PackageMetadataIndex _index;
+        private DateTime _indexWriteTime;
+        private bool _indexLoaded;
 
         public PackageRepository(string path)
+            : this(path, detectChanges: false)
+        {
+        }
+
+        /// <summary>
+        /// When <paramref name="detectChanges"/> is true, cached results for a package id are dropped as soon as
+        /// the package id folder changes (e.g. a version was installed). Use this for repositories that outlive
+        /// a single dependency walk.
+        /// </summary>
+        public PackageRepository(string path, bool detectChanges)
         {
             _repositoryRoot = new PhysicalFileSystem(path);
+            _detectChanges = detectChanges;
         }
 
         public IFileSystem RepositoryRoot
@@ -32,36 +49,90 @@ public IEnumerable<PackageInfo> FindPackagesById(string packageId)
                 throw new ArgumentNullException("packageId");
             }
 
-            // packages\{packageId}\{version}\{packageId}.nuspec
-            return _cache.GetOrAdd(packageId, id =>
+            var writeTime = _detectChanges ? GetWriteTime(packageId) : DateTime.MinValue;
+
+            PackageEntry entry;
+            if (_cache.TryGetValue(packageId, out entry) && entry.WriteTime == writeTime)
+            {
+                return entry.Packages;
+            }
+
+            entry = new PackageEntry
+            {
+                Packages = FindPackages(packageId),
+                WriteTime = writeTime
+            };
+
+            _cache[packageId] = entry;
+            return entry.Packages;
+        }
+
+        private PackageMetadataIndex GetIndex()
+        {
+            lock (_indexLock)
             {
-                var packages = new List<PackageInfo>();
+                if (_indexLoaded && !_detectChanges)
+                {
+                    return _index;
+                }
+
+                var path = Path.Combine(_repositoryRoot.Root, PackageMetadataIndex.FileName);
+                var writeTime = File.Exists(path) ? File.GetLastWriteTimeUtc(path) : DateTime.MinValue;
 
-                foreach (var versionDir in _repositoryRoot.GetDirectories(id))
+                if (!_indexLoaded || writeTime != _indexWriteTime)
                 {
-                    // versionDir = {packageId}\{version}
-                    var folders = versionDir.Split(new[] { Path.DirectorySeparatorChar }, 2);
+                    _index = PackageMetadataIndex.Open(_repositoryRoot.Root);
+                    _indexWriteTime = writeTime;
+                    _indexLoaded = true;
+                }
+
+                return _index;
+            }
+        }
+
+        private DateTime GetWriteTime(string packageId)
+        {
+            var path = Path.Combine(_repositoryRoot.Root, packageId);
+            return Directory.Exists(path) ? Directory.GetLastWriteTimeUtc(path) : DateTime.MinValue;
+        }
 
-                    // Unknown format
-                    if (folders.Length < 2)
-                    {
-                        continue;
-                    }
+        private List<PackageInfo> FindPackages(string id)
+        {
+            // packages\{packageId}\{version}\{packageId}.nuspec
+            var packages = new List<PackageInfo>();
+            var index = GetIndex();
+
+            foreach (var versionDir in _repositoryRoot.GetDirectories(id))
+            {
+                // versionDir = {packageId}\{version}
+                var folders = versionDir.Split(new[] { Path.DirectorySeparatorChar }, 2);
 
-                    string versionPart = folders[1];
+                // Unknown format
+                if (folders.Length < 2)
+                {
+                    continue;
+                }
 
-                    // Get the version part and parse it
-                    SemanticVersion version;
-                    if (!SemanticVersion.TryParse(versionPart, out version))
-                    {
-                        continue;
-                    }
+                string versionPart = folders[1];
 
-                    packages.Add(new PackageInfo(_repositoryRoot, id, version, versionDir));
+                // Get the version part and parse it
+                SemanticVersion version;
+                if (!SemanticVersion.TryParse(versionPart, out version))
+                {
+                    continue;
                 }
 
-                return packages;
-            });
+                packages.Add(new PackageInfo(_repositoryRoot, id, version, versionDir, index));
+            }
+
+            return packages;
+        }
+
+        private class PackageEntry
+        {
+            public List<PackageInfo> Packages { get; set; }
+
+            public DateTime WriteTime { get; set; }
         }
     }
 }
\ No newline at end of file
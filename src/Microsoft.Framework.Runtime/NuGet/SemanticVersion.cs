@@ -2,6 +2,7 @@
 // Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
 
 using System;
+using System.Collections.Concurrent;
 using System.Globalization;
 using System.Text.RegularExpressions;
 using NuGet.Resources;
@@ -17,8 +18,17 @@ public sealed class SemanticVersion : IComparable, IComparable<SemanticVersion>,
         private const RegexOptions _flags = RegexOptions.IgnoreCase | RegexOptions.ExplicitCapture;
         private static readonly Regex _semanticVersionRegex = new Regex(@"^(?<Version>\d+(\s*\.\s*\d+){0,3})(?<Release>-[a-z][0-9a-z-]*)?$", _flags);
         private static readonly Regex _strictSemanticVersionRegex = new Regex(@"^(?<Version>\d+(\.\d+){2})(?<Release>-[a-z][0-9a-z-]*)?$", _flags);
+        // Special versions compare case insensitively, interning them makes equality a reference check
+        private static readonly ConcurrentDictionary<string, string> _specialVersions = new ConcurrentDictionary<string, string>(StringComparer.OrdinalIgnoreCase);
         private readonly string _originalString;
 
+        // Major and minor in the high word, build and revision in the low word. All components of a
+        // normalized version are non-negative so ordering the words orders the versions.
+        private readonly ulong _high;
+        private readonly ulong _low;
+        private readonly string _specialVersionKey;
+        private Version _version;
+
         public SemanticVersion(string version)
             : this(Parse(version))
         {
@@ -53,17 +63,32 @@ private SemanticVersion(Version version, string specialVersion, string originalS
             {
                 throw new ArgumentNullException("version");
             }
-            Version = NormalizeVersionValue(version);
+            _high = Pack(version.Major, version.Minor);
+            _low = Pack(Math.Max(version.Build, 0), Math.Max(version.Revision, 0));
             SpecialVersion = specialVersion ?? String.Empty;
+            _specialVersionKey = InternSpecialVersion(SpecialVersion);
             IsSnapshot = isSnapshot;
             _originalString = String.IsNullOrEmpty(originalString) ? version.ToString() + (!String.IsNullOrEmpty(specialVersion) ? '-' + specialVersion : null) : originalString;
         }
 
+        private SemanticVersion(int major, int minor, int build, int revision, string specialVersion, string originalString, bool isSnapshot)
+        {
+            _high = Pack(major, minor);
+            _low = Pack(build, revision);
+            SpecialVersion = specialVersion;
+            _specialVersionKey = InternSpecialVersion(specialVersion);
+            IsSnapshot = isSnapshot;
+            _originalString = originalString;
+        }
+
         internal SemanticVersion(SemanticVersion semVer)
         {
             _originalString = semVer.ToString();
-            Version = semVer.Version;
+            _high = semVer._high;
+            _low = semVer._low;
+            _version = semVer._version;
             SpecialVersion = semVer.SpecialVersion;
+            _specialVersionKey = semVer._specialVersionKey;
             IsSnapshot = semVer.IsSnapshot;
         }
 
@@ -72,8 +97,14 @@ internal SemanticVersion(SemanticVersion semVer)
         /// </summary>
         public Version Version
         {
-            get;
-            private set;
+            get
+            {
+                if (_version == null)
+                {
+                    _version = new Version((int)(_high >> 32), (int)(uint)_high, (int)(_low >> 32), (int)(uint)_low);
+                }
+                return _version;
+            }
         }
 
         /// <summary>
@@ -160,7 +191,7 @@ public static SemanticVersion Parse(string version)
         /// </summary>
         public static bool TryParse(string version, out SemanticVersion value)
         {
-            return TryParseInternal(version, _semanticVersionRegex, out value);
+            return TryParseInternal(version, strict: false, semVer: out value);
         }
 
         /// <summary>
@@ -168,10 +199,10 @@ public static bool TryParse(string version, out SemanticVersion value)
         /// </summary>
         public static bool TryParseStrict(string version, out SemanticVersion value)
         {
-            return TryParseInternal(version, _strictSemanticVersionRegex, out value);
+            return TryParseInternal(version, strict: true, semVer: out value);
         }
 
-        private static bool TryParseInternal(string version, Regex regex, out SemanticVersion semVer)
+        private static bool TryParseInternal(string version, bool strict, out SemanticVersion semVer)
         {
             semVer = null;
             if (String.IsNullOrEmpty(version))
@@ -186,6 +217,117 @@ private static bool TryParseInternal(string version, Regex regex, out SemanticVe
                 version = version.Substring(0, version.Length - 2);
             }
 
+            var trimmed = version.Trim();
+
+            // The scanner only understands ASCII, leave anything else to the regex so it parses exactly as before
+            for (int i = 0; i < trimmed.Length; i++)
+            {
+                if (trimmed[i] > 0x7F)
+                {
+                    return TryParseWithRegex(version, strict ? _strictSemanticVersionRegex : _semanticVersionRegex, isSnapshot, out semVer);
+                }
+            }
+
+            return TryScan(trimmed, version, strict, isSnapshot, out semVer);
+        }
+
+        /// <summary>
+        /// Matches the version regexes followed by <see cref="System.Version.TryParse(string, out Version)"/> for ASCII input
+        /// without allocating anything but the special version.
+        /// </summary>
+        private static bool TryScan(string value, string version, bool strict, bool isSnapshot, out SemanticVersion semVer)
+        {
+            semVer = null;
+
+            int major = 0, minor = 0, build = 0, revision = 0;
+            int count = 0;
+            int index = 0;
+
+            while (true)
+            {
+                if (index == value.Length || !IsDigit(value[index]))
+                {
+                    return false;
+                }
+
+                long component = 0;
+                while (index < value.Length && IsDigit(value[index]))
+                {
+                    component = component * 10 + (value[index] - '0');
+                    if (component > Int32.MaxValue)
+                    {
+                        return false;
+                    }
+                    index++;
+                }
+
+                switch (count++)
+                {
+                    case 0: major = (int)component; break;
+                    case 1: minor = (int)component; break;
+                    case 2: build = (int)component; break;
+                    case 3: revision = (int)component; break;
+                    default: return false;
+                }
+
+                // Whitespace is only allowed around the dots of a loose version
+                var next = index;
+                if (!strict)
+                {
+                    while (next < value.Length && IsWhiteSpace(value[next]))
+                    {
+                        next++;
+                    }
+                }
+
+                if (next == value.Length || value[next] != '.')
+                {
+                    break;
+                }
+
+                next++;
+                if (!strict)
+                {
+                    while (next < value.Length && IsWhiteSpace(value[next]))
+                    {
+                        next++;
+                    }
+                }
+                index = next;
+            }
+
+            if (strict ? count != 3 : count < 2)
+            {
+                return false;
+            }
+
+            var specialVersion = String.Empty;
+            if (index < value.Length)
+            {
+                if (value[index] != '-' || index + 1 == value.Length || !IsLetter(value[index + 1]))
+                {
+                    return false;
+                }
+
+                for (int i = index + 2; i < value.Length; i++)
+                {
+                    if (!IsLetter(value[i]) && !IsDigit(value[i]) && value[i] != '-')
+                    {
+                        return false;
+                    }
+                }
+
+                specialVersion = value.Substring(index + 1);
+            }
+
+            semVer = new SemanticVersion(major, minor, build, revision, specialVersion, version.Replace(" ", ""), isSnapshot);
+            return true;
+        }
+
+        private static bool TryParseWithRegex(string version, Regex regex, bool isSnapshot, out SemanticVersion semVer)
+        {
+            semVer = null;
+
             var match = regex.Match(version.Trim());
             Version versionValue;
             if (!match.Success || !Version.TryParse(match.Groups["Version"].Value, out versionValue))
@@ -193,7 +335,7 @@ private static bool TryParseInternal(string version, Regex regex, out SemanticVe
                 return false;
             }
 
-            semVer = new SemanticVersion(NormalizeVersionValue(versionValue), match.Groups["Release"].Value.TrimStart('-'), version.Replace(" ", ""), isSnapshot);
+            semVer = new SemanticVersion(versionValue, match.Groups["Release"].Value.TrimStart('-'), version.Replace(" ", ""), isSnapshot);
             return true;
         }
 
@@ -208,19 +350,42 @@ public static SemanticVersion ParseOptionalVersion(string version)
             return semVer;
         }
 
-        private static Version NormalizeVersionValue(Version version)
+        private static ulong Pack(int high, int low)
+        {
+            return ((ulong)(uint)high << 32) | (uint)low;
+        }
+
+        private static string InternSpecialVersion(string specialVersion)
         {
-            return new Version(version.Major,
-                               version.Minor,
-                               Math.Max(version.Build, 0),
-                               Math.Max(version.Revision, 0));
+            if (specialVersion.Length == 0)
+            {
+                return String.Empty;
+            }
+            return _specialVersions.GetOrAdd(specialVersion, specialVersion);
+        }
+
+        private static bool IsDigit(char c)
+        {
+            return c >= '0' && c <= '9';
+        }
+
+        private static bool IsLetter(char c)
+        {
+            return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+        }
+
+        private static bool IsWhiteSpace(char c)
+        {
+            // The whitespace both \s and Int32.Parse accept
+            return c == ' ' || (c >= '\t' && c <= '\r');
         }
 
         public bool EqualsSnapshot(SemanticVersion seekingVersion)
         {
             if (seekingVersion.IsSnapshot)
             {
-                return Version == seekingVersion.Version &&
+                return _high == seekingVersion._high &&
+                    _low == seekingVersion._low &&
                     SpecialVersion.StartsWith(seekingVersion.SpecialVersion, StringComparison.OrdinalIgnoreCase);
             }
             else
@@ -250,20 +415,24 @@ public int CompareTo(SemanticVersion other)
                 return 1;
             }
 
-            int result = Version.CompareTo(other.Version);
+            if (_high != other._high)
+            {
+                return _high < other._high ? -1 : 1;
+            }
 
-            if (result != 0)
+            if (_low != other._low)
             {
-                return result;
+                return _low < other._low ? -1 : 1;
             }
 
-            bool empty = String.IsNullOrEmpty(SpecialVersion);
-            bool otherEmpty = String.IsNullOrEmpty(other.SpecialVersion);
-            if (empty && otherEmpty)
+            if (Object.ReferenceEquals(_specialVersionKey, other._specialVersionKey))
             {
                 return 0;
             }
-            else if (empty)
+
+            bool empty = _specialVersionKey.Length == 0;
+            bool otherEmpty = other._specialVersionKey.Length == 0;
+            if (empty)
             {
                 return 1;
             }
@@ -324,8 +493,9 @@ public override string ToString()
         public bool Equals(SemanticVersion other)
         {
             return !Object.ReferenceEquals(null, other) &&
-                   Version.Equals(other.Version) &&
-                   SpecialVersion.Equals(other.SpecialVersion, StringComparison.OrdinalIgnoreCase) &&
+                   _high == other._high &&
+                   _low == other._low &&
+                   Object.ReferenceEquals(_specialVersionKey, other._specialVersionKey) &&
                    IsSnapshot == other.IsSnapshot;
         }
 
@@ -337,13 +507,8 @@ public override bool Equals(object obj)
 
         public override int GetHashCode()
         {
-            int hashCode = Version.GetHashCode();
-            if (SpecialVersion != null)
-            {
-                hashCode = hashCode * 4567 + SpecialVersion.GetHashCode();
-            }
-
-            return hashCode;
+            int hashCode = (_high ^ (_low * 31)).GetHashCode();
+            return hashCode * 4567 + _specialVersionKey.GetHashCode();
         }
 
         public SemanticVersion SpecifySnapshot(string snapshotValue)
@@ -2,6 +2,7 @@
 // Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
 
 using System;
+using System.Collections.Concurrent;
 using System.Collections.Generic;
 using System.Diagnostics;
 using System.Globalization;
@@ -11,6 +12,7 @@
 using System.Runtime.Versioning;
 using System.Text;
 using System.Text.RegularExpressions;
+using System.Threading;
 using NuGet.Resources;
 using CompatibilityMapping = System.Collections.Generic.Dictionary<string, string[]>;
 
@@ -31,6 +33,13 @@ public static class VersionUtility
 
         private static readonly Version _emptyVersion = new Version(0, 0);
 
+        // Compatibility only depends on the two frameworks and the portable profile table, which is loaded once,
+        // so scores are computed once per (project framework, target framework) pair
+        private const long IncompatibleScore = Int64.MinValue;
+        private static readonly ConcurrentDictionary<FrameworkName, int> _frameworkIds = new ConcurrentDictionary<FrameworkName, int>();
+        private static readonly ConcurrentDictionary<long, long> _compatibilityScores = new ConcurrentDictionary<long, long>();
+        private static int _nextFrameworkId;
+
         private static readonly IDictionary<string, string> _knownIdentifiers = PopulateKnownFrameworks();
 
         private static readonly Dictionary<string, string> _knownProfiles = new Dictionary<string, string>(StringComparer.OrdinalIgnoreCase) {
@@ -657,43 +666,100 @@ public static FrameworkName ParseFrameworkFolderName(string path, bool strictPar
             // Not all projects have a framework, we need to consider those projects.
             var internalProjectFramework = projectFramework ?? EmptyFramework;
 
-            // Turn something that looks like this:
-            // item -> [Framework1, Framework2, Framework3] into
-            // [{item, Framework1}, {item, Framework2}, {item, Framework3}]
-            var normalizedItems = from item in items
-                                  let frameworks = (item.SupportedFrameworks != null && item.SupportedFrameworks.Any()) ? item.SupportedFrameworks : new FrameworkName[] { null }
-                                  from framework in frameworks
-                                  select new
-                                  {
-                                      Item = item,
-                                      TargetFramework = framework
-                                  };
-
-            // Group references by target framework (if there is no target framework we assume it is the default)
-            var frameworkGroups = normalizedItems.GroupBy(g => g.TargetFramework, g => g.Item).ToList();
-
-            // Try to find the best match
-            // Not all projects have a framework, we need to consider those projects.
-            compatibleItems = (from g in frameworkGroups
-                               where g.Key != null && IsCompatible(internalProjectFramework, g.Key)
-                               orderby GetProfileCompatibility(internalProjectFramework, g.Key) descending
-                               select g).FirstOrDefault();
+            // Group items by target framework in the order the frameworks first appear. Items without a target framework
+            // are considered to be compatible with any target framework.
+            var frameworkGroups = new Dictionary<FrameworkName, List<T>>();
+            var frameworks = new List<FrameworkName>();
+            List<T> defaultItems = null;
+
+            foreach (var item in items)
+            {
+                var hasFrameworks = false;
+                if (item.SupportedFrameworks != null)
+                {
+                    foreach (var framework in item.SupportedFrameworks)
+                    {
+                        hasFrameworks = true;
+                        if (framework == null)
+                        {
+                            AddItem(ref defaultItems, item);
+                            continue;
+                        }
+
+                        List<T> group;
+                        if (!frameworkGroups.TryGetValue(framework, out group))
+                        {
+                            group = new List<T>();
+                            frameworkGroups.Add(framework, group);
+                            frameworks.Add(framework);
+                        }
+                        group.Add(item);
+                    }
+                }
+
+                if (!hasFrameworks)
+                {
+                    AddItem(ref defaultItems, item);
+                }
+            }
+
+            // Try to find the best match, the first group wins a tie
+            List<T> bestGroup = null;
+            long bestScore = IncompatibleScore;
+            foreach (var framework in frameworks)
+            {
+                var score = GetCompatibilityScore(internalProjectFramework, framework);
+                if (score != IncompatibleScore && (bestGroup == null || score > bestScore))
+                {
+                    bestGroup = frameworkGroups[framework];
+                    bestScore = score;
+                }
+            }
+
+            // if there's no matching profile, fall back to the items without target framework
+            compatibleItems = bestGroup ?? defaultItems;
+
+            return compatibleItems != null;
+        }
 
-            bool hasItems = compatibleItems != null && compatibleItems.Any();
-            if (!hasItems)
+        private static void AddItem<T>(ref List<T> items, T item)
+        {
+            if (items == null)
             {
-                // if there's no matching profile, fall back to the items without target framework
-                // because those are considered to be compatible with any target framework
-                compatibleItems = frameworkGroups.Where(g => g.Key == null).SelectMany(g => g);
-                hasItems = compatibleItems != null && compatibleItems.Any();
+                items = new List<T>();
             }
+            items.Add(item);
+        }
+
+        /// <summary>
+        /// Returns the <see cref="GetProfileCompatibility"/> of a compatible target framework or
+        /// <see cref="IncompatibleScore"/>.
+        /// </summary>
+        private static long GetCompatibilityScore(FrameworkName projectFramework, FrameworkName targetFramework)
+        {
+            var key = ((long)GetFrameworkId(projectFramework) << 32) | (uint)GetFrameworkId(targetFramework);
 
-            if (!hasItems)
+            long score;
+            if (!_compatibilityScores.TryGetValue(key, out score))
             {
-                compatibleItems = null;
+                score = IsCompatible(projectFramework, targetFramework) ?
+                    GetProfileCompatibility(projectFramework, targetFramework) :
+                    IncompatibleScore;
+
+                _compatibilityScores.TryAdd(key, score);
             }
 
-            return hasItems;
+            return score;
+        }
+
+        private static int GetFrameworkId(FrameworkName framework)
+        {
+            int id;
+            if (_frameworkIds.TryGetValue(framework, out id))
+            {
+                return id;
+            }
+            return _frameworkIds.GetOrAdd(framework, _ => Interlocked.Increment(ref _nextFrameworkId));
         }
 
 
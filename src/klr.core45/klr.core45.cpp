@@ -21,6 +21,25 @@ void GetModuleDirectory(HMODULE module, LPWSTR szPath)
     szPath[dirLength + 1] = '\0';
 }
 
+// Exclude these assemblies from the TPA list since they need to
+// be handled by the loader since they depend on assembly neutral
+// interfaces. Used for both the directory scan and the list kpm pack writes.
+bool IsExcludedFromTpa(LPCWSTR szFileName)
+{
+    return wcscmp(szFileName, L"klr.host.dll") == 0 ||
+        wcscmp(szFileName, L"klr.host.ni.dll") == 0 ||
+        wcscmp(szFileName, L"Microsoft.Framework.ApplicationHost.dll") == 0 ||
+        wcscmp(szFileName, L"Microsoft.Framework.ApplicationHost.ni.dll") == 0 ||
+        wcscmp(szFileName, L"Microsoft.Framework.Runtime.dll") == 0 ||
+        wcscmp(szFileName, L"Microsoft.Framework.Runtime.ni.dll") == 0 ||
+        wcscmp(szFileName, L"Microsoft.Framework.Runtime.Roslyn.dll") == 0 ||
+        wcscmp(szFileName, L"Microsoft.Framework.Runtime.Roslyn.ni.dll") == 0 ||
+        wcscmp(szFileName, L"Microsoft.Framework.Project.dll") == 0 ||
+        wcscmp(szFileName, L"Microsoft.Framework.Project.ni.dll") == 0 ||
+        wcscmp(szFileName, L"Microsoft.Framework.DesignTimeHost.dll") == 0 ||
+        wcscmp(szFileName, L"Microsoft.Framework.DesignTimeHost.ni.dll") == 0;
+}
+
 bool ScanDirectory(WCHAR* szDirectory, WCHAR* szPattern, LPWSTR pszTrustedPlatformAssemblies, size_t cchTrustedPlatformAssemblies)
 {
     bool ret = true;
@@ -52,22 +71,8 @@ bool ScanDirectory(WCHAR* szDirectory, WCHAR* szPattern, LPWSTR pszTrustedPlatfo
         }
         else
         {
-            if (wcscmp(ffd.cFileName, L"klr.host.dll") == 0 || 
-                wcscmp(ffd.cFileName, L"klr.host.ni.dll") == 0 ||
-                wcscmp(ffd.cFileName, L"Microsoft.Framework.ApplicationHost.dll") == 0 ||
-                wcscmp(ffd.cFileName, L"Microsoft.Framework.ApplicationHost.ni.dll") == 0 ||
-                wcscmp(ffd.cFileName, L"Microsoft.Framework.Runtime.dll") == 0 ||
-                wcscmp(ffd.cFileName, L"Microsoft.Framework.Runtime.ni.dll") == 0 ||
-                wcscmp(ffd.cFileName, L"Microsoft.Framework.Runtime.Roslyn.dll") == 0 ||
-                wcscmp(ffd.cFileName, L"Microsoft.Framework.Runtime.Roslyn.ni.dll") == 0 ||
-                wcscmp(ffd.cFileName, L"Microsoft.Framework.Project.dll") == 0 ||
-                wcscmp(ffd.cFileName, L"Microsoft.Framework.Project.ni.dll") == 0 ||
-                wcscmp(ffd.cFileName, L"Microsoft.Framework.DesignTimeHost.dll") == 0 ||
-                wcscmp(ffd.cFileName, L"Microsoft.Framework.DesignTimeHost.ni.dll") == 0)
+            if (IsExcludedFromTpa(ffd.cFileName))
             {
-                // Exclude these assemblies from the TPA list since they need to
-                // be handled by the loader since they depend on assembly neutral
-                // interfaces
                 continue;
             }
 
@@ -87,6 +92,149 @@ Finished:
     return ret;
 }
 
+bool AppendStartupPath(LPWSTR pszList, size_t cchList, LPCWSTR szApplicationRoot, LPCWSTR szRelativePath, LPCWSTR szSuffix)
+{
+    errno_t errno = 0;
+
+    errno = wcscat_s(pszList, cchList, szApplicationRoot);
+    if (errno) return false;
+
+    errno = wcscat_s(pszList, cchList, szRelativePath);
+    if (errno) return false;
+
+    errno = wcscat_s(pszList, cchList, szSuffix);
+    return errno == 0;
+}
+
+// kpm pack writes the trusted platform assemblies and app paths of a packed runtime into approot\klr.startup,
+// the runtime lives in approot\packages\{runtime}\bin. Returns false if there is nothing for this runtime
+// so the directory is scanned instead.
+bool ReadStartupDescriptor(LPCWSTR szCoreClrDirectory, LPWSTR pszTrustedPlatformAssemblies, size_t cchTrustedPlatformAssemblies, LPWSTR pszAppPaths, size_t cchAppPaths)
+{
+    bool ret = false;
+    bool inSection = false;
+    errno_t errno = 0;
+    FILE* file = nullptr;
+
+    WCHAR wszApplicationRoot[MAX_PATH];
+    WCHAR wszDescriptorPath[MAX_PATH];
+    WCHAR wszRuntimeDirectory[MAX_PATH];
+    WCHAR wszLine[MAX_PATH * 2];
+
+    errno = wcscpy_s(wszApplicationRoot, _countof(wszApplicationRoot), szCoreClrDirectory);
+    CHECK_RETURN_VALUE_FAIL_EXIT_VIA_FINISHED(errno);
+
+    // Up from bin, {runtime} and packages, keeping the trailing backslash
+    for (int i = 0; i < 3; i++)
+    {
+        size_t length = wcslen(wszApplicationRoot);
+        if (length < 2)
+        {
+            goto Finished;
+        }
+
+        for (length -= 2; length > 0 && wszApplicationRoot[length] != L'\\'; length--);
+        if (wszApplicationRoot[length] != L'\\')
+        {
+            goto Finished;
+        }
+        wszApplicationRoot[length + 1] = L'\0';
+    }
+
+    errno = wcscpy_s(wszDescriptorPath, _countof(wszDescriptorPath), wszApplicationRoot);
+    CHECK_RETURN_VALUE_FAIL_EXIT_VIA_FINISHED(errno);
+
+    errno = wcscat_s(wszDescriptorPath, _countof(wszDescriptorPath), L"klr.startup");
+    CHECK_RETURN_VALUE_FAIL_EXIT_VIA_FINISHED(errno);
+
+    if (_wfopen_s(&file, wszDescriptorPath, L"rt, ccs=UTF-8") != 0 || file == nullptr)
+    {
+        goto Finished;
+    }
+
+    // Bumped by kpm pack when the format changes
+    if (fgetws(wszLine, _countof(wszLine), file) == nullptr)
+    {
+        goto Finished;
+    }
+
+    wszLine[wcscspn(wszLine, L"\r\n")] = L'\0';
+    if (wcscmp(wszLine, L"#klr.startup 2") != 0)
+    {
+        goto Finished;
+    }
+
+    while (fgetws(wszLine, _countof(wszLine), file) != nullptr)
+    {
+        wszLine[wcscspn(wszLine, L"\r\n")] = L'\0';
+
+        WCHAR* pszValue = wcschr(wszLine, L'\t');
+        if (pszValue == nullptr)
+        {
+            continue;
+        }
+        *pszValue++ = L'\0';
+
+        if (wcscmp(wszLine, L"runtime") == 0)
+        {
+            if (inSection)
+            {
+                // Past the section of this runtime
+                break;
+            }
+
+            errno = wcscpy_s(wszRuntimeDirectory, _countof(wszRuntimeDirectory), wszApplicationRoot);
+            CHECK_RETURN_VALUE_FAIL_EXIT_VIA_FINISHED(errno);
+
+            errno = wcscat_s(wszRuntimeDirectory, _countof(wszRuntimeDirectory), pszValue);
+            CHECK_RETURN_VALUE_FAIL_EXIT_VIA_FINISHED(errno);
+
+            errno = wcscat_s(wszRuntimeDirectory, _countof(wszRuntimeDirectory), L"\\");
+            CHECK_RETURN_VALUE_FAIL_EXIT_VIA_FINISHED(errno);
+
+            inSection = _wcsicmp(wszRuntimeDirectory, szCoreClrDirectory) == 0;
+        }
+        else if (inSection && wcscmp(wszLine, L"tpa") == 0)
+        {
+            LPCWSTR szFileName = wcsrchr(pszValue, L'\\');
+            if (IsExcludedFromTpa(szFileName == nullptr ? pszValue : szFileName + 1))
+            {
+                continue;
+            }
+
+            if (!AppendStartupPath(pszTrustedPlatformAssemblies, cchTrustedPlatformAssemblies, wszApplicationRoot, pszValue, L";"))
+            {
+                ret = false;
+                goto Finished;
+            }
+            ret = true;
+        }
+        else if (inSection && wcscmp(wszLine, L"apppath") == 0)
+        {
+            if (!AppendStartupPath(pszAppPaths, cchAppPaths, wszApplicationRoot, pszValue, L"\\;"))
+            {
+                ret = false;
+                goto Finished;
+            }
+        }
+    }
+
+Finished:
+    if (file != nullptr)
+    {
+        fclose(file);
+    }
+
+    if (!ret)
+    {
+        // Don't leave half a list behind for the directory scan
+        pszTrustedPlatformAssemblies[0] = L'\0';
+        pszAppPaths[0] = L'\0';
+    }
+
+    return ret;
+}
+
 HMODULE LoadCoreClr()
 {
     errno_t errno = 0;
@@ -252,15 +400,32 @@ extern "C" __declspec(dllexport) bool __stdcall CallApplicationMain(PCALL_APPLIC
         goto Finished;
     }
     pwszTrustedPlatformAssemblies[0] = L'\0';
-    
-    // Try native images first
-    if (!ScanDirectory(szCoreClrDirectory, L"*.ni.dll", pwszTrustedPlatformAssemblies, cchTrustedPlatformAssemblies))
+
+    //wstring appPaths(szCurrentDirectory);
+    WCHAR wszAppPaths[MAX_PATH];
+    wszAppPaths[0] = L'\0';
+
+    WCHAR wszStartupAppPaths[MAX_PATH];
+    wszStartupAppPaths[0] = L'\0';
+
+    // A packed runtime has the list computed already
+    if (!ReadStartupDescriptor(szCoreClrDirectory, pwszTrustedPlatformAssemblies, cchTrustedPlatformAssemblies, wszStartupAppPaths, _countof(wszStartupAppPaths)))
     {
-        if (!ScanDirectory(szCoreClrDirectory, L"*.dll", pwszTrustedPlatformAssemblies, cchTrustedPlatformAssemblies))
+        // Try native images first
+        if (!ScanDirectory(szCoreClrDirectory, L"*.ni.dll", pwszTrustedPlatformAssemblies, cchTrustedPlatformAssemblies))
         {
-            printf_s("Failed to find files in the coreclr directory\n");
-            return false;
+            if (!ScanDirectory(szCoreClrDirectory, L"*.dll", pwszTrustedPlatformAssemblies, cchTrustedPlatformAssemblies))
+            {
+                printf_s("Failed to find files in the coreclr directory\n");
+                return false;
+            }
         }
+
+        errno = wcscpy_s(wszStartupAppPaths, _countof(wszStartupAppPaths), szCoreClrDirectory);
+        CHECK_RETURN_VALUE_FAIL_EXIT_VIA_FINISHED(errno);
+
+        errno = wcscat_s(wszStartupAppPaths, _countof(wszStartupAppPaths), L";");
+        CHECK_RETURN_VALUE_FAIL_EXIT_VIA_FINISHED(errno);
     }
 
     // Add the assembly containing the app domain manager to the trusted list
@@ -271,20 +436,13 @@ extern "C" __declspec(dllexport) bool __stdcall CallApplicationMain(PCALL_APPLIC
     errno = wcscat_s(pwszTrustedPlatformAssemblies, cchTrustedPlatformAssemblies, L"klr.core45.managed.dll");
     CHECK_RETURN_VALUE_FAIL_EXIT_VIA_FINISHED(errno);
 
-    //wstring appPaths(szCurrentDirectory);
-    WCHAR wszAppPaths[MAX_PATH];
-    wszAppPaths[0] = L'\0';
-
     errno = wcscat_s(wszAppPaths, _countof(wszAppPaths), szCurrentDirectory);
     CHECK_RETURN_VALUE_FAIL_EXIT_VIA_FINISHED(errno);
 
     errno = wcscat_s(wszAppPaths, _countof(wszAppPaths), L";");
     CHECK_RETURN_VALUE_FAIL_EXIT_VIA_FINISHED(errno);
 
-    errno = wcscat_s(wszAppPaths, _countof(wszAppPaths), szCoreClrDirectory);
-    CHECK_RETURN_VALUE_FAIL_EXIT_VIA_FINISHED(errno);
-
-    errno = wcscat_s(wszAppPaths, _countof(wszAppPaths), L";");
+    errno = wcscat_s(wszAppPaths, _countof(wszAppPaths), wszStartupAppPaths);
     CHECK_RETURN_VALUE_FAIL_EXIT_VIA_FINISHED(errno);
 
     const wchar_t* property_values[] = {
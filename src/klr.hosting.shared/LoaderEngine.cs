@@ -2,6 +2,7 @@
 // Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
 
 #if NET45
+using System;
 using System.IO;
 using System.Reflection;
 
@@ -29,13 +30,41 @@ public Assembly LoadStream(Stream assemblyStream, Stream pdbStream)
 
         private byte[] GetStreamAsByteArray(Stream stream)
         {
-            // Fast path assuming the stream is a memory stream
+            // Fast path assuming the stream is a memory stream over an exactly sized buffer,
+            // Assembly.Load can use that buffer as is
             var ms = stream as MemoryStream;
             if (ms != null)
             {
+                byte[] buffer;
+                if (TryGetExactBuffer(ms, out buffer))
+                {
+                    return buffer;
+                }
+
                 return ms.ToArray();
             }
 
+            // Streams with a known length (files, manifest resources) are read
+            // straight into the final array
+            if (stream.CanSeek)
+            {
+                var length = stream.Length - stream.Position;
+                var bytes = new byte[length];
+                int offset = 0;
+                int read;
+                while (offset < bytes.Length && (read = stream.Read(bytes, offset, bytes.Length - offset)) > 0)
+                {
+                    offset += read;
+                }
+
+                if (offset == bytes.Length)
+                {
+                    return bytes;
+                }
+
+                stream.Position -= offset;
+            }
+
             // Otherwise copy the bytes
             using (ms = new MemoryStream())
             {
@@ -43,6 +72,23 @@ private byte[] GetStreamAsByteArray(Stream stream)
                 return ms.ToArray();
             }
         }
+
+        private static bool TryGetExactBuffer(MemoryStream stream, out byte[] buffer)
+        {
+            buffer = null;
+
+            try
+            {
+                buffer = stream.GetBuffer();
+            }
+            catch (UnauthorizedAccessException)
+            {
+                // The buffer isn't publicly visible
+                return false;
+            }
+
+            return buffer.Length == stream.Length;
+        }
     }
 }
 #endif
\ No newline at end of file
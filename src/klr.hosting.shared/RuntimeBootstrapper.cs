@@ -99,6 +99,9 @@ public static Task<int> ExecuteAsync(string[] args)
             // Resolve the lib paths
             string[] searchPaths = ResolveSearchPaths(optionLib.Values, app.RemainingArguments);
 
+            // A packed application lists where its assemblies are, so they don't need to be probed for
+            var startupDescriptor = StartupDescriptor.Load(Environment.GetEnvironmentVariable("KRE_DEFAULT_LIB"));
+
             Func<string, Assembly> loader = _ => null;
             Func<Stream, Assembly> loadStream = _ => null;
             Func<string, Assembly> loadFile = _ => null;
@@ -134,7 +137,7 @@ public static Task<int> ExecuteAsync(string[] args)
                             return assembly;
                         }
 
-                        assembly = loader(name) ?? ResolveHostAssembly(loadFile, searchPaths, name);
+                        assembly = loader(name) ?? ResolveHostAssembly(loadFile, startupDescriptor, searchPaths, name);
 
                         if (assembly != null)
                         {
@@ -320,28 +323,55 @@ private static void ExtractAssemblyNeutralInterfaces(Assembly assembly, Func<Str
                     }
 
 
-                    var neutralAssemblyStream = assembly.GetManifestResourceStream(name);
-
-                    _assemblyCache[assemblyName] = load(neutralAssemblyStream);
+                    // The resource stream reads from the image of the loaded assembly, so the
+                    // loader copies the embedded assembly at most once
+                    using (var neutralAssemblyStream = assembly.GetManifestResourceStream(name))
+                    {
+                        _assemblyCache[assemblyName] = load(neutralAssemblyStream);
+                    }
                 }
             }
         }
 
-        private static Assembly ResolveHostAssembly(Func<string, Assembly> loadFile, IList<string> searchPaths, string name)
+        private static Assembly ResolveHostAssembly(Func<string, Assembly> loadFile, StartupDescriptor startupDescriptor, IList<string> searchPaths, string name)
         {
             foreach (var searchPath in searchPaths)
             {
-                var path = Path.Combine(searchPath, name + ".dll");
+                // The descriptor lists the runtime folder, it is used in the place that folder has in the
+                // search order so packed and unpacked applications resolve the same assemblies
+                if (startupDescriptor != null && startupDescriptor.Describes(searchPath))
+                {
+                    string assemblyPath;
+                    if (startupDescriptor.Assemblies.TryGetValue(name, out assemblyPath))
+                    {
+                        return loadFile(assemblyPath);
+                    }
+
+                    continue;
+                }
 
-                if (File.Exists(path))
+                var assembly = LoadFromSearchPath(loadFile, searchPath, name);
+                if (assembly != null)
                 {
-                    return loadFile(path);
+                    return assembly;
                 }
             }
 
             return null;
         }
 
+        private static Assembly LoadFromSearchPath(Func<string, Assembly> loadFile, string searchPath, string name)
+        {
+            var path = Path.Combine(searchPath, name + ".dll");
+
+            if (File.Exists(path))
+            {
+                return loadFile(path);
+            }
+
+            return null;
+        }
+
         private static string GetVersion()
         {
             var assembly = typeof(RuntimeBootstrapper).GetTypeInfo().Assembly;
@@ -0,0 +1,112 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+using System;
+using System.Collections.Generic;
+using System.IO;
+
+namespace klr.hosting
+{
+    /// <summary>
+    /// The section kpm pack wrote for this runtime into the startup descriptor of the application root.
+    /// A packed runtime lives in approot\packages\{runtime}\bin, so the descriptor is three folders up.
+    /// </summary>
+    internal class StartupDescriptor
+    {
+        private const string FileName = "klr.startup";
+        private const string Header = "#klr.startup 2";
+
+        private static readonly char[] _separator = new[] { '\t' };
+
+        private StartupDescriptor(string runtimeDirectory, IDictionary<string, string> assemblies)
+        {
+            RuntimeDirectory = runtimeDirectory;
+            Assemblies = assemblies;
+        }
+
+        /// <summary>
+        /// The bin folder of the runtime the section was written for.
+        /// </summary>
+        public string RuntimeDirectory { get; private set; }
+
+        /// <summary>
+        /// Full paths of the assemblies in <see cref="RuntimeDirectory"/>, by assembly name.
+        /// </summary>
+        public IDictionary<string, string> Assemblies { get; private set; }
+
+        /// <summary>
+        /// Returns true if <paramref name="searchPath"/> is the folder the assemblies were listed from.
+        /// </summary>
+        public bool Describes(string searchPath)
+        {
+            return string.Equals(
+                Path.GetFullPath(searchPath).TrimEnd(Path.DirectorySeparatorChar, Path.AltDirectorySeparatorChar),
+                RuntimeDirectory,
+                StringComparison.OrdinalIgnoreCase);
+        }
+
+        /// <summary>
+        /// Returns null if the runtime in <paramref name="runtimeDirectory"/> wasn't packed with an application.
+        /// </summary>
+        public static StartupDescriptor Load(string runtimeDirectory)
+        {
+            if (string.IsNullOrEmpty(runtimeDirectory))
+            {
+                return null;
+            }
+
+            runtimeDirectory = Path.GetFullPath(runtimeDirectory).TrimEnd(Path.DirectorySeparatorChar, Path.AltDirectorySeparatorChar);
+
+            var applicationRoot = Path.GetDirectoryName(Path.GetDirectoryName(Path.GetDirectoryName(runtimeDirectory)));
+            if (string.IsNullOrEmpty(applicationRoot))
+            {
+                return null;
+            }
+
+            var descriptorPath = Path.Combine(applicationRoot, FileName);
+            if (!File.Exists(descriptorPath))
+            {
+                return null;
+            }
+
+            var lines = File.ReadAllLines(descriptorPath);
+            if (lines.Length == 0 || !string.Equals(lines[0], Header, StringComparison.Ordinal))
+            {
+                return null;
+            }
+
+            Dictionary<string, string> assemblies = null;
+            for (int i = 1; i < lines.Length; i++)
+            {
+                var parts = lines[i].Split(_separator);
+
+                if (parts[0] == "runtime" && parts.Length == 2)
+                {
+                    if (assemblies != null)
+                    {
+                        // Past the section of this runtime
+                        break;
+                    }
+
+                    if (string.Equals(GetFullPath(applicationRoot, parts[1]), runtimeDirectory, StringComparison.OrdinalIgnoreCase))
+                    {
+                        assemblies = new Dictionary<string, string>(StringComparer.Ordinal);
+                    }
+                }
+                else if (parts[0] == "assembly" && parts.Length == 3 && assemblies != null)
+                {
+                    assemblies[parts[1]] = GetFullPath(applicationRoot, parts[2]);
+                }
+
+                // Anything else is for the native host or the tools
+            }
+
+            return assemblies == null ? null : new StartupDescriptor(runtimeDirectory, assemblies);
+        }
+
+        private static string GetFullPath(string applicationRoot, string relativePath)
+        {
+            return Path.Combine(applicationRoot, relativePath.Replace('\\', Path.DirectorySeparatorChar));
+        }
+    }
+}
@@ -0,0 +1,165 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+using System;
+using System.IO;
+using Microsoft.Framework.DesignTimeHost.Models;
+using Microsoft.Framework.DesignTimeHost.Protocol;
+using Newtonsoft.Json.Linq;
+using Xunit;
+
+namespace Microsoft.Framework.DesignTimeHost.Tests
+{
+    public class BinaryMessageSerializerFacts
+    {
+        [Fact]
+        public void EveryTokenTypeRoundTrips()
+        {
+            // Arrange
+            var payload = new JObject
+            {
+                { "String", "Some string" },
+                { "Null", null },
+                { "Integer", 42 },
+                { "Negative", -7 },
+                { "Large", long.MaxValue },
+                { "Float", 1.5 },
+                { "True", true },
+                { "False", false },
+                { "Bytes", new byte[] { 1, 2, 3 } },
+                { "Date", new DateTime(2014, 10, 1, 0, 0, 0, DateTimeKind.Utc) },
+                { "Nested", new JObject { { "Array", new JArray(1, "two", new JObject { { "Three", 3 } }) } } },
+                { "Empty", new JArray() }
+            };
+
+            // Act
+            var received = RoundTrip(new BinaryMessageSerializer(), new BinaryMessageSerializer(), CreateMessage(1, payload));
+
+            // Assert
+            Assert.Equal("Host", received.HostId);
+            Assert.Equal("Test", received.MessageType);
+            Assert.Equal(1, received.ContextId);
+            Assert.True(JToken.DeepEquals(payload, received.Payload), received.Payload.ToString());
+        }
+
+        [Fact]
+        public void ArrayChangesRoundTrip()
+        {
+            // Arrange
+            var writer = new BinaryMessageSerializer();
+            var reader = new BinaryMessageSerializer();
+            var lists = new[]
+            {
+                new JArray("a.cs", "b.cs", "c.cs"),
+                new JArray("a.cs", "b.cs", "x.cs", "c.cs"),
+                new JArray("c.cs", "a.cs", "b.cs"),
+                new JArray("a.cs", "a.cs", "b.cs", "b.cs"),
+                new JArray("b.cs"),
+                new JArray(),
+                new JArray("a.cs", 1, null, "c.cs")
+            };
+
+            foreach (var list in lists)
+            {
+                // Act
+                var received = RoundTrip(writer, reader, CreateMessage(1, new JObject { { "Files", list } }));
+
+                // Assert
+                Assert.True(JToken.DeepEquals(list, received.Payload["Files"]), received.Payload.ToString());
+            }
+        }
+
+        [Fact]
+        public void ObjectChangesRoundTrip()
+        {
+            // Arrange
+            var writer = new BinaryMessageSerializer();
+            var reader = new BinaryMessageSerializer();
+            var values = new[]
+            {
+                new JObject { { "A", 1 }, { "B", new JArray("x") } },
+                new JObject { { "A", 1 }, { "B", new JArray("x", "y") }, { "C", "new" } },
+                new JObject { { "C", "changed" } },
+                new JObject()
+            };
+
+            foreach (var value in values)
+            {
+                // Act
+                var received = RoundTrip(writer, reader, CreateMessage(1, new JObject { { "Dependencies", value } }));
+
+                // Assert
+                Assert.True(JToken.DeepEquals(value, received.Payload["Dependencies"]), received.Payload.ToString());
+            }
+        }
+
+        [Fact]
+        public void RepeatedMessagesAreSmaller()
+        {
+            // Arrange
+            var writer = new BinaryMessageSerializer();
+            var reader = new BinaryMessageSerializer();
+            var payload = new JObject { { "Files", new JArray(@"c:\project\a.cs", @"c:\project\b.cs", @"c:\project\c.cs") } };
+            var first = new MemoryStream();
+            var second = new MemoryStream();
+
+            // Act
+            writer.WriteMessage(new BinaryWriter(first), CreateMessage(1, payload));
+            writer.WriteMessage(new BinaryWriter(second), CreateMessage(1, payload));
+            first.Position = 0;
+            second.Position = 0;
+            reader.ReadMessage(new BinaryReader(first));
+            var received = reader.ReadMessage(new BinaryReader(second));
+
+            // Assert
+            Assert.True(second.Length < first.Length / 2);
+            Assert.True(JToken.DeepEquals(payload, received.Payload));
+        }
+
+        [Fact]
+        public void StateIsResetPastTheLimits()
+        {
+            // Arrange
+            var writer = new BinaryMessageSerializer(maxInternedStrings: 4, maxSnapshots: 2);
+            var reader = new BinaryMessageSerializer(maxInternedStrings: 4, maxSnapshots: 2);
+
+            for (int i = 0; i < 10; i++)
+            {
+                // Act, each context adds a delta base and new strings
+                var payload = new JObject { { "Files", new JArray("file" + i + ".cs", "shared.cs") } };
+                var received = RoundTrip(writer, reader, CreateMessage(i, payload));
+
+                // Assert
+                Assert.True(JToken.DeepEquals(payload, received.Payload), received.Payload.ToString());
+            }
+
+            // A context seen before the last reset is sent in full again
+            var again = new JObject { { "Files", new JArray("file0.cs", "other.cs") } };
+            Assert.True(JToken.DeepEquals(again, RoundTrip(writer, reader, CreateMessage(0, again)).Payload));
+        }
+
+        private static Message CreateMessage(int contextId, JToken payload)
+        {
+            return new Message
+            {
+                HostId = "Host",
+                MessageType = "Test",
+                ContextId = contextId,
+                Payload = payload
+            };
+        }
+
+        private static Message RoundTrip(IMessageSerializer writer, IMessageSerializer reader, Message message)
+        {
+            using (var stream = new MemoryStream())
+            {
+                writer.WriteMessage(new BinaryWriter(stream), message);
+                stream.Position = 0;
+
+                var received = reader.ReadMessage(new BinaryReader(stream));
+                Assert.Equal(stream.Length, stream.Position);
+                return received;
+            }
+        }
+    }
+}
@@ -0,0 +1,62 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+using System.Collections.Generic;
+using System.Linq;
+using Microsoft.Framework.DesignTimeHost.Models.OutgoingMessages;
+using Xunit;
+
+namespace Microsoft.Framework.DesignTimeHost.Tests
+{
+    public class ListDeltaFacts
+    {
+        [Fact]
+        public void SingleChangeOnlySendsTheChangedEntries()
+        {
+            // Arrange
+            var baseline = new[] { "a.cs", "b.cs", "c.cs", "d.cs" };
+            var current = new[] { "a.cs", "b.cs", "x.cs", "c.cs", "d.cs" };
+
+            // Act
+            var delta = ListDelta.Create(baseline, current);
+
+            // Assert
+            Assert.Equal(2, delta.Index);
+            Assert.Equal(0, delta.RemovedCount);
+            Assert.Equal(new[] { "x.cs" }, delta.Inserted);
+        }
+
+        [Fact]
+        public void OrderAndDuplicatesArePreserved()
+        {
+            var lists = new[]
+            {
+                new[] { "a.cs", "b.cs", "c.cs" },
+                new[] { "c.cs", "b.cs", "a.cs" },
+                new[] { "c.cs", "a.cs", "a.cs", "b.cs" },
+                new[] { "a.cs", "a.cs", "b.cs" },
+                new[] { "a.cs", "b.cs" },
+                new string[0],
+                new[] { "b.cs", "b.cs" },
+                new[] { "b.cs" }
+            };
+
+            for (int i = 1; i < lists.Length; i++)
+            {
+                // Act
+                var delta = ListDelta.Create(lists[i - 1], lists[i]);
+
+                // Assert
+                Assert.Equal(lists[i], Apply(lists[i - 1], delta));
+            }
+        }
+
+        private static IList<string> Apply(IList<string> baseline, ListDelta delta)
+        {
+            return baseline.Take(delta.Index)
+                           .Concat(delta.Inserted)
+                           .Concat(baseline.Skip(delta.Index + delta.RemovedCount))
+                           .ToList();
+        }
+    }
+}
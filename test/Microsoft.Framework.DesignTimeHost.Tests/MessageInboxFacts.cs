@@ -0,0 +1,97 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+using System.Collections.Generic;
+using Microsoft.Framework.DesignTimeHost.Models;
+using Newtonsoft.Json.Linq;
+using Xunit;
+
+namespace Microsoft.Framework.DesignTimeHost.Tests
+{
+    public class MessageInboxFacts
+    {
+        [Fact]
+        public void RepeatedRequestsAreDropped()
+        {
+            // Arrange
+            var inbox = new MessageInbox();
+
+            // Act
+            inbox.Add(Create("FilesChanged"));
+            inbox.Add(Create("GetDiagnostics"));
+            inbox.Add(Create("FilesChanged"));
+            inbox.Add(Create("GetDiagnostics"));
+
+            // Assert
+            Assert.Equal(new[] { "FilesChanged", "GetDiagnostics" }, TakeAll(inbox));
+        }
+
+        [Fact]
+        public void OnlyTheLastChangeIsKept()
+        {
+            // Arrange
+            var inbox = new MessageInbox();
+
+            // Act
+            inbox.Add(Create("ChangeConfiguration", "Release"));
+            inbox.Add(Create("FilesChanged"));
+            inbox.Add(Create("ChangeConfiguration", "Debug"));
+
+            // Assert
+            Assert.Equal(new[] { "FilesChanged", "ChangeConfiguration Debug" }, TakeAll(inbox));
+        }
+
+        [Fact]
+        public void InitializeAndTeardownKeepTheirPlace()
+        {
+            // Arrange
+            var inbox = new MessageInbox();
+
+            // Act
+            inbox.Add(Create("ChangeTargetFramework", "net45"));
+            inbox.Add(Create("Initialize", "app"));
+            inbox.Add(Create("ChangeConfiguration", "Release"));
+            inbox.Add(Create("Teardown"));
+
+            // Assert
+            Assert.Equal(new[] { "ChangeTargetFramework net45", "Initialize app", "ChangeConfiguration Release", "Teardown" }, TakeAll(inbox));
+        }
+
+        [Fact]
+        public void MessagesAreNotMergedAcrossInitialize()
+        {
+            // Arrange
+            var inbox = new MessageInbox();
+
+            // Act
+            inbox.Add(Create("ChangeConfiguration", "Release"));
+            inbox.Add(Create("FilesChanged"));
+            inbox.Add(Create("Initialize", "app"));
+            inbox.Add(Create("ChangeConfiguration", "Debug"));
+            inbox.Add(Create("FilesChanged"));
+
+            // Assert
+            Assert.Equal(new[] { "ChangeConfiguration Release", "FilesChanged", "Initialize app", "ChangeConfiguration Debug", "FilesChanged" }, TakeAll(inbox));
+        }
+
+        private static Message Create(string messageType, string value = null)
+        {
+            return new Message
+            {
+                MessageType = messageType,
+                Payload = value == null ? null : new JValue(value)
+            };
+        }
+
+        private static IList<string> TakeAll(MessageInbox inbox)
+        {
+            var messages = new List<string>();
+            Message message;
+            while (inbox.TryTake(out message))
+            {
+                messages.Add(message.Payload == null ? message.MessageType : message.MessageType + " " + message.Payload);
+            }
+            return messages;
+        }
+    }
+}
@@ -0,0 +1,126 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+using System;
+using System.Linq;
+using System.Threading;
+using Xunit;
+
+namespace Microsoft.Framework.DesignTimeHost.Tests
+{
+    public class ProcessingSchedulerFacts
+    {
+        private static readonly TimeSpan Timeout = TimeSpan.FromSeconds(10);
+
+        [Fact]
+        public void BurstOfSignalsRunsOnce()
+        {
+            // Arrange
+            var scheduler = new ProcessingScheduler(TimeSpan.FromMilliseconds(200), TimeSpan.FromSeconds(5), maxConcurrency: 1);
+            var runs = 0;
+            var ran = new ManualResetEventSlim();
+            var work = scheduler.CreateWork(() =>
+            {
+                Interlocked.Increment(ref runs);
+                ran.Set();
+            });
+
+            // Act
+            for (int i = 0; i < 10; i++)
+            {
+                work.Signal(immediate: false);
+            }
+
+            // Assert
+            Assert.True(ran.Wait(Timeout));
+            Thread.Sleep(500);
+            Assert.Equal(1, runs);
+        }
+
+        [Fact]
+        public void ImmediateSignalSkipsTheQuietPeriod()
+        {
+            // Arrange
+            var scheduler = new ProcessingScheduler(TimeSpan.FromMinutes(1), TimeSpan.FromMinutes(1), maxConcurrency: 1);
+            var ran = new ManualResetEventSlim();
+            var work = scheduler.CreateWork(ran.Set);
+
+            // Act
+            work.Signal(immediate: false);
+            work.Signal(immediate: true);
+
+            // Assert
+            Assert.True(ran.Wait(Timeout));
+        }
+
+        [Fact]
+        public void SignalDuringARunRunsAgainAfterIt()
+        {
+            // Arrange
+            var scheduler = new ProcessingScheduler(TimeSpan.Zero, TimeSpan.Zero, maxConcurrency: 4);
+            var runs = 0;
+            var running = 0;
+            var overlapped = false;
+            var ranTwice = new ManualResetEventSlim();
+            ScheduledWork work = null;
+            work = scheduler.CreateWork(() =>
+            {
+                overlapped |= Interlocked.Increment(ref running) > 1;
+                if (Interlocked.Increment(ref runs) == 1)
+                {
+                    work.Signal(immediate: true);
+                    Thread.Sleep(100);
+                }
+                else
+                {
+                    ranTwice.Set();
+                }
+                Interlocked.Decrement(ref running);
+            });
+
+            // Act
+            work.Signal(immediate: true);
+
+            // Assert
+            Assert.True(ranTwice.Wait(Timeout));
+            Assert.False(overlapped);
+        }
+
+        [Fact]
+        public void WorkersAreBounded()
+        {
+            // Arrange
+            var scheduler = new ProcessingScheduler(TimeSpan.Zero, TimeSpan.Zero, maxConcurrency: 2);
+            var running = 0;
+            var maxRunning = 0;
+            var done = new CountdownEvent(6);
+            var works = Enumerable.Range(0, 6).Select(_ => scheduler.CreateWork(() =>
+            {
+                var current = Interlocked.Increment(ref running);
+                InterlockedMax(ref maxRunning, current);
+                Thread.Sleep(50);
+                Interlocked.Decrement(ref running);
+                done.Signal();
+            })).ToList();
+
+            // Act
+            foreach (var work in works)
+            {
+                work.Signal(immediate: true);
+            }
+
+            // Assert
+            Assert.True(done.Wait(Timeout));
+            Assert.InRange(maxRunning, 1, 2);
+        }
+
+        private static void InterlockedMax(ref int location, int value)
+        {
+            int current;
+            while ((current = location) < value &&
+                   Interlocked.CompareExchange(ref location, value, current) != current)
+            {
+            }
+        }
+    }
+}
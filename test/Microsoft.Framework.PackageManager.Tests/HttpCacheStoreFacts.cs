@@ -0,0 +1,88 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Threading.Tasks;
+using Microsoft.Framework.PackageManager.Restore.NuGet;
+using Xunit;
+
+namespace Microsoft.Framework.PackageManager.Tests
+{
+    public class HttpCacheStoreFacts
+    {
+        private const string Uri = "https://www.nuget.org/api/v2/FindPackagesById()?Id='Foo'";
+
+        [Fact]
+        public async Task CompactionKeepsTheLatestEntryOfEachUri()
+        {
+            // Arrange
+            using (var tempDirectory = new TempDirectory())
+            {
+                var indexPath = Path.Combine(tempDirectory.Path, "index.log");
+                var store = HttpCacheStore.GetStore(tempDirectory.Path);
+                var oldHash = await store.AddBlobAsync(new MemoryStream(new byte[] { 1 }));
+                var newHash = await store.AddBlobAsync(new MemoryStream(new byte[] { 2 }));
+                await store.AddEntryAsync(Uri, oldHash, "\"1\"");
+                await store.AddEntryAsync(Uri, newHash, "\"2\"");
+                var logLength = new FileInfo(indexPath).Length;
+
+                // Act
+                var entry = await store.FindAsync(Uri, TimeSpan.FromDays(1));
+
+                // Assert
+                Assert.Equal(newHash, entry.Hash);
+                Assert.Equal("\"2\"", entry.ETag);
+                Assert.Equal(new byte[] { 2 }, File.ReadAllBytes(entry.BlobPath));
+                Assert.True(new FileInfo(indexPath).Length < logLength);
+                Assert.Empty(GetTemporaryLogs(tempDirectory.Path));
+            }
+        }
+
+        [Fact]
+        public async Task IdenticalBodiesAreStoredOnce()
+        {
+            // Arrange
+            using (var tempDirectory = new TempDirectory())
+            {
+                var store = HttpCacheStore.GetStore(tempDirectory.Path);
+
+                // Act
+                var firstHash = await store.AddBlobAsync(new MemoryStream(new byte[] { 1, 2, 3 }));
+                var secondHash = await store.AddBlobAsync(new MemoryStream(new byte[] { 1, 2, 3 }));
+
+                // Assert
+                Assert.Equal(firstHash, secondHash);
+                Assert.Equal(1, Directory.GetFiles(Path.Combine(tempDirectory.Path, "blobs"), "*", SearchOption.AllDirectories).Length);
+            }
+        }
+
+        [Fact]
+        public async Task FailedCompactionLeavesNoTemporaryLog()
+        {
+            // Arrange
+            using (var tempDirectory = new TempDirectory())
+            {
+                // The new log can't be moved over a directory
+                Directory.CreateDirectory(Path.Combine(tempDirectory.Path, "index.log"));
+                var store = HttpCacheStore.GetStore(tempDirectory.Path);
+
+                // Act
+                var entry = await store.FindAsync(Uri, TimeSpan.FromDays(1));
+
+                // Assert
+                Assert.Null(entry);
+                Assert.Empty(GetTemporaryLogs(tempDirectory.Path));
+            }
+        }
+
+        private static IEnumerable<string> GetTemporaryLogs(string root)
+        {
+            // index.log.<generation>
+            return Directory.GetFiles(root, "index.log.*")
+                            .Where(path => Path.GetExtension(path).Length == 1 + 32);
+        }
+    }
+}
@@ -0,0 +1,209 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Runtime.Versioning;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+using Microsoft.Framework.PackageManager.Restore.NuGet;
+using Microsoft.Framework.Runtime;
+using NuGet;
+using Xunit;
+
+namespace Microsoft.Framework.PackageManager.Tests
+{
+    public class RemoteWalkProviderFacts
+    {
+        private static readonly FrameworkName Net45 = VersionUtility.ParseFrameworkName("net45");
+        private static readonly FrameworkName Net451 = VersionUtility.ParseFrameworkName("net451");
+
+        [Fact]
+        public async Task ConcurrentLookupsOfAnIdGoToTheSourceOnce()
+        {
+            // Arrange
+            var feed = new FakePackageFeed();
+            var provider = new RemoteWalkProvider(feed);
+
+            // Act
+            var first = provider.FindLibraryByVersion(CreateLibrary("Foo"), Net45);
+            var second = provider.FindLibraryByVersion(CreateLibrary("foo"), Net451);
+            feed.Release();
+            var matches = await Task.WhenAll(first, second);
+
+            // Assert
+            Assert.Equal(new[] { "Foo" }, feed.RequestedIds);
+            Assert.Equal("1.0.0", matches[0].Library.Version.ToString());
+            Assert.Equal("1.0.0", matches[1].Library.Version.ToString());
+        }
+
+        [Fact]
+        public async Task FailedLookupIsAskedForAgain()
+        {
+            // Arrange
+            var feed = new FakePackageFeed { Fail = true };
+            var provider = new RemoteWalkProvider(feed);
+            feed.Release();
+            var failed = false;
+            try
+            {
+                await provider.FindLibraryByVersion(CreateLibrary("Foo"), Net45);
+            }
+            catch (InvalidOperationException)
+            {
+                failed = true;
+            }
+            feed.Fail = false;
+
+            // Act
+            var match = await provider.FindLibraryByVersion(CreateLibrary("Foo"), Net45);
+
+            // Assert
+            Assert.True(failed);
+            Assert.Equal(new[] { "Foo", "Foo" }, feed.RequestedIds);
+            Assert.NotNull(match);
+        }
+
+        [Fact]
+        public async Task NuspecIsReadOnceForEveryFramework()
+        {
+            // Arrange
+            var feed = new FakePackageFeed();
+            var provider = new RemoteWalkProvider(feed);
+            feed.Release();
+            var match = await provider.FindLibraryByVersion(CreateLibrary("Foo"), Net45);
+
+            // Act
+            var net45Dependencies = await provider.GetDependencies(match, Net45);
+            var net451Dependencies = await provider.GetDependencies(match, Net451);
+
+            // Assert
+            Assert.Equal(1, feed.NuspecReads);
+            Assert.Equal("Bar", net45Dependencies.Single().Name);
+            Assert.Equal("Bar", net451Dependencies.Single().Name);
+        }
+
+        [Fact]
+        public async Task RequestsToTheSourceAreThrottled()
+        {
+            // Arrange
+            var feed = new FakePackageFeed();
+            var provider = new RemoteWalkProvider(feed, maxConcurrentRequests: 2);
+
+            // Act
+            var lookups = Enumerable.Range(0, 5)
+                                    .Select(i => provider.FindLibraryByVersion(CreateLibrary("Foo" + i), Net45))
+                                    .ToList();
+            var startedBeforeRelease = feed.RequestedIds.Count;
+            feed.Release();
+            await Task.WhenAll(lookups);
+
+            // Assert
+            Assert.Equal(2, startedBeforeRelease);
+            Assert.Equal(2, feed.MaxRunning);
+            Assert.Equal(5, feed.RequestedIds.Count);
+        }
+
+        private static Library CreateLibrary(string name)
+        {
+            return new Library { Name = name, Version = SemanticVersion.Parse("1.0.0") };
+        }
+
+        private class FakePackageFeed : IPackageFeed
+        {
+            private const string Nuspec = @"<?xml version=""1.0""?>
+<package xmlns=""http://schemas.microsoft.com/packaging/2011/08/nuspec.xsd"">
+  <metadata>
+    <id>Foo</id>
+    <version>1.0.0</version>
+    <authors>Microsoft</authors>
+    <description>Foo</description>
+    <dependencies>
+      <group targetFramework=""net45"">
+        <dependency id=""Bar"" version=""2.0.0"" />
+      </group>
+    </dependencies>
+  </metadata>
+</package>";
+
+            private readonly TaskCompletionSource<object> _released = new TaskCompletionSource<object>();
+            private readonly List<string> _requestedIds = new List<string>();
+            private int _running;
+            private int _maxRunning;
+            private int _nuspecReads;
+
+            public bool Fail { get; set; }
+
+            public IList<string> RequestedIds
+            {
+                get
+                {
+                    lock (_requestedIds)
+                    {
+                        return _requestedIds.ToList();
+                    }
+                }
+            }
+
+            public int MaxRunning
+            {
+                get { return _maxRunning; }
+            }
+
+            public int NuspecReads
+            {
+                get { return _nuspecReads; }
+            }
+
+            public void Release()
+            {
+                _released.TrySetResult(null);
+            }
+
+            public async Task<IEnumerable<PackageInfo>> FindPackagesByIdAsync(string id)
+            {
+                lock (_requestedIds)
+                {
+                    _requestedIds.Add(id);
+                    _maxRunning = Math.Max(_maxRunning, ++_running);
+                }
+
+                try
+                {
+                    await _released.Task;
+
+                    if (Fail)
+                    {
+                        throw new InvalidOperationException("The source is unavailable");
+                    }
+
+                    return new[]
+                    {
+                        new PackageInfo { Id = id, Version = SemanticVersion.Parse("1.0.0"), ContentUri = "http://example.org/" + id }
+                    };
+                }
+                finally
+                {
+                    lock (_requestedIds)
+                    {
+                        _running--;
+                    }
+                }
+            }
+
+            public Task<Stream> OpenNupkgStreamAsync(PackageInfo package)
+            {
+                throw new NotSupportedException();
+            }
+
+            public Task<Stream> OpenNuspecStreamAsync(PackageInfo package)
+            {
+                Interlocked.Increment(ref _nuspecReads);
+                return Task.FromResult<Stream>(new MemoryStream(Encoding.UTF8.GetBytes(Nuspec)));
+            }
+        }
+    }
+}
@@ -1,7 +1,9 @@
 // Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
 // Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
 
+using System;
 using System.Collections.Generic;
+using System.IO;
 using System.Linq;
 using System.Reflection;
 using Microsoft.CodeAnalysis;
@@ -12,6 +14,26 @@ namespace Microsoft.Framework.Runtime.Roslyn.Tests
 {
     public class AssemblyNeutralFacts
     {
+        private static readonly CSharpCompilationOptions _options = new CSharpCompilationOptions(OutputKind.DynamicallyLinkedLibrary);
+
+        private static readonly MetadataReference _mscorlib = new MetadataFileReference(typeof(object).GetTypeInfo().Assembly.Location);
+
+        private static readonly string[] _neutralTypes = new[]
+        {
+@"
+namespace Something
+{
+    [AssemblyNeutral]
+    public interface IFoo { }
+}",
+@"
+namespace Something
+{
+    [AssemblyNeutral]
+    public class AssemblyNeutralAttribute : System.Attribute { }
+}"
+        };
+
         [Fact]
         public void TypeCompilationsAreGeneratedForEachAssemblyNeutralType()
         {
@@ -187,20 +209,175 @@ public class AssemblyNeutralAttribute : System.Attribute { }
             Assert.Equal("Something.IDataValue", compilations[3].AssemblyName);
         }
 
+        [Fact]
+        public void CachedImagesAreReusedForTheSameInputs()
+        {
+            // Arrange
+            using (var tempDirectory = new TempDirectory())
+            {
+                var directory = tempDirectory.Path;
+                var cache = new AssemblyNeutralCache(directory);
+
+                var first = DoAssemblyNeutralCompilation(cache, _options, _neutralTypes);
+                first.GenerateTypeCompilations();
+
+                // Act
+                var second = DoAssemblyNeutralCompilation(cache, _options, _neutralTypes);
+                var diagnostics = second.GenerateTypeCompilations();
+
+                // Assert
+                Assert.Equal(0, diagnostics.Count);
+                Assert.Equal(2, Directory.GetFiles(directory).Length);
+
+                // Emitting again would give the assemblies new module version ids
+                var firstImages = first.TypeCompilations.OrderBy(c => c.AssemblyName).Select(c => c.Image).ToList();
+                var secondImages = second.TypeCompilations.OrderBy(c => c.AssemblyName).Select(c => c.Image).ToList();
+                Assert.Equal(2, secondImages.Count);
+                Assert.Equal(firstImages[0], secondImages[0]);
+                Assert.Equal(firstImages[1], secondImages[1]);
+            }
+        }
+
+        [Fact]
+        public void CompilationOptionsArePartOfTheCacheKey()
+        {
+            // Arrange
+            using (var tempDirectory = new TempDirectory())
+            {
+                var directory = tempDirectory.Path;
+                var cache = new AssemblyNeutralCache(directory);
+                var unsafeOptions = _options.WithAllowUnsafe(true);
+
+                // Act
+                var first = DoAssemblyNeutralCompilation(cache, _options, _neutralTypes);
+                var second = DoAssemblyNeutralCompilation(cache, unsafeOptions, _neutralTypes);
+                first.GenerateTypeCompilations();
+                second.GenerateTypeCompilations();
+
+                // Assert
+                Assert.NotEqual(first.ReferencesKey, second.ReferencesKey);
+                Assert.Empty(first.TypeCompilations.Select(c => c.CacheKey)
+                                                   .Intersect(second.TypeCompilations.Select(c => c.CacheKey)));
+            }
+        }
+
+        [Fact]
+        public void RebuiltReferencesArePartOfTheCacheKey()
+        {
+            // Arrange, the same identity emitted twice gets two module version ids
+            var reference = CSharpCompilation.Create("Dependency",
+                options: _options,
+                references: new[] { _mscorlib },
+                syntaxTrees: new[] { CSharpSyntaxTree.ParseText("public class Dependency { }") });
+            var first = new MetadataImageReference(Emit(reference));
+            var second = new MetadataImageReference(Emit(reference));
+
+            var firstWorker = DoAssemblyNeutralCompilation(null, _options, first, _neutralTypes);
+            var secondWorker = DoAssemblyNeutralCompilation(null, _options, second, _neutralTypes);
+
+            // Act
+            firstWorker.GenerateTypeCompilations();
+            secondWorker.GenerateTypeCompilations();
+
+            // Assert
+            Assert.NotEqual(firstWorker.ReferencesKey, secondWorker.ReferencesKey);
+        }
+
+        [Fact]
+        public void CorruptEntriesAreGeneratedAgain()
+        {
+            // Arrange
+            using (var tempDirectory = new TempDirectory())
+            {
+                var directory = tempDirectory.Path;
+                var cache = new AssemblyNeutralCache(directory);
+
+                DoAssemblyNeutralCompilation(cache, _options, _neutralTypes).GenerateTypeCompilations();
+                foreach (var path in Directory.GetFiles(directory))
+                {
+                    File.WriteAllBytes(path, new byte[] { 1, 2, 3 });
+                }
+
+                // Act
+                var worker = DoAssemblyNeutralCompilation(cache, _options, _neutralTypes);
+                var diagnostics = worker.GenerateTypeCompilations();
+
+                // Assert
+                Assert.Equal(0, diagnostics.Count);
+                foreach (var compilation in worker.TypeCompilations)
+                {
+                    Assert.True(compilation.Image.Length > 3);
+                }
+                foreach (var path in Directory.GetFiles(directory))
+                {
+                    Assert.True(new FileInfo(path).Length > 3);
+                }
+            }
+        }
+
+        [Fact]
+        public void StaleEntriesAreRemoved()
+        {
+            // Arrange
+            using (var tempDirectory = new TempDirectory())
+            {
+                var directory = tempDirectory.Path;
+                var stalePath = Path.Combine(directory, "stale.dll");
+                File.WriteAllBytes(stalePath, new byte[] { 1 });
+                File.SetLastWriteTimeUtc(stalePath, DateTime.UtcNow.AddDays(-30));
+
+                // Act
+                var image = new AssemblyNeutralCache(directory).Get("other");
+
+                // Assert
+                Assert.Null(image);
+                Assert.False(File.Exists(stalePath));
+            }
+        }
+
         private AssemblyNeutralWorker DoAssemblyNeutralCompilation(params string[] fileContents)
         {
+            return DoAssemblyNeutralCompilation(null, _options, fileContents);
+        }
+
+        private AssemblyNeutralWorker DoAssemblyNeutralCompilation(AssemblyNeutralCache cache,
+                                                                   CSharpCompilationOptions options,
+                                                                   params string[] fileContents)
+        {
+            return DoAssemblyNeutralCompilation(cache, options, null, fileContents);
+        }
+
+        private AssemblyNeutralWorker DoAssemblyNeutralCompilation(AssemblyNeutralCache cache,
+                                                                   CSharpCompilationOptions options,
+                                                                   MetadataReference extraReference,
+                                                                   params string[] fileContents)
+        {
+            var references = new List<MetadataReference> { _mscorlib };
+            if (extraReference != null)
+            {
+                references.Add(extraReference);
+            }
+
             var compilation = CSharpCompilation.Create("test",
-                options: new CSharpCompilationOptions(OutputKind.DynamicallyLinkedLibrary),
-                references: new[] { 
-                    new MetadataFileReference(typeof(object).GetTypeInfo().Assembly.Location) 
-                },
+                options: options,
+                references: references,
                 syntaxTrees: fileContents.Select(text => CSharpSyntaxTree.ParseText(text)));
 
             var worker = new AssemblyNeutralWorker(compilation,
-                new Dictionary<string, MetadataReference>());
+                new Dictionary<string, MetadataReference>(),
+                cache);
             worker.FindTypeCompilations(compilation.GlobalNamespace);
             worker.OrderTypeCompilations();
             return worker;
         }
+
+        private static byte[] Emit(CSharpCompilation compilation)
+        {
+            using (var stream = new MemoryStream())
+            {
+                compilation.Emit(stream);
+                return stream.ToArray();
+            }
+        }
     }
 }
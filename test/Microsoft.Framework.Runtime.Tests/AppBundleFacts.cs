@@ -0,0 +1,146 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+using System.IO;
+using System.Linq;
+using Microsoft.Framework.Runtime.Loader;
+using Xunit;
+
+namespace Microsoft.Framework.Runtime.Tests
+{
+    public class AppBundleFacts
+    {
+        [Fact]
+        public void BundleServesThePackageAssembliesOfTheApplicationRoot()
+        {
+            // Arrange
+            using (var tempDirectory = new TempDirectory())
+            {
+                var directory = tempDirectory.Path;
+                var libPath = Path.Combine(directory, "packages", "Foo", "1.0.0", "lib", "aspnet50");
+                var assemblyPath = Path.Combine(libPath, "Foo.dll");
+                var symbolsPath = Path.Combine(libPath, "Foo.pdb");
+                var nativeAssemblyPath = Path.Combine(libPath, "Bar.dll");
+                var nupkgPath = Path.Combine(directory, "packages", "Foo", "1.0.0", "Foo.1.0.0.nupkg");
+                var sourcePath = Path.Combine(directory, "src", "app", "Program.cs");
+                Directory.CreateDirectory(Path.GetDirectoryName(AppBundle.GetNativeImagePath(nativeAssemblyPath)));
+                Directory.CreateDirectory(Path.GetDirectoryName(sourcePath));
+                File.WriteAllBytes(assemblyPath, Enumerable.Range(0, 5000).Select(i => (byte)i).ToArray());
+                File.WriteAllBytes(symbolsPath, new byte[0]);
+                File.WriteAllBytes(nativeAssemblyPath, new byte[] { 1 });
+                File.WriteAllBytes(AppBundle.GetNativeImagePath(nativeAssemblyPath), new byte[] { 2 });
+                File.WriteAllBytes(nupkgPath, new byte[] { 3 });
+                File.WriteAllText(sourcePath, "class Program { }");
+                File.WriteAllText(Path.Combine(directory, "global.json"), "{ \"packages\": \"packages\" }");
+
+                // Act
+                AppBundle.Write(directory);
+
+                using (var bundle = AppBundle.Open(directory))
+                {
+                    // Assert
+                    Assert.Equal(2, bundle.Entries.Count());
+                    Assert.Equal(File.ReadAllBytes(assemblyPath), ReadAll(bundle, assemblyPath));
+                    Assert.Equal(0, ReadAll(bundle, symbolsPath).Length);
+
+                    // Loaded from disk instead
+                    Assert.False(bundle.Contains(nativeAssemblyPath));
+                    Assert.False(bundle.Contains(nupkgPath));
+                    Assert.False(bundle.Contains(sourcePath));
+
+                    var assemblyEntry = bundle.Entries.Single(entry => entry.Name == "packages/Foo/1.0.0/lib/aspnet50/Foo.dll");
+                    Assert.Equal(AppBundle.AssemblyFlag, assemblyEntry.Flags);
+                    Assert.Equal(0, assemblyEntry.Offset % 4096);
+                }
+            }
+        }
+
+        [Fact]
+        public void BundleOfOtherPackagesIsIgnored()
+        {
+            // Arrange
+            using (var tempDirectory = new TempDirectory())
+            {
+                var directory = tempDirectory.Path;
+                var globalJsonPath = Path.Combine(directory, "global.json");
+                File.WriteAllText(globalJsonPath, "{ \"dependencies\": { \"Foo\": { \"version\": \"1.0.0\" } } }");
+
+                AppBundle.Write(directory);
+
+                // Act
+                File.WriteAllText(globalJsonPath, "{ \"dependencies\": { \"Foo\": { \"version\": \"1.0.1\" } } }");
+                var bundle = AppBundle.Open(directory);
+
+                // Assert
+                Assert.Null(bundle);
+            }
+        }
+
+        [Fact]
+        public void TruncatedBundleIsIgnored()
+        {
+            // Arrange
+            using (var tempDirectory = new TempDirectory())
+            {
+                var directory = tempDirectory.Path;
+                var libPath = Path.Combine(directory, "packages", "Foo", "1.0.0", "lib", "aspnet50");
+                var bundlePath = Path.Combine(directory, AppBundle.FileName);
+                Directory.CreateDirectory(libPath);
+                File.WriteAllBytes(Path.Combine(libPath, "Foo.dll"), new byte[5000]);
+                File.WriteAllText(Path.Combine(directory, "global.json"), "{ \"packages\": \"packages\" }");
+
+                AppBundle.Write(directory);
+
+                long assemblyOffset;
+                using (var bundle = AppBundle.Open(directory))
+                {
+                    assemblyOffset = bundle.Entries.Single().Offset;
+                }
+
+                // In the header, in the index and in the assembly
+                foreach (var length in new[] { 0, 3, 24, assemblyOffset + 1 })
+                {
+                    // Act
+                    using (var stream = new FileStream(bundlePath, FileMode.Open, FileAccess.Write))
+                    {
+                        stream.SetLength(length);
+                    }
+
+                    var truncated = AppBundle.Open(directory);
+
+                    // Assert
+                    Assert.Null(truncated);
+                }
+            }
+        }
+
+        [Fact]
+        public void NoBundleInTheApplicationRoot()
+        {
+            // Arrange
+            using (var tempDirectory = new TempDirectory())
+            {
+                var directory = tempDirectory.Path;
+
+                // Act
+                var bundle = AppBundle.Open(directory);
+
+                // Assert
+                Assert.Null(bundle);
+            }
+        }
+
+        private static byte[] ReadAll(AppBundle bundle, string path)
+        {
+            Stream stream;
+            Assert.True(bundle.TryOpen(path, out stream));
+
+            using (stream)
+            {
+                var memoryStream = new MemoryStream();
+                stream.CopyTo(memoryStream);
+                return memoryStream.ToArray();
+            }
+        }
+    }
+}
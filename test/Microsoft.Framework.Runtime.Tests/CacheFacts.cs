@@ -0,0 +1,233 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+using System;
+using System.Collections.Generic;
+using System.IO;
+using Xunit;
+
+namespace Microsoft.Framework.Runtime.Tests
+{
+    public class CacheFacts
+    {
+        [Fact]
+        public void HitDoesNotPollWatchedDependencies()
+        {
+            // Arrange
+            var watcher = new TestWatcher();
+            var cache = new Cache(new CacheContextAccessor(), watcher);
+            var dependency = new TestCacheDependency();
+            cache.Get("key", ctx => { ctx.Monitor(dependency); return 1; });
+            dependency.Polls = 0;
+
+            // Act
+            cache.Get("key", ctx => 2);
+            var value = cache.Get("key", ctx => 3);
+
+            // Assert
+            Assert.Equal(1, value);
+            Assert.Equal(0, dependency.Polls);
+            Assert.Equal(2, cache.Hits);
+            Assert.Equal(1, cache.Misses);
+        }
+
+        [Fact]
+        public void NotificationInvalidatesEntry()
+        {
+            // Arrange
+            var watcher = new TestWatcher();
+            var cache = new Cache(new CacheContextAccessor(), watcher);
+            var dependency = new TestCacheDependency();
+            cache.Get("key", ctx => { ctx.Monitor(dependency); return 1; });
+
+            // Act
+            watcher.RaiseChanged();
+            var value = cache.Get("key", ctx => 2);
+
+            // Assert
+            Assert.Equal(2, value);
+            Assert.Equal(1, cache.Invalidations);
+            Assert.Equal(2, cache.Misses);
+        }
+
+        [Fact]
+        public void UnwatchedDependenciesArePolled()
+        {
+            // Arrange
+            var cache = new Cache(new CacheContextAccessor());
+            var dependency = new TestCacheDependency();
+            cache.Get("key", ctx => { ctx.Monitor(dependency); return 1; });
+
+            // Act
+            var before = cache.Get("key", ctx => 2);
+            dependency.HasChanged = true;
+            var after = cache.Get("key", ctx => 3);
+
+            // Assert
+            Assert.Equal(1, before);
+            Assert.Equal(3, after);
+            Assert.Equal(1, cache.Invalidations);
+        }
+
+        [Fact]
+        public void FileDependencyDetectsOlderOrResizedFile()
+        {
+            // Arrange
+            var path = Path.GetTempFileName();
+            var writeTime = new DateTime(2014, 10, 1, 0, 0, 0, DateTimeKind.Utc);
+
+            try
+            {
+                File.WriteAllText(path, "abc");
+                File.SetLastWriteTimeUtc(path, writeTime);
+                var older = new FileWriteTimeCacheDependency(path);
+                var resized = new FileWriteTimeCacheDependency(path);
+
+                // Act
+                File.SetLastWriteTimeUtc(path, writeTime.AddDays(-1));
+                var olderChanged = older.HasChanged;
+
+                File.WriteAllText(path, "abcd");
+                File.SetLastWriteTimeUtc(path, writeTime);
+                var resizedChanged = resized.HasChanged;
+
+                // Assert
+                Assert.True(olderChanged);
+                Assert.True(resizedChanged);
+            }
+            finally
+            {
+                File.Delete(path);
+            }
+        }
+
+        [Fact]
+        public void DependenciesPropagateToParentEntry()
+        {
+            // Arrange
+            var watcher = new TestWatcher();
+            var cache = new Cache(new CacheContextAccessor(), watcher);
+            var dependency = new TestCacheDependency();
+            Func<CacheContext, object> child = ctx => { ctx.Monitor(dependency); return 1; };
+            cache.Get("parent", ctx => (int)cache.Get("child", child) + 10);
+
+            // Act
+            watcher.RaiseChanged();
+            var value = cache.Get("parent", ctx => 20);
+
+            // Assert
+            Assert.Equal(20, value);
+        }
+
+        [Fact]
+        public void FlushExpiresEntryBeforeTheWatcherEventArrives()
+        {
+            // Arrange
+            using (var tempDirectory = new TempDirectory())
+            {
+                var directory = tempDirectory.Path;
+                var path = Path.Combine(directory, "file.txt");
+                File.WriteAllText(path, "abc");
+
+                using (var watcher = new FileCacheDependencyWatcher())
+                {
+                    var cache = new Cache(new CacheContextAccessor(), watcher);
+                    cache.Get("key", ctx => { ctx.Monitor(new FileWriteTimeCacheDependency(path)); return 1; });
+
+                    // Act
+                    File.WriteAllText(path, "abcd");
+                    watcher.Flush();
+                    var value = cache.Get("key", ctx => 2);
+
+                    // Assert
+                    Assert.Equal(2, value);
+                }
+            }
+        }
+
+        [Fact]
+        public void FilesPastTheMaximumWatchersArePolled()
+        {
+            // Arrange
+            using (var tempDirectory = new TempDirectory())
+            {
+                var directory = tempDirectory.Path;
+                var projectFile = Path.Combine(directory, "app", Project.ProjectFileName);
+                var sourceFile = Path.Combine(directory, "app", "src", "Program.cs");
+                var otherFile = Path.Combine(directory, "other", "file.txt");
+                Directory.CreateDirectory(Path.GetDirectoryName(sourceFile));
+                Directory.CreateDirectory(Path.GetDirectoryName(otherFile));
+                File.WriteAllText(projectFile, "{ }");
+                File.WriteAllText(sourceFile, "class Program { }");
+                File.WriteAllText(otherFile, "abc");
+
+                using (var watcher = new FileCacheDependencyWatcher(maxWatchers: 1))
+                {
+                    // Act
+                    var projectRegistration = watcher.Watch(new FileWriteTimeCacheDependency(projectFile), () => { });
+                    var sourceRegistration = watcher.Watch(new FileWriteTimeCacheDependency(sourceFile), () => { });
+                    var otherRegistration = watcher.Watch(new FileWriteTimeCacheDependency(otherFile), () => { });
+
+                    // Assert
+                    Assert.NotNull(projectRegistration);
+
+                    // Shares the watcher of its project
+                    Assert.NotNull(sourceRegistration);
+                    Assert.Null(otherRegistration);
+                }
+            }
+        }
+
+        private class TestCacheDependency : ICacheDependency
+        {
+            private bool _hasChanged;
+
+            public int Polls { get; set; }
+
+            public bool HasChanged
+            {
+                get
+                {
+                    Polls++;
+                    return _hasChanged;
+                }
+                set
+                {
+                    _hasChanged = value;
+                }
+            }
+        }
+
+        private class TestWatcher : ICacheDependencyWatcher
+        {
+            private readonly List<Action> _callbacks = new List<Action>();
+
+            public IDisposable Watch(ICacheDependency dependency, Action onChanged)
+            {
+                _callbacks.Add(onChanged);
+                return new Registration();
+            }
+
+            public void Flush()
+            {
+            }
+
+            public void RaiseChanged()
+            {
+                foreach (var callback in _callbacks)
+                {
+                    callback();
+                }
+
+                _callbacks.Clear();
+            }
+
+            private class Registration : IDisposable
+            {
+                public void Dispose()
+                {
+                }
+            }
+        }
+    }
+}
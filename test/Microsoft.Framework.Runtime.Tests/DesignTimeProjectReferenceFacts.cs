@@ -0,0 +1,98 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+using System;
+using System.IO;
+using System.Reflection;
+using System.Security.Cryptography;
+using Xunit;
+
+namespace Microsoft.Framework.Runtime.Tests
+{
+    public class DesignTimeProjectReferenceFacts
+    {
+        [Fact]
+        public void SharedAssemblyMatchingTheHashIsLoaded()
+        {
+            // Arrange
+            using (var tempDirectory = new TempDirectory())
+            {
+                var assemblyPath = Path.Combine(tempDirectory.Path, "App.dll");
+                File.WriteAllBytes(assemblyPath, new byte[] { 1, 2, 3 });
+                File.WriteAllBytes(Path.ChangeExtension(assemblyPath, ".pdb"), new byte[] { 4 });
+                var reference = CreateReference(assemblyPath, ComputeHash(new byte[] { 1, 2, 3, 4 }));
+                var engine = new RecordingLoaderEngine();
+
+                // Act
+                reference.Load(engine);
+
+                // Assert
+                Assert.Equal(new byte[] { 1, 2, 3 }, engine.AssemblyBytes);
+                Assert.Equal(new byte[] { 4 }, engine.PdbBytes);
+            }
+        }
+
+        [Fact]
+        public void SharedAssemblyChangedOnDiskIsNotLoaded()
+        {
+            // Arrange
+            using (var tempDirectory = new TempDirectory())
+            {
+                var assemblyPath = Path.Combine(tempDirectory.Path, "App.dll");
+                File.WriteAllBytes(assemblyPath, new byte[] { 1, 2, 3 });
+                var reference = CreateReference(assemblyPath, ComputeHash(new byte[] { 1, 2, 3 }));
+                File.WriteAllBytes(assemblyPath, new byte[] { 6, 6, 6 });
+                var engine = new RecordingLoaderEngine();
+
+                // Act & Assert
+                Assert.Throws<InvalidOperationException>(() => reference.Load(engine));
+                Assert.Null(engine.AssemblyBytes);
+            }
+        }
+
+        private static DesignTimeProjectReference CreateReference(string assemblyPath, string hash)
+        {
+            return new DesignTimeProjectReference(project: null, response: new CompileResponse
+            {
+                Errors = new string[0],
+                Warnings = new string[0],
+                AssemblyPath = assemblyPath,
+                AssemblyHash = hash
+            });
+        }
+
+        private static string ComputeHash(byte[] bytes)
+        {
+            using (var sha = SHA256.Create())
+            {
+                return BitConverter.ToString(sha.ComputeHash(bytes)).Replace("-", string.Empty).ToLowerInvariant();
+            }
+        }
+
+        private class RecordingLoaderEngine : IAssemblyLoaderEngine
+        {
+            public byte[] AssemblyBytes { get; private set; }
+
+            public byte[] PdbBytes { get; private set; }
+
+            public Assembly LoadFile(string path)
+            {
+                throw new NotSupportedException();
+            }
+
+            public Assembly LoadStream(Stream assemblyStream, Stream pdbStream)
+            {
+                AssemblyBytes = ReadAll(assemblyStream);
+                PdbBytes = pdbStream == null ? null : ReadAll(pdbStream);
+                return null;
+            }
+
+            private static byte[] ReadAll(Stream stream)
+            {
+                var memoryStream = new MemoryStream();
+                stream.CopyTo(memoryStream);
+                return memoryStream.ToArray();
+            }
+        }
+    }
+}
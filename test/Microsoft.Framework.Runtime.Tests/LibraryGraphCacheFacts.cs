@@ -0,0 +1,112 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+using System;
+using System.Collections.Generic;
+using System.Runtime.Versioning;
+using Xunit;
+
+namespace Microsoft.Framework.Runtime.Tests
+{
+    public class LibraryGraphCacheFacts
+    {
+        [Fact]
+        public void AcquireReturnsSharedGraphForSameKey()
+        {
+            // Arrange
+            var cache = new LibraryGraphCache();
+            var walks = 0;
+            Func<LibraryGraphKey, LibraryGraph> factory = key =>
+            {
+                walks++;
+                return CreateGraph(key);
+            };
+
+            // Act
+            var first = cache.Acquire(CreateKey("8a5c"), factory);
+            var second = cache.Acquire(CreateKey("8a5c"), factory);
+
+            // Assert
+            Assert.Same(first, second);
+            Assert.Equal(1, walks);
+        }
+
+        [Fact]
+        public void AcquireWalksAgainWhenProjectChanges()
+        {
+            // Arrange
+            var cache = new LibraryGraphCache();
+
+            // Act
+            var first = cache.Acquire(CreateKey("8a5c"), CreateGraph);
+            var second = cache.Acquire(CreateKey("f31e"), CreateGraph);
+
+            // Assert
+            Assert.NotSame(first, second);
+        }
+
+        [Fact]
+        public void AcquireWalksAgainWhenDependencyChanges()
+        {
+            // Arrange
+            var cache = new LibraryGraphCache();
+            var dependency = new TestCacheDependency();
+            var first = cache.Acquire(CreateKey("8a5c"), key => CreateGraph(key, dependency));
+
+            // Act
+            dependency.HasChanged = true;
+            var second = cache.Acquire(CreateKey("8a5c"), CreateGraph);
+
+            // Assert
+            Assert.NotSame(first, second);
+        }
+
+        [Fact]
+        public void GraphIsDroppedWhenLastReferenceIsReleased()
+        {
+            // Arrange
+            var cache = new LibraryGraphCache();
+            var first = cache.Acquire(CreateKey("8a5c"), CreateGraph);
+            var second = cache.Acquire(CreateKey("8a5c"), CreateGraph);
+
+            // Act
+            cache.Release(first);
+            var stillShared = cache.Acquire(CreateKey("8a5c"), CreateGraph);
+            cache.Release(second);
+            cache.Release(stillShared);
+            var recreated = cache.Acquire(CreateKey("8a5c"), CreateGraph);
+
+            // Assert
+            Assert.Same(first, stillShared);
+            Assert.NotSame(first, recreated);
+        }
+
+        private static LibraryGraphKey CreateKey(string projectHash)
+        {
+            return new LibraryGraphKey(@"c:\app\project.json",
+                                       projectHash,
+                                       new FrameworkName("Net45", new Version(4, 5)),
+                                       "Debug");
+        }
+
+        private static LibraryGraph CreateGraph(LibraryGraphKey key)
+        {
+            return CreateGraph(key, new TestCacheDependency());
+        }
+
+        private static LibraryGraph CreateGraph(LibraryGraphKey key, ICacheDependency dependency)
+        {
+            var nodes = new List<LibraryGraphNode>
+            {
+                new LibraryGraphNode(new Library { Name = "App" }, 0, new List<Library>())
+            };
+
+            return new LibraryGraph(key, nodes, new[] { dependency });
+        }
+
+        private class TestCacheDependency : ICacheDependency
+        {
+            public bool HasChanged { get; set; }
+        }
+    }
+}
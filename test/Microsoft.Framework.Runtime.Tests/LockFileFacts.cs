@@ -0,0 +1,94 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+using System;
+using System.IO;
+using System.Runtime.Versioning;
+using NuGet;
+using Xunit;
+
+namespace Microsoft.Framework.Runtime.Tests
+{
+    public class LockFileFacts
+    {
+        [Fact]
+        public void LockFileRoundTrips()
+        {
+            // Arrange
+            using (var tempDirectory = new TempDirectory())
+            {
+                var directory = tempDirectory.Path;
+                var lockFile = new LockFile();
+                var target = new LockFileTarget
+                {
+                    TargetFramework = new FrameworkName("Asp.Net", new Version(5, 0)),
+                    Hash = 0x0123456789ABCDEF
+                };
+                target.InputPaths.Add(Path.Combine(directory, "project.json"));
+
+                var library = new LockFileLibrary
+                {
+                    Identity = new Library { Name = "Newtonsoft.Json", Version = SemanticVersion.Parse("6.0.4") },
+                    ProviderIndex = 3,
+                    Type = "Package",
+                    Path = Path.Combine(directory, "Newtonsoft.Json", "6.0.4")
+                };
+                library.Dependencies.Add(new Library { Name = "System.Xml" });
+                library.Dependencies.Add(new Library { Name = "Other", Version = SemanticVersion.Parse("1.0.0-*") });
+                target.Libraries.Add(library);
+                target.PackageAssemblies.Add(new LockFileAssembly
+                {
+                    Name = "Newtonsoft.Json",
+                    Path = Path.Combine(library.Path, "lib", "net45", "Newtonsoft.Json.dll"),
+                    LibraryName = "Newtonsoft.Json"
+                });
+                lockFile.Targets.Add(target);
+
+                // Act
+                lockFile.Write(directory);
+                LockFile read;
+                var success = LockFile.TryReadLockFile(directory, out read);
+
+                // Assert
+                Assert.True(success);
+                var readTarget = read.GetTarget(new FrameworkName("Asp.Net", new Version(5, 0)));
+                Assert.NotNull(readTarget);
+                Assert.Equal(target.Hash, readTarget.Hash);
+                Assert.Equal(target.InputPaths, readTarget.InputPaths);
+
+                Assert.Equal(1, readTarget.Libraries.Count);
+                var readLibrary = readTarget.Libraries[0];
+                Assert.Equal(library.Identity, readLibrary.Identity);
+                Assert.Equal(3, readLibrary.ProviderIndex);
+                Assert.Equal("Package", readLibrary.Type);
+                Assert.Equal(library.Path, readLibrary.Path);
+                Assert.Equal(library.Dependencies, readLibrary.Dependencies);
+                Assert.True(readLibrary.Dependencies[1].Version.IsSnapshot);
+
+                Assert.Equal(1, readTarget.PackageAssemblies.Count);
+                var readAssembly = readTarget.PackageAssemblies[0];
+                Assert.Equal("Newtonsoft.Json", readAssembly.Name);
+                Assert.Equal(target.PackageAssemblies[0].Path, readAssembly.Path);
+            }
+        }
+
+        [Fact]
+        public void CorruptLockFileIsIgnored()
+        {
+            // Arrange
+            using (var tempDirectory = new TempDirectory())
+            {
+                var directory = tempDirectory.Path;
+                File.WriteAllBytes(Path.Combine(directory, LockFile.FileName), new byte[] { 1, 2, 3 });
+
+                // Act
+                LockFile read;
+                var success = LockFile.TryReadLockFile(directory, out read);
+
+                // Assert
+                Assert.False(success);
+                Assert.Null(read);
+            }
+        }
+    }
+}
@@ -0,0 +1,103 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+using System;
+using System.IO;
+using System.Linq;
+using System.Runtime.Versioning;
+using NuGet;
+using Xunit;
+
+namespace Microsoft.Framework.Runtime.Tests
+{
+    public class PackageMetadataIndexFacts
+    {
+        private const string Nuspec = @"<?xml version=""1.0""?>
+<package xmlns=""http://schemas.microsoft.com/packaging/2011/08/nuspec.xsd"">
+  <metadata>
+    <id>Alpha</id>
+    <version>1.0.0-beta</version>
+    <authors>Someone</authors>
+    <description>Alpha package</description>
+    <dependencies>
+      <group targetFramework=""net45"">
+        <dependency id=""Beta"" version=""[1.0, 2.0)"" />
+      </group>
+    </dependencies>
+    <frameworkAssemblies>
+      <frameworkAssembly assemblyName=""System.Xml"" targetFramework=""net45"" />
+    </frameworkAssemblies>
+  </metadata>
+</package>";
+
+        [Fact]
+        public void IndexedPackageMatchesNuspec()
+        {
+            // Arrange
+            using (var tempDirectory = new TempDirectory())
+            {
+                var root = tempDirectory.Path;
+                CreatePackagesFolder(root);
+                var repositoryRoot = new PhysicalFileSystem(root);
+                var versionDir = Path.Combine("Alpha", "1.0.0-beta");
+                var nuspecPath = Path.Combine(versionDir, "Alpha.nuspec");
+
+                // Act
+                PackageMetadataIndex.Update(root);
+                var index = PackageMetadataIndex.Open(root);
+                var indexed = index.GetPackage(repositoryRoot, versionDir, nuspecPath);
+                var unzipped = new UnzippedPackage(repositoryRoot, nuspecPath);
+
+                // Assert
+                Assert.Equal(1, index.Count);
+                Assert.NotNull(indexed);
+                Assert.Equal(unzipped.Id, indexed.Id);
+                Assert.Equal(unzipped.Version, indexed.Version);
+
+                var dependencySet = indexed.DependencySets.First();
+                Assert.Equal(new FrameworkName(".NETFramework", new Version(4, 5)), dependencySet.TargetFramework);
+                Assert.Equal("Beta", dependencySet.Dependencies.First().Id);
+                Assert.Equal(unzipped.DependencySets.First().Dependencies.First().VersionSpec.ToString(),
+                             dependencySet.Dependencies.First().VersionSpec.ToString());
+
+                Assert.Equal("System.Xml", indexed.FrameworkAssemblies.First().AssemblyName);
+                Assert.Equal(unzipped.AssemblyReferences.Select(r => r.Path), indexed.AssemblyReferences.Select(r => r.Path));
+                Assert.Equal("Alpha package", indexed.Description);
+            }
+        }
+
+        [Fact]
+        public void ChangedNuspecIsNotServedFromIndex()
+        {
+            // Arrange
+            using (var tempDirectory = new TempDirectory())
+            {
+                var root = tempDirectory.Path;
+                CreatePackagesFolder(root);
+                var repositoryRoot = new PhysicalFileSystem(root);
+                var versionDir = Path.Combine("Alpha", "1.0.0-beta");
+                var nuspecPath = Path.Combine(versionDir, "Alpha.nuspec");
+
+                PackageMetadataIndex.Update(root);
+                File.SetLastWriteTimeUtc(repositoryRoot.GetFullPath(nuspecPath), DateTime.UtcNow.AddMinutes(1));
+
+                // Act
+                var index = PackageMetadataIndex.Open(root);
+                var indexed = index.GetPackage(repositoryRoot, versionDir, nuspecPath);
+
+                // Assert
+                Assert.Null(indexed);
+            }
+        }
+
+        private static void CreatePackagesFolder(string root)
+        {
+            var packageDirectory = Path.Combine(root, "Alpha", "1.0.0-beta");
+            var libDirectory = Path.Combine(packageDirectory, "lib", "net45");
+
+            Directory.CreateDirectory(libDirectory);
+            File.WriteAllText(Path.Combine(packageDirectory, "Alpha.nuspec"), Nuspec);
+            File.WriteAllBytes(Path.Combine(libDirectory, "Alpha.dll"), new byte[0]);
+        }
+    }
+}
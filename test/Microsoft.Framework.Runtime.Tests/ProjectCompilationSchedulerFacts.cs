@@ -0,0 +1,173 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.Linq;
+using System.Runtime.Versioning;
+using System.Threading;
+using System.Threading.Tasks;
+using Xunit;
+
+namespace Microsoft.Framework.Runtime.Tests
+{
+    public class ProjectCompilationSchedulerFacts
+    {
+        [Fact]
+        public void DependenciesAreExportedBeforeTheProjectsUsingThem()
+        {
+            // Arrange
+            var libraries = new[]
+            {
+                new TestLibrary("MyApp", "Project", "Mvc", "Hosting", "HttpAbstractions"),
+                new TestLibrary("Mvc", "Project", "Mvc.Core", "Mvc.Rendering", "DI"),
+                new TestLibrary("Mvc.Rendering", "Project", "Mvc.Core", "HttpAbstractions"),
+                new TestLibrary("Mvc.Core", "Project", "DI", "HttpAbstractions"),
+                new TestLibrary("Hosting", "Project", "DI"),
+                new TestLibrary("DI", "Project", "Newtonsoft.Json"),
+                new TestLibrary("HttpAbstractions", "Project"),
+                new TestLibrary("Newtonsoft.Json", "Package")
+            };
+            var manager = CreateManager(libraries);
+            var exportProvider = new RecordingExportProvider(libraries);
+
+            // Act
+            ProjectCompilationScheduler.CompileDependencies(manager, exportProvider, CreateKey("MyApp"), maxWorkers: 4, throttle: new SemaphoreSlim(4));
+
+            // Assert
+            Assert.Equal(new[] { "DI", "Hosting", "HttpAbstractions", "Mvc", "Mvc.Core", "Mvc.Rendering" },
+                         exportProvider.Exported.Keys.OrderBy(name => name));
+            Assert.Equal(0, exportProvider.OutOfOrder);
+        }
+
+        [Fact]
+        public void NothingIsScheduledWithASingleWorker()
+        {
+            // Arrange
+            var libraries = new[]
+            {
+                new TestLibrary("MyApp", "Project", "A", "B"),
+                new TestLibrary("A", "Project"),
+                new TestLibrary("B", "Project")
+            };
+            var exportProvider = new RecordingExportProvider(libraries);
+
+            // Act
+            ProjectCompilationScheduler.CompileDependencies(CreateManager(libraries), exportProvider, CreateKey("MyApp"), maxWorkers: 1, throttle: new SemaphoreSlim(1));
+
+            // Assert
+            Assert.Equal(0, exportProvider.Exported.Count);
+        }
+
+        [Fact]
+        public void ConcurrentCallsShareTheThrottle()
+        {
+            // Arrange
+            var libraries = new[]
+            {
+                new TestLibrary("AppA", "Project", "A1", "A2", "A3"),
+                new TestLibrary("A1", "Project"),
+                new TestLibrary("A2", "Project"),
+                new TestLibrary("A3", "Project"),
+                new TestLibrary("AppB", "Project", "B1", "B2", "B3"),
+                new TestLibrary("B1", "Project"),
+                new TestLibrary("B2", "Project"),
+                new TestLibrary("B3", "Project")
+            };
+            var manager = CreateManager(libraries);
+            var exportProvider = new RecordingExportProvider(libraries);
+            var throttle = new SemaphoreSlim(2);
+
+            // Act
+            var first = Task.Run(() => ProjectCompilationScheduler.CompileDependencies(manager, exportProvider, CreateKey("AppA"), maxWorkers: 2, throttle: throttle));
+            var second = Task.Run(() => ProjectCompilationScheduler.CompileDependencies(manager, exportProvider, CreateKey("AppB"), maxWorkers: 2, throttle: throttle));
+            Task.WaitAll(first, second);
+
+            // Assert
+            Assert.Equal(6, exportProvider.Exported.Count);
+            Assert.InRange(exportProvider.MaxConcurrent, 1, 2);
+        }
+
+        private static LibraryManager CreateManager(IEnumerable<ILibraryInformation> libraries)
+        {
+            return new LibraryManager(new FrameworkName("Net45", new Version(4, 5, 1)),
+                                      "Debug",
+                                      () => libraries,
+                                      new CompositeLibraryExportProvider(Enumerable.Empty<ILibraryExportProvider>()),
+                                      cache: null);
+        }
+
+        private static ILibraryKey CreateKey(string name)
+        {
+            return new LibraryKey
+            {
+                Name = name,
+                TargetFramework = new FrameworkName("Net45", new Version(4, 5, 1)),
+                Configuration = "Debug"
+            };
+        }
+
+        private class TestLibrary : ILibraryInformation
+        {
+            public TestLibrary(string name, string type, params string[] dependencies)
+            {
+                Name = name;
+                Type = type;
+                Dependencies = dependencies;
+            }
+
+            public string Name { get; private set; }
+
+            public string Path { get; private set; }
+
+            public string Type { get; private set; }
+
+            public IEnumerable<string> Dependencies { get; private set; }
+        }
+
+        private class RecordingExportProvider : ILibraryExportProvider
+        {
+            private readonly Dictionary<string, TestLibrary> _libraries;
+            private int _outOfOrder;
+            private int _concurrent;
+            private int _maxConcurrent;
+
+            public RecordingExportProvider(IEnumerable<TestLibrary> libraries)
+            {
+                _libraries = libraries.ToDictionary(library => library.Name);
+                Exported = new ConcurrentDictionary<string, bool>();
+            }
+
+            public ConcurrentDictionary<string, bool> Exported { get; private set; }
+
+            public int OutOfOrder { get { return _outOfOrder; } }
+
+            public int MaxConcurrent { get { return _maxConcurrent; } }
+
+            public ILibraryExport GetLibraryExport(ILibraryKey target)
+            {
+                foreach (var dependency in _libraries[target.Name].Dependencies)
+                {
+                    if (_libraries[dependency].Type == "Project" && !Exported.ContainsKey(dependency))
+                    {
+                        Interlocked.Increment(ref _outOfOrder);
+                    }
+                }
+
+                var concurrent = Interlocked.Increment(ref _concurrent);
+                int max;
+                while (concurrent > (max = _maxConcurrent) &&
+                       Interlocked.CompareExchange(ref _maxConcurrent, concurrent, max) != max)
+                {
+                }
+
+                Thread.Sleep(10);
+                Exported[target.Name] = true;
+                Interlocked.Decrement(ref _concurrent);
+
+                return new LibraryExport(new List<IMetadataReference>(), new List<ISourceReference>());
+            }
+        }
+    }
+}
@@ -0,0 +1,229 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+using System;
+using System.Collections.Generic;
+using System.Text;
+using System.Text.RegularExpressions;
+using NuGet;
+using Xunit;
+
+namespace Microsoft.Framework.Runtime.Tests
+{
+    public class SemanticVersionFacts
+    {
+        private static readonly string[] Tokens =
+        {
+            "0", "1", "2", "10", "007", "65536", "2147483647", "2147483648", "99999999999",
+            ".", ".", ".", " ", "\t", "-", "-", "a", "B", "rc", "beta", "Beta", "alpha-1", "*", "-*", "_", "+", "é", " ", "١"
+        };
+
+        [Fact]
+        public void ParseMatchesRegexImplementation()
+        {
+            // Arrange
+            var random = new Random(1234);
+
+            for (int i = 0; i < 20000; i++)
+            {
+                var value = i % 2 == 0 ? RandomString(random) : RandomVersion(random);
+
+                // Act
+                SemanticVersion loose;
+                SemanticVersion strict;
+                var looseResult = SemanticVersion.TryParse(value, out loose);
+                var strictResult = SemanticVersion.TryParseStrict(value, out strict);
+
+                // Assert
+                AssertSameParse(ReferenceVersion.TryParse(value, strict: false), looseResult, loose, value);
+                AssertSameParse(ReferenceVersion.TryParse(value, strict: true), strictResult, strict, value);
+            }
+        }
+
+        [Fact]
+        public void CompareMatchesRegexImplementation()
+        {
+            // Arrange
+            var random = new Random(4321);
+            var versions = new List<KeyValuePair<SemanticVersion, ReferenceVersion>>();
+            while (versions.Count < 400)
+            {
+                var value = RandomVersion(random);
+                SemanticVersion version;
+                if (SemanticVersion.TryParse(value, out version))
+                {
+                    versions.Add(new KeyValuePair<SemanticVersion, ReferenceVersion>(version, ReferenceVersion.TryParse(value, strict: false)));
+                }
+            }
+
+            foreach (var x in versions)
+            {
+                foreach (var y in versions)
+                {
+                    // Act
+                    var compare = Math.Sign(x.Key.CompareTo(y.Key));
+                    var equals = x.Key.Equals(y.Key);
+
+                    // Assert
+                    Assert.Equal(Math.Sign(x.Value.CompareTo(y.Value)), compare);
+                    Assert.Equal(x.Value.Equals(y.Value), equals);
+                    if (equals)
+                    {
+                        Assert.Equal(x.Key.GetHashCode(), y.Key.GetHashCode());
+                    }
+                }
+            }
+        }
+
+        [Fact]
+        public void VersionConstructorsNormalizeComponents()
+        {
+            // Act
+            var version = new SemanticVersion(new Version(1, 2), "Beta");
+
+            // Assert
+            Assert.Equal(new Version(1, 2, 0, 0), version.Version);
+            Assert.Equal("Beta", version.SpecialVersion);
+            Assert.Equal("1.2-Beta", version.ToString());
+            Assert.Equal(SemanticVersion.Parse("1.2.0.0-beta"), version);
+        }
+
+        private static void AssertSameParse(ReferenceVersion expected, bool result, SemanticVersion actual, string value)
+        {
+            Assert.True(expected != null == result, "TryParse(\"" + value + "\")");
+            if (expected == null)
+            {
+                return;
+            }
+
+            Assert.Equal(expected.Version, actual.Version);
+            Assert.Equal(expected.SpecialVersion, actual.SpecialVersion);
+            Assert.Equal(expected.IsSnapshot, actual.IsSnapshot);
+            Assert.Equal(expected.OriginalString, actual.ToString());
+        }
+
+        private static string RandomString(Random random)
+        {
+            var builder = new StringBuilder();
+            var length = random.Next(1, 8);
+            for (int i = 0; i < length; i++)
+            {
+                builder.Append(Tokens[random.Next(Tokens.Length)]);
+            }
+            return builder.ToString();
+        }
+
+        private static string RandomVersion(Random random)
+        {
+            var builder = new StringBuilder();
+            var components = random.Next(1, 6);
+            for (int i = 0; i < components; i++)
+            {
+                if (i > 0)
+                {
+                    builder.Append(random.Next(8) == 0 ? " . " : ".");
+                }
+                builder.Append(random.Next(4));
+            }
+
+            switch (random.Next(5))
+            {
+                case 0:
+                    builder.Append("-beta");
+                    break;
+                case 1:
+                    builder.Append("-Beta" + random.Next(3));
+                    break;
+                case 2:
+                    builder.Append("-rc-" + random.Next(3));
+                    break;
+            }
+
+            if (random.Next(6) == 0)
+            {
+                builder.Append("-*");
+            }
+            return builder.ToString();
+        }
+
+        /// <summary>
+        /// The regex based parsing and comparison SemanticVersion used before it packed its components.
+        /// </summary>
+        private class ReferenceVersion
+        {
+            private const RegexOptions Flags = RegexOptions.IgnoreCase | RegexOptions.ExplicitCapture;
+            private static readonly Regex Loose = new Regex(@"^(?<Version>\d+(\s*\.\s*\d+){0,3})(?<Release>-[a-z][0-9a-z-]*)?$", Flags);
+            private static readonly Regex Strict = new Regex(@"^(?<Version>\d+(\.\d+){2})(?<Release>-[a-z][0-9a-z-]*)?$", Flags);
+
+            public Version Version { get; private set; }
+
+            public string SpecialVersion { get; private set; }
+
+            public bool IsSnapshot { get; private set; }
+
+            public string OriginalString { get; private set; }
+
+            public static ReferenceVersion TryParse(string version, bool strict)
+            {
+                if (String.IsNullOrEmpty(version))
+                {
+                    return null;
+                }
+
+                var isSnapshot = false;
+                if (version.Trim().EndsWith("-*"))
+                {
+                    isSnapshot = true;
+                    version = version.Substring(0, version.Length - 2);
+                }
+
+                var match = (strict ? Strict : Loose).Match(version.Trim());
+                Version versionValue;
+                if (!match.Success || !Version.TryParse(match.Groups["Version"].Value, out versionValue))
+                {
+                    return null;
+                }
+
+                return new ReferenceVersion
+                {
+                    Version = new Version(versionValue.Major, versionValue.Minor, Math.Max(versionValue.Build, 0), Math.Max(versionValue.Revision, 0)),
+                    SpecialVersion = match.Groups["Release"].Value.TrimStart('-'),
+                    IsSnapshot = isSnapshot,
+                    OriginalString = version.Replace(" ", "")
+                };
+            }
+
+            public int CompareTo(ReferenceVersion other)
+            {
+                int result = Version.CompareTo(other.Version);
+                if (result != 0)
+                {
+                    return result;
+                }
+
+                bool empty = String.IsNullOrEmpty(SpecialVersion);
+                bool otherEmpty = String.IsNullOrEmpty(other.SpecialVersion);
+                if (empty && otherEmpty)
+                {
+                    return 0;
+                }
+                else if (empty)
+                {
+                    return 1;
+                }
+                else if (otherEmpty)
+                {
+                    return -1;
+                }
+                return StringComparer.OrdinalIgnoreCase.Compare(SpecialVersion, other.SpecialVersion);
+            }
+
+            public bool Equals(ReferenceVersion other)
+            {
+                return Version.Equals(other.Version) &&
+                       SpecialVersion.Equals(other.SpecialVersion, StringComparison.OrdinalIgnoreCase) &&
+                       IsSnapshot == other.IsSnapshot;
+            }
+        }
+    }
+}
@@ -1,4 +1,7 @@
 ﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Runtime.Versioning;
 using NuGet;
 using Xunit;
 
@@ -20,5 +23,64 @@ public void FrameworksAreCompatible(string targetFramework1, string targetFramew
 
             Assert.Equal(compatible, result);
         }
+
+        [Theory]
+        [InlineData("net45", "net45")]
+        [InlineData("net451", "net45")]
+        [InlineData("net40", "net40")]
+        [InlineData("aspnet50", "aspnet50")]
+        [InlineData("aspnetcore50", "any")]
+        public void BestCompatibleItemsAreSelected(string projectFramework, string expectedItem)
+        {
+            // Arrange
+            var items = new[]
+            {
+                new FrameworkTargetable("net40", "net40"),
+                new FrameworkTargetable("net45", "net45"),
+                new FrameworkTargetable("aspnet50", "aspnet50"),
+                new FrameworkTargetable("any"),
+                new FrameworkTargetable("net45-duplicate", "net45")
+            };
+
+            // Act
+            IEnumerable<FrameworkTargetable> compatibleItems;
+            var result = VersionUtility.TryGetCompatibleItems(VersionUtility.ParseFrameworkName(projectFramework), items, out compatibleItems);
+
+            // Assert
+            Assert.True(result);
+            Assert.Equal(expectedItem, compatibleItems.First().Name);
+
+            // The answer is the same once the compatibility scores are cached
+            VersionUtility.TryGetCompatibleItems(VersionUtility.ParseFrameworkName(projectFramework), items, out compatibleItems);
+            Assert.Equal(expectedItem, compatibleItems.First().Name);
+        }
+
+        [Fact]
+        public void NoCompatibleItemsReturnsFalse()
+        {
+            // Arrange
+            var items = new[] { new FrameworkTargetable("net45", "net45") };
+
+            // Act
+            IEnumerable<FrameworkTargetable> compatibleItems;
+            var result = VersionUtility.TryGetCompatibleItems(VersionUtility.ParseFrameworkName("net40"), items, out compatibleItems);
+
+            // Assert
+            Assert.False(result);
+            Assert.Null(compatibleItems);
+        }
+
+        private class FrameworkTargetable : IFrameworkTargetable
+        {
+            public FrameworkTargetable(string name, params string[] frameworks)
+            {
+                Name = name;
+                SupportedFrameworks = frameworks.Select(VersionUtility.ParseFrameworkName).ToList();
+            }
+
+            public string Name { get; private set; }
+
+            public IEnumerable<FrameworkName> SupportedFrameworks { get; private set; }
+        }
     }
 }
\ No newline at end of file
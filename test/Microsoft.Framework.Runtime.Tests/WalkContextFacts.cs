@@ -0,0 +1,402 @@
+// Copyright (c) Microsoft Open Technologies, Inc. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Runtime.Versioning;
+using NuGet;
+using Xunit;
+
+namespace Microsoft.Framework.Runtime.Tests
+{
+    public class WalkContextFacts
+    {
+        private static readonly FrameworkName Net45 = new FrameworkName("Net45", new Version(4, 5));
+
+        [Fact]
+        public void NearestDependencyWins()
+        {
+            // Arrange
+            var provider = new TestDependencyProvider()
+                .Package("a", "1.0", "b 1.0", "c 1.0")
+                .Package("b", "1.0", "c 2.0")
+                .Package("c", "1.0")
+                .Package("c", "2.0");
+
+            // Act
+            var libraries = Walk(provider, "a", "1.0");
+
+            // Assert
+            Assert.Equal(new[] { "a 1.0", "b 1.0", "c 1.0" }, libraries);
+        }
+
+        [Fact]
+        public void CousinConflictsResolveToHighestVersion()
+        {
+            // Arrange
+            var provider = new TestDependencyProvider()
+                .Package("a", "1.0", "b 1.0", "c 1.0")
+                .Package("b", "1.0", "d 1.0")
+                .Package("c", "1.0", "d 2.0")
+                .Package("d", "1.0", "x 1.0")
+                .Package("d", "2.0", "z 1.0")
+                .Package("x", "1.0")
+                .Package("z", "1.0");
+
+            // Act
+            var libraries = Walk(provider, "a", "1.0");
+
+            // Assert
+            Assert.Equal(new[] { "a 1.0", "b 1.0", "c 1.0", "d 2.0", "z 1.0" }, libraries);
+        }
+
+        [Fact]
+        public void CyclesAreEclipsed()
+        {
+            // Arrange
+            var provider = new TestDependencyProvider()
+                .Package("a", "1.0", "b 1.0")
+                .Package("b", "1.0", "A 1.0");
+
+            // Act
+            var libraries = Walk(provider, "a", "1.0");
+
+            // Assert
+            Assert.Equal(new[] { "a 1.0", "b 1.0" }, libraries);
+        }
+
+        [Fact]
+        public void UnresolvedDependenciesAreDropped()
+        {
+            // Arrange
+            var provider = new TestDependencyProvider()
+                .Package("a", "1.0", "b 1.0", "missing 1.0")
+                .Package("b", "1.0");
+
+            // Act
+            var libraries = Walk(provider, "a", "1.0");
+
+            // Assert
+            Assert.Equal(new[] { "a 1.0", "b 1.0" }, libraries);
+        }
+
+        [Fact]
+        public void WalkMatchesTreeImplementation()
+        {
+            // Arrange
+            var random = new Random(2468);
+
+            for (int i = 0; i < 500; i++)
+            {
+                var provider = RandomGraph(random);
+
+                // Act
+                var context = new WalkContext();
+                context.Walk(new[] { provider }, "a", SemanticVersion.Parse("1.0"), Net45);
+                var libraries = context.GetGraphNodes(new IDependencyProvider[] { provider })
+                                       .Select(node => Describe(node.Identity, node.Dependencies))
+                                       .OrderBy(library => library, StringComparer.Ordinal);
+
+                // Assert
+                var expected = ReferenceWalk.Walk(provider, "a", SemanticVersion.Parse("1.0"))
+                                            .OrderBy(library => library, StringComparer.Ordinal);
+                Assert.Equal(expected, libraries);
+            }
+        }
+
+        private static IEnumerable<string> Walk(TestDependencyProvider provider, string name, string version)
+        {
+            var context = new WalkContext();
+            context.Walk(new[] { provider }, name, SemanticVersion.Parse(version), Net45);
+
+            return context.GetGraphNodes(new IDependencyProvider[] { provider })
+                          .Select(node => node.Identity.ToString())
+                          .OrderBy(identity => identity);
+        }
+
+        private static string Describe(Library identity, IEnumerable<Library> dependencies)
+        {
+            return identity + " -> " + string.Join(", ", dependencies);
+        }
+
+        private static TestDependencyProvider RandomGraph(Random random)
+        {
+            // Few names so lines eclipse each other and cycle, several versions of each so cousins conflict,
+            // and some versions that don't exist
+            var names = new[] { "a", "b", "c", "d", "e", "f", "g" };
+            var versions = new[] { "1.0", "2.0", "3.0" };
+            var provider = new TestDependencyProvider();
+
+            foreach (var name in names)
+            {
+                foreach (var version in versions)
+                {
+                    if (name != "a" && random.Next(3) == 0)
+                    {
+                        continue;
+                    }
+
+                    var dependencies = Enumerable.Range(0, random.Next(4)).Select(_ =>
+                    {
+                        var dependency = names[random.Next(names.Length)];
+                        if (random.Next(5) == 0)
+                        {
+                            dependency = dependency.ToUpperInvariant();
+                        }
+                        return dependency + " " + (random.Next(8) == 0 ? "9.0" : versions[random.Next(versions.Length)]);
+                    });
+
+                    provider.Package(name, version, dependencies.ToArray());
+                }
+            }
+
+            return provider;
+        }
+
+        /// <summary>
+        /// The walk WalkContext did before it kept the tree in arrays: a tree of nodes visited breadth-first,
+        /// eclipsing by scanning up the line and across each level's siblings.
+        /// </summary>
+        private static class ReferenceWalk
+        {
+            private enum Disposition
+            {
+                Acceptable,
+                Rejected,
+                Accepted
+            }
+
+            public static IEnumerable<string> Walk(IDependencyProvider provider, string name, SemanticVersion version)
+            {
+                var root = new Node { Key = new Library { Name = name, Version = version } };
+                var resolvedItems = new Dictionary<Library, Item>();
+
+                ForEach(root, true, (node, _) =>
+                {
+                    node.Item = Resolve(resolvedItems, provider, node.Key);
+                    if (node.Item == null)
+                    {
+                        node.Disposition = Disposition.Rejected;
+                        return true;
+                    }
+
+                    foreach (var dependency in node.Item.Dependencies)
+                    {
+                        var eclipsed = false;
+                        for (var scanNode = node; scanNode != null && !eclipsed; scanNode = scanNode.OuterNode)
+                        {
+                            eclipsed |= string.Equals(scanNode.Key.Name, dependency.Name, StringComparison.OrdinalIgnoreCase);
+                            foreach (var sideNode in scanNode.InnerNodes)
+                            {
+                                eclipsed |= string.Equals(sideNode.Key.Name, dependency.Name, StringComparison.OrdinalIgnoreCase);
+                            }
+                        }
+
+                        if (!eclipsed)
+                        {
+                            node.InnerNodes.Add(new Node { OuterNode = node, Key = dependency });
+                        }
+                    }
+                    return true;
+                });
+
+                var patience = 1000;
+                var incomplete = true;
+                while (incomplete && --patience != 0)
+                {
+                    var tracker = new Dictionary<string, Tracked>();
+                    Func<Item, Tracked> track = item =>
+                    {
+                        Tracked tracked;
+                        if (!tracker.TryGetValue(item.Key.Name, out tracked))
+                        {
+                            tracked = new Tracked();
+                            tracker[item.Key.Name] = tracked;
+                        }
+                        return tracked;
+                    };
+
+                    ForEach(root, true, (node, state) =>
+                    {
+                        if (!state || node.Disposition == Disposition.Rejected)
+                        {
+                            return false;
+                        }
+                        var items = track(node.Item).Items;
+                        if (!items.Contains(node.Item))
+                        {
+                            items.Add(node.Item);
+                        }
+                        return true;
+                    });
+
+                    ForEach(root, "Walking", (node, state) =>
+                    {
+                        if (node.Disposition == Disposition.Rejected)
+                        {
+                            return "Rejected";
+                        }
+                        if (state == "Walking" && track(node.Item).Items.Count > 1)
+                        {
+                            return "Ambiguous";
+                        }
+                        if (state == "Ambiguous")
+                        {
+                            track(node.Item).Ambiguous = true;
+                        }
+                        return state;
+                    });
+
+                    ForEach(root, true, (node, state) =>
+                    {
+                        if (!state || node.Disposition == Disposition.Rejected || track(node.Item).Ambiguous)
+                        {
+                            return false;
+                        }
+                        if (node.Disposition == Disposition.Acceptable)
+                        {
+                            var best = track(node.Item).Items.All(known => node.Item.Key.Version >= known.Key.Version);
+                            node.Disposition = best ? Disposition.Accepted : Disposition.Rejected;
+                        }
+                        return node.Disposition == Disposition.Accepted;
+                    });
+
+                    incomplete = false;
+                    ForEach(root, true, (node, _) => incomplete |= node.Disposition == Disposition.Acceptable);
+                }
+
+                var usedItems = new Dictionary<string, Item>();
+                ForEach(root, true, (node, state) =>
+                {
+                    if (!state || node.Disposition != Disposition.Accepted || node.Item == null)
+                    {
+                        return false;
+                    }
+                    if (!usedItems.ContainsKey(node.Item.Key.Name))
+                    {
+                        usedItems[node.Item.Key.Name] = node.Item;
+                    }
+                    return true;
+                });
+
+                return usedItems.Values.Select(item => Describe(item.Key,
+                    item.Dependencies.Where(d => usedItems.ContainsKey(d.Name)).Select(d => usedItems[d.Name].Key)));
+            }
+
+            private static void ForEach<TState>(Node root, TState state, Func<Node, TState, TState> visitor)
+            {
+                var queue = new Queue<Tuple<Node, TState>>();
+                var patience = 10000;
+                queue.Enqueue(Tuple.Create(root, state));
+                while (queue.Count != 0 && --patience != 0)
+                {
+                    var work = queue.Dequeue();
+                    var innerState = visitor(work.Item1, work.Item2);
+                    foreach (var innerNode in work.Item1.InnerNodes)
+                    {
+                        queue.Enqueue(Tuple.Create(innerNode, innerState));
+                    }
+                }
+            }
+
+            private static Item Resolve(Dictionary<Library, Item> resolvedItems, IDependencyProvider provider, Library key)
+            {
+                Item item;
+                if (resolvedItems.TryGetValue(key, out item))
+                {
+                    return item;
+                }
+
+                var description = provider.GetDescription(key.Name, key.Version, Net45);
+                if (description == null)
+                {
+                    resolvedItems[key] = null;
+                    return null;
+                }
+
+                if (!resolvedItems.TryGetValue(description.Identity, out item))
+                {
+                    item = new Item { Key = description.Identity, Dependencies = description.Dependencies };
+                    resolvedItems[description.Identity] = item;
+                }
+                resolvedItems[key] = item;
+                return item;
+            }
+
+            private class Node
+            {
+                public Node()
+                {
+                    InnerNodes = new List<Node>();
+                }
+
+                public Library Key { get; set; }
+                public Item Item { get; set; }
+                public Node OuterNode { get; set; }
+                public List<Node> InnerNodes { get; private set; }
+                public Disposition Disposition { get; set; }
+            }
+
+            private class Item
+            {
+                public Library Key { get; set; }
+                public IEnumerable<Library> Dependencies { get; set; }
+            }
+
+            private class Tracked
+            {
+                public Tracked()
+                {
+                    Items = new List<Item>();
+                }
+
+                public List<Item> Items { get; private set; }
+                public bool Ambiguous { get; set; }
+            }
+        }
+
+        private class TestDependencyProvider : IDependencyProvider
+        {
+            private readonly Dictionary<Library, List<Library>> _packages = new Dictionary<Library, List<Library>>();
+
+            public TestDependencyProvider Package(string name, string version, params string[] dependencies)
+            {
+                _packages[CreateLibrary(name, version)] = dependencies.Select(d => d.Split(' '))
+                                                                      .Select(d => CreateLibrary(d[0], d[1]))
+                                                                      .ToList();
+                return this;
+            }
+
+            public LibraryDescription GetDescription(string name, SemanticVersion version, FrameworkName targetFramework)
+            {
+                var key = _packages.Keys.FirstOrDefault(p => string.Equals(p.Name, name, StringComparison.OrdinalIgnoreCase) &&
+                                                             p.Version == version);
+                if (key == null)
+                {
+                    return null;
+                }
+
+                return new LibraryDescription
+                {
+                    Identity = key,
+                    Dependencies = _packages[key]
+                };
+            }
+
+            public void Initialize(IEnumerable<LibraryDescription> dependencies, FrameworkName targetFramework)
+            {
+            }
+
+            public IEnumerable<string> GetAttemptedPaths(FrameworkName targetFramework)
+            {
+                return Enumerable.Empty<string>();
+            }
+
+            private static Library CreateLibrary(string name, string version)
+            {
+                return new Library { Name = name, Version = SemanticVersion.Parse(version) };
+            }
+        }
+    }
+}